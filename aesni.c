@@ -0,0 +1,641 @@
+/**
+ * @file      aesni.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     AES-NI hardware cipher engine for x86 targets, selected at runtime through CPUID.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *  
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "udbg.h"
+#include "aesni.h"
+
+#ifdef __uAES_AESNI__
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+/**
+ * NOTE: Functions are compiled for AES-NI through the target attribute, so the rest of the
+ *       library keeps the default instruction set and runs on CPUs without it.
+ */
+#define uAES_AESNI_TARGET     __attribute__((target("aes,sse2")))
+#define uAES_AESNI_LANES      8UL
+#define uAES_CPUID_ECX_AES    (1U << 25)
+
+/**
+ * @brief Key schedule round keys are stored as the byte sequence defined in FIPS-197, which
+ *        is the layout expected by the AES instructions.
+ */
+#define uAES_RKEY(kschd, round)   _mm_loadu_si128((const __m128i *)&( kschd )[4 * ( round )])
+
+static volatile int aesni_state = -1;
+
+uAES_AESNI_TARGET static inline __m128i aesni_128_assist(__m128i key, __m128i assist);
+uAES_AESNI_TARGET static inline void    aesni_192_assist(__m128i *lo, __m128i *assist, __m128i *hi);
+uAES_AESNI_TARGET static inline __m128i aesni_256_assist_lo(__m128i lo, __m128i assist);
+uAES_AESNI_TARGET static inline __m128i aesni_256_assist_hi(__m128i lo, __m128i hi);
+uAES_AESNI_TARGET static inline __m128i aesni_encrypt(__m128i block, const uint32_t *kschd, size_t Nr);
+uAES_AESNI_TARGET static inline __m128i aesni_decrypt(__m128i block, const uint32_t *kschd, size_t Nr);
+uAES_AESNI_TARGET static inline __m128i aesni_xts_double(__m128i tweak);
+uAES_AESNI_TARGET static inline void    aesni_xts(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr, uint8_t *tweak, int decrypt);
+
+/**
+ * @brief       Checks, once, whether the CPU supports the AES instruction set.
+ * @return int  [1] if AES-NI is available, [0] otherwise.
+ */
+int aesni_available(void)
+{
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+  if(0 > aesni_state)
+  {
+    if(0 != __get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+      aesni_state = (0 != (ecx & uAES_CPUID_ECX_AES)) ? (1) : (0);
+    }
+    else
+    {
+      aesni_state = 0;
+    }
+  }
+  return aesni_state;
+}
+
+/**
+ * @brief           Computes the next AES-128 round key.
+ * @param key       Previous round key.
+ * @param assist    Output of aeskeygenassist on previous round key.
+ * @return __m128i  Next round key.
+ */
+uAES_AESNI_TARGET static inline __m128i aesni_128_assist(__m128i key, __m128i assist)
+{
+  __m128i tmp;
+
+  assist = _mm_shuffle_epi32(assist, 0xFF);
+  tmp = _mm_slli_si128(key, 4);
+  key = _mm_xor_si128(key, tmp);
+  tmp = _mm_slli_si128(tmp, 4);
+  key = _mm_xor_si128(key, tmp);
+  tmp = _mm_slli_si128(tmp, 4);
+  key = _mm_xor_si128(key, tmp);
+  return _mm_xor_si128(key, assist);
+}
+
+/**
+ * @brief         Computes the next six AES-192 key schedule words.
+ * @param lo      Words [i - 6, i - 3] on input, words [i, i + 3] on output.
+ * @param assist  Output of aeskeygenassist on hi.
+ * @param hi      Words [i - 2, i - 1] on input, words [i + 4, i + 5] on output.
+ */
+uAES_AESNI_TARGET static inline void aesni_192_assist(__m128i *lo, __m128i *assist, __m128i *hi)
+{
+  __m128i tmp;
+
+  *assist = _mm_shuffle_epi32(*assist, 0x55);
+  tmp = _mm_slli_si128(*lo, 4);
+  *lo = _mm_xor_si128(*lo, tmp);
+  tmp = _mm_slli_si128(tmp, 4);
+  *lo = _mm_xor_si128(*lo, tmp);
+  tmp = _mm_slli_si128(tmp, 4);
+  *lo = _mm_xor_si128(*lo, tmp);
+  *lo = _mm_xor_si128(*lo, *assist);
+  *assist = _mm_shuffle_epi32(*lo, 0xFF);
+  tmp = _mm_slli_si128(*hi, 4);
+  *hi = _mm_xor_si128(*hi, tmp);
+  *hi = _mm_xor_si128(*hi, *assist);
+  return;
+}
+
+/**
+ * @brief           Computes the next even AES-256 round key.
+ * @param lo        Round key 2 steps behind.
+ * @param assist    Output of aeskeygenassist on previous round key.
+ * @return __m128i  Next round key.
+ */
+uAES_AESNI_TARGET static inline __m128i aesni_256_assist_lo(__m128i lo, __m128i assist)
+{
+  return aesni_128_assist(lo, assist);
+}
+
+/**
+ * @brief           Computes the next odd AES-256 round key, which only applies SubWord.
+ * @param lo        Previous round key.
+ * @param hi        Round key 2 steps behind.
+ * @return __m128i  Next round key.
+ */
+uAES_AESNI_TARGET static inline __m128i aesni_256_assist_hi(__m128i lo, __m128i hi)
+{
+  __m128i tmp, assist;
+
+  assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(lo, 0x00), 0xAA);
+  tmp = _mm_slli_si128(hi, 4);
+  hi = _mm_xor_si128(hi, tmp);
+  tmp = _mm_slli_si128(tmp, 4);
+  hi = _mm_xor_si128(hi, tmp);
+  tmp = _mm_slli_si128(tmp, 4);
+  hi = _mm_xor_si128(hi, tmp);
+  return _mm_xor_si128(hi, assist);
+}
+
+#define uAES_AESNI_128_STEP(rk, round, rc)  do {                                          \
+  rk = aesni_128_assist(rk, _mm_aeskeygenassist_si128(rk, rc));                           \
+  _mm_storeu_si128((__m128i *)&kschd[4 * ( round )], rk);                                 \
+} while(0)
+
+#define uAES_AESNI_192_STEP(lo, hi, rc)  do {                                             \
+  assist = _mm_aeskeygenassist_si128(hi, rc);                                             \
+  aesni_192_assist(&lo, &assist, &hi);                                                    \
+} while(0)
+
+#define uAES_AESNI_256_STEP(lo, hi, round, rc)  do {                                      \
+  lo = aesni_256_assist_lo(lo, _mm_aeskeygenassist_si128(hi, rc));                        \
+  _mm_storeu_si128((__m128i *)&kschd[4 * ( round )], lo);                                 \
+  hi = aesni_256_assist_hi(lo, hi);                                                       \
+  _mm_storeu_si128((__m128i *)&kschd[4 * ( round + 1 )], hi);                             \
+} while(0)
+
+/**
+ * @brief         Computes the key expansion algorithm with aeskeygenassist, output matches key_expansion.
+ * @param key     Pointer to the first element of the user key array.
+ * @param kschd   Pointer to the first element of key schedule array.
+ * @param Nk      Number of 32-bit words in the user key.
+ */
+uAES_AESNI_TARGET void aesni_key_expansion(uint8_t *key, uint32_t *kschd, size_t Nk)
+{
+  __m128i lo, hi, assist;
+
+  lo = _mm_loadu_si128((const __m128i *)key);
+  _mm_storeu_si128((__m128i *)&kschd[0], lo);
+
+  switch(Nk)
+  {
+    case 4:
+    {
+      uAES_AESNI_128_STEP(lo, 1, 0x01);
+      uAES_AESNI_128_STEP(lo, 2, 0x02);
+      uAES_AESNI_128_STEP(lo, 3, 0x04);
+      uAES_AESNI_128_STEP(lo, 4, 0x08);
+      uAES_AESNI_128_STEP(lo, 5, 0x10);
+      uAES_AESNI_128_STEP(lo, 6, 0x20);
+      uAES_AESNI_128_STEP(lo, 7, 0x40);
+      uAES_AESNI_128_STEP(lo, 8, 0x80);
+      uAES_AESNI_128_STEP(lo, 9, 0x1B);
+      uAES_AESNI_128_STEP(lo, 10, 0x36);
+      break;
+    }
+    case 6:
+    {
+      /* Every step yields 6 words, stored as 64-bit halves so that no word is written twice. */
+      hi = _mm_loadl_epi64((const __m128i *)&key[16]);
+      _mm_storel_epi64((__m128i *)&kschd[4], hi);
+      for(size_t step = 0; step < 8; step++)
+      {
+        switch(step)
+        {
+          case 0: uAES_AESNI_192_STEP(lo, hi, 0x01); break;
+          case 1: uAES_AESNI_192_STEP(lo, hi, 0x02); break;
+          case 2: uAES_AESNI_192_STEP(lo, hi, 0x04); break;
+          case 3: uAES_AESNI_192_STEP(lo, hi, 0x08); break;
+          case 4: uAES_AESNI_192_STEP(lo, hi, 0x10); break;
+          case 5: uAES_AESNI_192_STEP(lo, hi, 0x20); break;
+          case 6: uAES_AESNI_192_STEP(lo, hi, 0x40); break;
+          default: uAES_AESNI_192_STEP(lo, hi, 0x80); break;
+        }
+        _mm_storeu_si128((__m128i *)&kschd[6 * ( step + 1 )], lo);
+        if(7 > step)
+        {
+          _mm_storel_epi64((__m128i *)&kschd[6 * ( step + 1 ) + 4], hi);
+        }
+      }
+      break;
+    }
+    default:
+    {
+      hi = _mm_loadu_si128((const __m128i *)&key[16]);
+      _mm_storeu_si128((__m128i *)&kschd[4], hi);
+      uAES_AESNI_256_STEP(lo, hi, 2, 0x01);
+      uAES_AESNI_256_STEP(lo, hi, 4, 0x02);
+      uAES_AESNI_256_STEP(lo, hi, 6, 0x04);
+      uAES_AESNI_256_STEP(lo, hi, 8, 0x08);
+      uAES_AESNI_256_STEP(lo, hi, 10, 0x10);
+      uAES_AESNI_256_STEP(lo, hi, 12, 0x20);
+      lo = aesni_256_assist_lo(lo, _mm_aeskeygenassist_si128(hi, 0x40));
+      _mm_storeu_si128((__m128i *)&kschd[56], lo);
+      break;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief         Converts an expanded key schedule into the equivalent inverse cipher key
+ *                schedule, applying aesimc to the round keys 1 to Nr - 1.
+ * @param kschd   Pointer to key schedule buffer generated by key expansion algorithm.
+ * @param Nr      Number of rounds.
+ */
+uAES_AESNI_TARGET void aesni_inv_key_schedule(uint32_t *kschd, size_t Nr)
+{
+  for(size_t round = 1; round < Nr; round++)
+  {
+    _mm_storeu_si128((__m128i *)&kschd[4 * round], _mm_aesimc_si128(uAES_RKEY(kschd, round)));
+  }
+  return;
+}
+
+/**
+ * @brief           Computes foward cipher on a single block held in a register.
+ * @param block     Data block.
+ * @param kschd     Pointer to key schedule buffer.
+ * @param Nr        Number of rounds.
+ * @return __m128i  Encrypted block.
+ */
+uAES_AESNI_TARGET static inline __m128i aesni_encrypt(__m128i block, const uint32_t *kschd, size_t Nr)
+{
+  block = _mm_xor_si128(block, uAES_RKEY(kschd, 0));
+  for(size_t round = 1; round < Nr; round++)
+  {
+    block = _mm_aesenc_si128(block, uAES_RKEY(kschd, round));
+  }
+  return _mm_aesenclast_si128(block, uAES_RKEY(kschd, Nr));
+}
+
+/**
+ * @brief           Computes equivalent inverse cipher on a single block held in a register.
+ * @param block     Data block.
+ * @param kschd     Pointer to key schedule buffer converted by aesni_inv_key_schedule().
+ * @param Nr        Number of rounds.
+ * @return __m128i  Decrypted block.
+ */
+uAES_AESNI_TARGET static inline __m128i aesni_decrypt(__m128i block, const uint32_t *kschd, size_t Nr)
+{
+  block = _mm_xor_si128(block, uAES_RKEY(kschd, Nr));
+  for(size_t round = Nr - 1; round > 0; round--)
+  {
+    block = _mm_aesdec_si128(block, uAES_RKEY(kschd, round));
+  }
+  return _mm_aesdeclast_si128(block, uAES_RKEY(kschd, 0));
+}
+
+/**
+ * @brief         Encrypts independent blocks in place, 8 blocks are kept in flight to hide
+ *                the aesenc latency.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to key schedule buffer.
+ * @param Nr      Number of rounds.
+ */
+uAES_AESNI_TARGET void aesni_encrypt_blocks(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr)
+{
+  __m128i x[uAES_AESNI_LANES], rk;
+  __m128i *p_blk = (__m128i *)buf;
+  size_t lane = 0;
+
+  for(; nblocks >= uAES_AESNI_LANES; nblocks -= uAES_AESNI_LANES, p_blk += uAES_AESNI_LANES)
+  {
+    rk = uAES_RKEY(kschd, 0);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      x[lane] = _mm_xor_si128(_mm_loadu_si128(&p_blk[lane]), rk);
+    }
+    for(size_t round = 1; round < Nr; round++)
+    {
+      rk = uAES_RKEY(kschd, round);
+      for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+      {
+        x[lane] = _mm_aesenc_si128(x[lane], rk);
+      }
+    }
+    rk = uAES_RKEY(kschd, Nr);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      _mm_storeu_si128(&p_blk[lane], _mm_aesenclast_si128(x[lane], rk));
+    }
+  }
+
+  for(; nblocks > 0; nblocks--, p_blk++)
+  {
+    _mm_storeu_si128(p_blk, aesni_encrypt(_mm_loadu_si128(p_blk), kschd, Nr));
+  }
+  return;
+}
+
+/**
+ * @brief         Advances up to 8 independent CBC messages by the same number of blocks, each
+ *                one with its own key schedule. The messages are encrypted in lock-step so that
+ *                their serial chains share the aesenc pipeline. All key schedules must have the
+ *                same number of rounds.
+ * @param buf     Position of every message, blocks are encrypted in place.
+ * @param nlanes  Number of messages [1, 8].
+ * @param nblocks Number of 16-byte blocks processed in every message.
+ * @param kschd   Key schedule of every message.
+ * @param Nr      Number of rounds.
+ * @param chain   Chaining value of every message, updated to the last ciphertext block.
+ * @param store   Zero to leave the messages untouched and only carry the chaining values.
+ */
+uAES_AESNI_TARGET static inline void aesni_cbc_lanes(uint8_t *const *buf, size_t nlanes, size_t nblocks, const uint32_t *const *kschd, size_t Nr, uint8_t *chain, int store)
+{
+  __m128i x[uAES_AESNI_LANES];
+  size_t lane = 0, blk = 0;
+
+  for(lane = 0; lane < nlanes; lane++)
+  {
+    x[lane] = _mm_loadu_si128((const __m128i *)&chain[16 * lane]);
+  }
+  for(blk = 0; blk < nblocks; blk++)
+  {
+    for(lane = 0; lane < nlanes; lane++)
+    {
+      x[lane] = _mm_xor_si128(x[lane], _mm_loadu_si128((const __m128i *)&buf[lane][16 * blk]));
+      x[lane] = _mm_xor_si128(x[lane], uAES_RKEY(kschd[lane], 0));
+    }
+    for(size_t round = 1; round < Nr; round++)
+    {
+      for(lane = 0; lane < nlanes; lane++)
+      {
+        x[lane] = _mm_aesenc_si128(x[lane], uAES_RKEY(kschd[lane], round));
+      }
+    }
+    for(lane = 0; lane < nlanes; lane++)
+    {
+      x[lane] = _mm_aesenclast_si128(x[lane], uAES_RKEY(kschd[lane], Nr));
+      if(0 != store)
+      {
+        _mm_storeu_si128((__m128i *)&buf[lane][16 * blk], x[lane]);
+      }
+    }
+  }
+  for(lane = 0; lane < nlanes; lane++)
+  {
+    _mm_storeu_si128((__m128i *)&chain[16 * lane], x[lane]);
+  }
+  return;
+}
+
+/**
+ * @brief See aesni_cbc_lanes(), a full set of lanes is compiled separately so that all of
+ *        them stay in registers.
+ */
+uAES_AESNI_TARGET void aesni_cbc_encrypt_lanes(uint8_t *const *buf, size_t nlanes, size_t nblocks, const uint32_t *const *kschd, size_t Nr, uint8_t *chain)
+{
+  if(uAES_AESNI_LANES == nlanes)
+  {
+    aesni_cbc_lanes(buf, uAES_AESNI_LANES, nblocks, kschd, Nr, chain, 1);
+  }
+  else
+  {
+    aesni_cbc_lanes(buf, nlanes, nblocks, kschd, Nr, chain, 1);
+  }
+  return;
+}
+
+/**
+ * @brief See aesni_cbc_lanes(), the CBC-MAC of every message is accumulated in chain and the
+ *        messages are only read.
+ */
+uAES_AESNI_TARGET void aesni_cbc_mac_lanes(uint8_t *const *buf, size_t nlanes, size_t nblocks, const uint32_t *const *kschd, size_t Nr, uint8_t *chain)
+{
+  if(uAES_AESNI_LANES == nlanes)
+  {
+    aesni_cbc_lanes(buf, uAES_AESNI_LANES, nblocks, kschd, Nr, chain, 0);
+  }
+  else
+  {
+    aesni_cbc_lanes(buf, nlanes, nblocks, kschd, Nr, chain, 0);
+  }
+  return;
+}
+
+/**
+ * @brief         Decrypts independent blocks in place, 8 blocks are kept in flight to hide
+ *                the aesdec latency.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to key schedule buffer converted by aesni_inv_key_schedule().
+ * @param Nr      Number of rounds.
+ */
+uAES_AESNI_TARGET void aesni_decrypt_blocks(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr)
+{
+  __m128i x[uAES_AESNI_LANES], rk;
+  __m128i *p_blk = (__m128i *)buf;
+  size_t lane = 0;
+
+  for(; nblocks >= uAES_AESNI_LANES; nblocks -= uAES_AESNI_LANES, p_blk += uAES_AESNI_LANES)
+  {
+    rk = uAES_RKEY(kschd, Nr);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      x[lane] = _mm_xor_si128(_mm_loadu_si128(&p_blk[lane]), rk);
+    }
+    for(size_t round = Nr - 1; round > 0; round--)
+    {
+      rk = uAES_RKEY(kschd, round);
+      for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+      {
+        x[lane] = _mm_aesdec_si128(x[lane], rk);
+      }
+    }
+    rk = uAES_RKEY(kschd, 0);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      _mm_storeu_si128(&p_blk[lane], _mm_aesdeclast_si128(x[lane], rk));
+    }
+  }
+
+  for(; nblocks > 0; nblocks--, p_blk++)
+  {
+    _mm_storeu_si128(p_blk, aesni_decrypt(_mm_loadu_si128(p_blk), kschd, Nr));
+  }
+  return;
+}
+
+/**
+ * @brief         Computes CBC encryption in place, the chaining value stays in a register.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to key schedule buffer.
+ * @param Nr      Number of rounds.
+ * @param iv      16-Byte initialisation vector.
+ */
+uAES_AESNI_TARGET void aesni_cbc_encrypt(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr, const uint8_t *iv)
+{
+  __m128i *p_blk = (__m128i *)buf;
+  __m128i chain = _mm_loadu_si128((const __m128i *)iv);
+
+  for(; nblocks > 0; nblocks--, p_blk++)
+  {
+    chain = aesni_encrypt(_mm_xor_si128(_mm_loadu_si128(p_blk), chain), kschd, Nr);
+    _mm_storeu_si128(p_blk, chain);
+  }
+  return;
+}
+
+/**
+ * @brief         Computes CBC decryption in place from the first block onwards, 8 blocks are
+ *                kept in flight since each one only depends on ciphertext.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to key schedule buffer converted by aesni_inv_key_schedule().
+ * @param Nr      Number of rounds.
+ * @param iv      16-Byte initialisation vector.
+ */
+uAES_AESNI_TARGET void aesni_cbc_decrypt(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr, const uint8_t *iv)
+{
+  __m128i c[uAES_AESNI_LANES], x[uAES_AESNI_LANES], rk, chain;
+  __m128i *p_blk = (__m128i *)buf;
+  size_t lane = 0;
+
+  chain = _mm_loadu_si128((const __m128i *)iv);
+  for(; nblocks >= uAES_AESNI_LANES; nblocks -= uAES_AESNI_LANES, p_blk += uAES_AESNI_LANES)
+  {
+    rk = uAES_RKEY(kschd, Nr);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      c[lane] = _mm_loadu_si128(&p_blk[lane]);
+      x[lane] = _mm_xor_si128(c[lane], rk);
+    }
+    for(size_t round = Nr - 1; round > 0; round--)
+    {
+      rk = uAES_RKEY(kschd, round);
+      for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+      {
+        x[lane] = _mm_aesdec_si128(x[lane], rk);
+      }
+    }
+    rk = uAES_RKEY(kschd, 0);
+    _mm_storeu_si128(&p_blk[0], _mm_xor_si128(_mm_aesdeclast_si128(x[0], rk), chain));
+    for(lane = 1; lane < uAES_AESNI_LANES; lane++)
+    {
+      _mm_storeu_si128(&p_blk[lane], _mm_xor_si128(_mm_aesdeclast_si128(x[lane], rk), c[lane - 1]));
+    }
+    chain = c[uAES_AESNI_LANES - 1];
+  }
+
+  for(; nblocks > 0; nblocks--, p_blk++)
+  {
+    c[0] = _mm_loadu_si128(p_blk);
+    _mm_storeu_si128(p_blk, _mm_xor_si128(aesni_decrypt(c[0], kschd, Nr), chain));
+    chain = c[0];
+  }
+  return;
+}
+
+/**
+ * @brief           Multiplies an XTS tweak by x in GF(2^128). Every 32-bit lane is doubled and
+ *                  takes the carry of the lane below it, the carry out of the top lane is
+ *                  reduced into the bottom one with 0x87.
+ * @param tweak     Little-endian tweak.
+ * @return __m128i  Doubled tweak.
+ */
+uAES_AESNI_TARGET static inline __m128i aesni_xts_double(__m128i tweak)
+{
+  __m128i carry = _mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), 0x93);
+
+  return _mm_xor_si128(_mm_add_epi32(tweak, tweak), _mm_and_si128(carry, _mm_set_epi32(1, 1, 1, 0x87)));
+}
+
+/**
+ * @brief         Processes XTS blocks in place, 8 blocks are kept in flight with their tweaks
+ *                held in registers.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to data key schedule, converted by aesni_inv_key_schedule() to decrypt.
+ * @param Nr      Number of rounds.
+ * @param tweak   Tweak of the first block, updated to the tweak of the next block.
+ * @param decrypt Non-zero to decrypt.
+ */
+uAES_AESNI_TARGET static inline void aesni_xts(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr, uint8_t *tweak, int decrypt)
+{
+  __m128i x[uAES_AESNI_LANES], t[uAES_AESNI_LANES], rk, next;
+  __m128i *p_blk = (__m128i *)buf;
+  size_t lane = 0;
+
+  next = _mm_loadu_si128((const __m128i *)tweak);
+  for(; nblocks >= uAES_AESNI_LANES; nblocks -= uAES_AESNI_LANES, p_blk += uAES_AESNI_LANES)
+  {
+    rk = uAES_RKEY(kschd, (0 != decrypt) ? Nr : 0);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      t[lane] = next;
+      next = aesni_xts_double(next);
+      x[lane] = _mm_xor_si128(_mm_xor_si128(_mm_loadu_si128(&p_blk[lane]), t[lane]), rk);
+    }
+    for(size_t round = 1; round < Nr; round++)
+    {
+      rk = uAES_RKEY(kschd, (0 != decrypt) ? (Nr - round) : round);
+      for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+      {
+        x[lane] = (0 != decrypt) ? _mm_aesdec_si128(x[lane], rk) : _mm_aesenc_si128(x[lane], rk);
+      }
+    }
+    rk = uAES_RKEY(kschd, (0 != decrypt) ? 0 : Nr);
+    for(lane = 0; lane < uAES_AESNI_LANES; lane++)
+    {
+      x[lane] = (0 != decrypt) ? _mm_aesdeclast_si128(x[lane], rk) : _mm_aesenclast_si128(x[lane], rk);
+      _mm_storeu_si128(&p_blk[lane], _mm_xor_si128(x[lane], t[lane]));
+    }
+  }
+
+  for(; nblocks > 0; nblocks--, p_blk++)
+  {
+    x[0] = _mm_xor_si128(_mm_loadu_si128(p_blk), next);
+    x[0] = (0 != decrypt) ? aesni_decrypt(x[0], kschd, Nr) : aesni_encrypt(x[0], kschd, Nr);
+    _mm_storeu_si128(p_blk, _mm_xor_si128(x[0], next));
+    next = aesni_xts_double(next);
+  }
+  _mm_storeu_si128((__m128i *)tweak, next);
+  return;
+}
+
+/**
+ * @brief         Encrypts XTS blocks in place.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to data key schedule.
+ * @param Nr      Number of rounds.
+ * @param tweak   Tweak of the first block, updated to the tweak of the next block.
+ */
+uAES_AESNI_TARGET void aesni_xts_encrypt(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr, uint8_t *tweak)
+{
+  aesni_xts(buf, nblocks, kschd, Nr, tweak, 0);
+  return;
+}
+
+/**
+ * @brief         Decrypts XTS blocks in place.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param kschd   Pointer to data key schedule converted by aesni_inv_key_schedule().
+ * @param Nr      Number of rounds.
+ * @param tweak   Tweak of the first block, updated to the tweak of the next block.
+ */
+uAES_AESNI_TARGET void aesni_xts_decrypt(uint8_t *buf, size_t nblocks, const uint32_t *kschd, size_t Nr, uint8_t *tweak)
+{
+  aesni_xts(buf, nblocks, kschd, Nr, tweak, 1);
+  return;
+}
+
+#endif /*__uAES_AESNI__*/
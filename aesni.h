@@ -0,0 +1,52 @@
+/**
+ * @file      aesni.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for the AES-NI hardware cipher engine.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef AESNI_H
+#define AESNI_H
+
+/**
+ * NOTE: The engine is built on x86 targets unless __uAES_NO_AESNI__ is defined, and only
+ *       used when CPUID reports AES-NI support at runtime.
+ */
+#if ( defined(__x86_64__) || defined(__i386__) ) && defined(__GNUC__) && !defined(__uAES_NO_AESNI__)
+#define __uAES_AESNI__
+#endif
+
+#ifdef __uAES_AESNI__
+extern int  aesni_available(void);
+extern void aesni_key_expansion(uint8_t* key, uint32_t* kschd, size_t Nk);
+extern void aesni_inv_key_schedule(uint32_t* kschd, size_t Nr);
+extern void aesni_encrypt_blocks(uint8_t* buf, size_t nblocks, const uint32_t* kschd, size_t Nr);
+extern void aesni_decrypt_blocks(uint8_t* buf, size_t nblocks, const uint32_t* kschd, size_t Nr);
+extern void aesni_cbc_encrypt(uint8_t* buf, size_t nblocks, const uint32_t* kschd, size_t Nr, const uint8_t* iv);
+extern void aesni_cbc_decrypt(uint8_t* buf, size_t nblocks, const uint32_t* kschd, size_t Nr, const uint8_t* iv);
+extern void aesni_xts_encrypt(uint8_t* buf, size_t nblocks, const uint32_t* kschd, size_t Nr, uint8_t* tweak);
+extern void aesni_xts_decrypt(uint8_t* buf, size_t nblocks, const uint32_t* kschd, size_t Nr, uint8_t* tweak);
+extern void aesni_cbc_encrypt_lanes(uint8_t* const* buf, size_t nlanes, size_t nblocks, const uint32_t* const* kschd, size_t Nr, uint8_t* chain);
+extern void aesni_cbc_mac_lanes(uint8_t* const* buf, size_t nlanes, size_t nblocks, const uint32_t* const* kschd, size_t Nr, uint8_t* chain);
+#endif /*__uAES_AESNI__*/
+
+#endif /*AESNI_H*/
@@ -0,0 +1,663 @@
+/**
+ * @file      bslice.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Bitsliced constant-time cipher engine, no table lookups nor data dependent branches.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *  
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "udbg.h"
+#include "bslice.h"
+
+#ifdef __uAES_BSLICE__
+
+#define uAES_BSLICE_BATCH_SIZE  ( 16UL * uAES_BSLICE_BLOCKS )
+
+/**
+ * NOTE: Bit p of a 64-bit lane holds row R = p / 16, column C = (p / 4) % 4 of block B = p % 4,
+ *       so that ShiftRows rotates 16-bit groups and MixColumns rotates whole lanes.
+ */
+#define uAES_BSLICE_OFFSET(p)   ( 16 * ( ( p ) & 3 ) + 4 * ( ( ( p ) >> 2 ) & 3 ) + ( ( p ) >> 4 ) )
+#define uAES_ROTR64(x, n)       ( ( ( x ) >> ( n ) ) | ( ( x ) << ( 64 - ( n ) ) ) )
+
+#define uAES_SWAPMOVE(a, b, mask, n)  do {      \
+  t  = ( ( ( b ) >> ( n ) ) ^ ( a ) ) & mask;   \
+  a ^= t;                                       \
+  b ^= t << ( n );                              \
+} while(0)
+
+static void bslice_transpose(bslice_t *q);
+static void bslice_load(bslice_t *q, const uint8_t *buf);
+static void bslice_store(uint8_t *buf, bslice_t *q);
+static void bslice_sbox(bslice_t *q);
+static void bslice_inv_sbox(bslice_t *q);
+static void bslice_shift_rows(bslice_t *q);
+static void bslice_inv_shift_rows(bslice_t *q);
+static void bslice_mix_columns(bslice_t *q);
+static void bslice_inv_mix_columns(bslice_t *q);
+static inline void bslice_add_round_key(bslice_t *q, const bslice_t *sk);
+static void bslice_encrypt(bslice_t *q, const bslice_t *bkschd, size_t Nr);
+static void bslice_decrypt(bslice_t *q, const bslice_t *bkschd, size_t Nr);
+
+/**
+ * @brief     Transposes the 8x8 bit matrices formed by the same byte of the 8 planes, this is
+ *            an involution and converts both from packed bytes to bit planes and back.
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_transpose(bslice_t *q)
+{
+  bslice_t t;
+
+  uAES_SWAPMOVE(q[1], q[0], 0x5555555555555555ULL, 1);
+  uAES_SWAPMOVE(q[3], q[2], 0x5555555555555555ULL, 1);
+  uAES_SWAPMOVE(q[5], q[4], 0x5555555555555555ULL, 1);
+  uAES_SWAPMOVE(q[7], q[6], 0x5555555555555555ULL, 1);
+  uAES_SWAPMOVE(q[2], q[0], 0x3333333333333333ULL, 2);
+  uAES_SWAPMOVE(q[3], q[1], 0x3333333333333333ULL, 2);
+  uAES_SWAPMOVE(q[6], q[4], 0x3333333333333333ULL, 2);
+  uAES_SWAPMOVE(q[7], q[5], 0x3333333333333333ULL, 2);
+  uAES_SWAPMOVE(q[4], q[0], 0x0F0F0F0F0F0F0F0FULL, 4);
+  uAES_SWAPMOVE(q[5], q[1], 0x0F0F0F0F0F0F0F0FULL, 4);
+  uAES_SWAPMOVE(q[6], q[2], 0x0F0F0F0F0F0F0F0FULL, 4);
+  uAES_SWAPMOVE(q[7], q[3], 0x0F0F0F0F0F0F0F0FULL, 4);
+  return;
+}
+
+/**
+ * @brief     Loads uAES_BSLICE_BLOCKS blocks into bit planes.
+ * @param q   Pointer to the 8 planes.
+ * @param buf Pointer to data buffer.
+ */
+static void bslice_load(bslice_t *q, const uint8_t *buf)
+{
+  uint64_t w = 0;
+
+  for(size_t lane = 0; lane < uAES_BSLICE_LANES; lane++)
+  {
+    for(size_t m = 0; m < 8; m++)
+    {
+      w = 0;
+      for(size_t k = 0; k < 8; k++)
+      {
+        w |= ( uint64_t )( buf[uAES_BSLICE_OFFSET(8 * k + m)] ) << ( 8 * k );
+      }
+      q[m][lane] = w;
+    }
+    buf += 64;
+  }
+  bslice_transpose(q);
+  return;
+}
+
+/**
+ * @brief     Stores bit planes back into uAES_BSLICE_BLOCKS blocks.
+ * @param buf Pointer to data buffer.
+ * @param q   Pointer to the 8 planes, destroyed on return.
+ */
+static void bslice_store(uint8_t *buf, bslice_t *q)
+{
+  uint64_t w = 0;
+
+  bslice_transpose(q);
+  for(size_t lane = 0; lane < uAES_BSLICE_LANES; lane++)
+  {
+    for(size_t m = 0; m < 8; m++)
+    {
+      w = q[m][lane];
+      for(size_t k = 0; k < 8; k++)
+      {
+        buf[uAES_BSLICE_OFFSET(8 * k + m)] = ( uint8_t )( w >> ( 8 * k ) );
+      }
+    }
+    buf += 64;
+  }
+  return;
+}
+
+/**
+ * @brief     Computes the sub-bytes transform on the bit planes with the Boyar-Peralta
+ *            circuit (113 gates), q[0] holds the least significant bit.
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_sbox(bslice_t *q)
+{
+  bslice_t x0, x1, x2, x3, x4, x5, x6, x7;
+  bslice_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+  bslice_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+  bslice_t y20, y21;
+  bslice_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+  bslice_t z10, z11, z12, z13, z14, z15, z16, z17;
+  bslice_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+  bslice_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+  bslice_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+  bslice_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+  bslice_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+  bslice_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+  bslice_t t60, t61, t62, t63, t64, t65, t66, t67;
+  bslice_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  x0 = q[7];
+  x1 = q[6];
+  x2 = q[5];
+  x3 = q[4];
+  x4 = q[3];
+  x5 = q[2];
+  x6 = q[1];
+  x7 = q[0];
+
+  /* Top linear transformation. */
+  y14 = x3 ^ x5;
+  y13 = x0 ^ x6;
+  y9  = x0 ^ x3;
+  y8  = x0 ^ x5;
+  t0  = x1 ^ x2;
+  y1  = t0 ^ x7;
+  y4  = y1 ^ x3;
+  y12 = y13 ^ y14;
+  y2  = y1 ^ x0;
+  y5  = y1 ^ x6;
+  y3  = y5 ^ y8;
+  t1  = x4 ^ y12;
+  y15 = t1 ^ x5;
+  y20 = t1 ^ x1;
+  y6  = y15 ^ x7;
+  y10 = y15 ^ t0;
+  y11 = y20 ^ y9;
+  y7  = x7 ^ y11;
+  y17 = y10 ^ y11;
+  y19 = y10 ^ y8;
+  y16 = t0 ^ y11;
+  y21 = y13 ^ y16;
+  y18 = x0 ^ y16;
+
+  /* Non-linear section. */
+  t2  = y12 & y15;
+  t3  = y3 & y6;
+  t4  = t3 ^ t2;
+  t5  = y4 & x7;
+  t6  = t5 ^ t2;
+  t7  = y13 & y16;
+  t8  = y5 & y1;
+  t9  = t8 ^ t7;
+  t10 = y2 & y7;
+  t11 = t10 ^ t7;
+  t12 = y9 & y11;
+  t13 = y14 & y17;
+  t14 = t13 ^ t12;
+  t15 = y8 & y10;
+  t16 = t15 ^ t12;
+  t17 = t4 ^ t14;
+  t18 = t6 ^ t16;
+  t19 = t9 ^ t14;
+  t20 = t11 ^ t16;
+  t21 = t17 ^ y20;
+  t22 = t18 ^ y19;
+  t23 = t19 ^ y21;
+  t24 = t20 ^ y18;
+
+  t25 = t21 ^ t22;
+  t26 = t21 & t23;
+  t27 = t24 ^ t26;
+  t28 = t25 & t27;
+  t29 = t28 ^ t22;
+  t30 = t23 ^ t24;
+  t31 = t22 ^ t26;
+  t32 = t31 & t30;
+  t33 = t32 ^ t24;
+  t34 = t23 ^ t33;
+  t35 = t27 ^ t33;
+  t36 = t24 & t35;
+  t37 = t36 ^ t34;
+  t38 = t27 ^ t36;
+  t39 = t29 & t38;
+  t40 = t25 ^ t39;
+
+  t41 = t40 ^ t37;
+  t42 = t29 ^ t33;
+  t43 = t29 ^ t40;
+  t44 = t33 ^ t37;
+  t45 = t42 ^ t41;
+  z0  = t44 & y15;
+  z1  = t37 & y6;
+  z2  = t33 & x7;
+  z3  = t43 & y16;
+  z4  = t40 & y1;
+  z5  = t29 & y7;
+  z6  = t42 & y11;
+  z7  = t45 & y17;
+  z8  = t41 & y10;
+  z9  = t44 & y12;
+  z10 = t37 & y3;
+  z11 = t33 & y4;
+  z12 = t43 & y13;
+  z13 = t40 & y5;
+  z14 = t29 & y2;
+  z15 = t42 & y9;
+  z16 = t45 & y14;
+  z17 = t41 & y8;
+
+  /* Bottom linear transformation. */
+  t46 = z15 ^ z16;
+  t47 = z10 ^ z11;
+  t48 = z5 ^ z13;
+  t49 = z9 ^ z10;
+  t50 = z2 ^ z12;
+  t51 = z2 ^ z5;
+  t52 = z7 ^ z8;
+  t53 = z0 ^ z3;
+  t54 = z6 ^ z7;
+  t55 = z16 ^ z17;
+  t56 = z12 ^ t48;
+  t57 = t50 ^ t53;
+  t58 = z4 ^ t46;
+  t59 = z3 ^ t54;
+  t60 = t46 ^ t57;
+  t61 = z14 ^ t57;
+  t62 = t52 ^ t58;
+  t63 = t49 ^ t58;
+  t64 = z4 ^ t59;
+  t65 = t61 ^ t62;
+  t66 = z1 ^ t63;
+  s0  = t59 ^ t63;
+  s6  = t56 ^ ~t62;
+  s7  = t48 ^ ~t60;
+  t67 = t64 ^ t65;
+  s3  = t53 ^ t66;
+  s4  = t51 ^ t66;
+  s5  = t47 ^ t65;
+  s1  = t64 ^ ~s3;
+  s2  = t55 ^ ~t67;
+
+  q[7] = s0;
+  q[6] = s1;
+  q[5] = s2;
+  q[4] = s3;
+  q[3] = s4;
+  q[2] = s5;
+  q[1] = s6;
+  q[0] = s7;
+  return;
+}
+
+/**
+ * @brief     Computes y = A^-1(x + 0x63), the inverse of the sub-bytes affine transform.
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_inv_affine(bslice_t *q)
+{
+  bslice_t q0, q1, q2, q3, q4, q5, q6, q7;
+
+  q0 = ~q[0];
+  q1 = ~q[1];
+  q2 = q[2];
+  q3 = q[3];
+  q4 = q[4];
+  q5 = ~q[5];
+  q6 = ~q[6];
+  q7 = q[7];
+  q[7] = q1 ^ q4 ^ q6;
+  q[6] = q0 ^ q3 ^ q5;
+  q[5] = q7 ^ q2 ^ q4;
+  q[4] = q6 ^ q1 ^ q3;
+  q[3] = q5 ^ q0 ^ q2;
+  q[2] = q4 ^ q7 ^ q1;
+  q[1] = q3 ^ q6 ^ q0;
+  q[0] = q2 ^ q5 ^ q7;
+  return;
+}
+
+/**
+ * @brief     Computes the inverse sub-bytes transform on the bit planes. The GF(2^8) inverse
+ *            is an involution, so InvS(x) = A^-1(S(A^-1(x + 0x63)) + 0x63).
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_inv_sbox(bslice_t *q)
+{
+  bslice_inv_affine(q);
+  bslice_sbox(q);
+  bslice_inv_affine(q);
+  return;
+}
+
+/**
+ * @brief     Computes the shift-rows operation, row R is a 16-bit group rotated by 4R bits.
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_shift_rows(bslice_t *q)
+{
+  bslice_t x;
+
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    x = q[idx];
+    q[idx] = ( x & 0x000000000000FFFFULL )
+      | ( ( x & 0x00000000FFF00000ULL ) >> 4 ) | ( ( x & 0x00000000000F0000ULL ) << 12 )
+      | ( ( x & 0x0000FF0000000000ULL ) >> 8 ) | ( ( x & 0x000000FF00000000ULL ) << 8 )
+      | ( ( x & 0xF000000000000000ULL ) >> 12 ) | ( ( x & 0x0FFF000000000000ULL ) << 4 );
+  }
+  return;
+}
+
+/**
+ * @brief     Computes the inverse shift-rows operation.
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_inv_shift_rows(bslice_t *q)
+{
+  bslice_t x;
+
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    x = q[idx];
+    q[idx] = ( x & 0x000000000000FFFFULL )
+      | ( ( x & 0x000000000FFF0000ULL ) << 4 ) | ( ( x & 0x00000000F0000000ULL ) >> 12 )
+      | ( ( x & 0x0000FF0000000000ULL ) >> 8 ) | ( ( x & 0x000000FF00000000ULL ) << 8 )
+      | ( ( x & 0x000F000000000000ULL ) << 12 ) | ( ( x & 0xFFF0000000000000ULL ) >> 4 );
+  }
+  return;
+}
+
+/**
+ * @brief     Computes the mix-columns operation. Rotating a lane by 16 bits brings row R + 1
+ *            on top of row R, hence out = 2(a + a') + a' + a'' + a'''.
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_mix_columns(bslice_t *q)
+{
+  bslice_t r[8], s[8];
+
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    r[idx] = uAES_ROTR64(q[idx], 16);
+    s[idx] = q[idx] ^ r[idx];
+    r[idx] ^= uAES_ROTR64(s[idx], 32);
+  }
+  q[0] = s[7] ^ r[0];
+  q[1] = s[0] ^ s[7] ^ r[1];
+  q[2] = s[1] ^ r[2];
+  q[3] = s[2] ^ s[7] ^ r[3];
+  q[4] = s[3] ^ s[7] ^ r[4];
+  q[5] = s[4] ^ r[5];
+  q[6] = s[5] ^ r[6];
+  q[7] = s[6] ^ r[7];
+  return;
+}
+
+/**
+ * @brief     Computes the inverse mix-columns operation, factored as MixColumns applied
+ *            after a'[R] = a[R] + 4(a[R] + a[R + 2]).
+ * @param q   Pointer to the 8 planes.
+ */
+static void bslice_inv_mix_columns(bslice_t *q)
+{
+  bslice_t s[8];
+
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    s[idx] = q[idx] ^ uAES_ROTR64(q[idx], 32);
+  }
+  q[0] ^= s[6];
+  q[1] ^= s[6] ^ s[7];
+  q[2] ^= s[0] ^ s[7];
+  q[3] ^= s[1] ^ s[6];
+  q[4] ^= s[2] ^ s[6] ^ s[7];
+  q[5] ^= s[3] ^ s[7];
+  q[6] ^= s[4];
+  q[7] ^= s[5];
+  bslice_mix_columns(q);
+  return;
+}
+
+/**
+ * @brief     Computes round key addition on the bit planes.
+ * @param q   Pointer to the 8 planes.
+ * @param sk  Pointer to the transposed round key.
+ */
+static inline void bslice_add_round_key(bslice_t *q, const bslice_t *sk)
+{
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    q[idx] ^= sk[idx];
+  }
+  return;
+}
+
+/**
+ * @brief         Computes foward cipher on the bit planes.
+ * @param q       Pointer to the 8 planes.
+ * @param bkschd  Pointer to the transposed key schedule.
+ * @param Nr      Number of rounds.
+ */
+static void bslice_encrypt(bslice_t *q, const bslice_t *bkschd, size_t Nr)
+{
+  bslice_add_round_key(q, &bkschd[0]);
+  for(size_t round = 1; round < Nr; round++)
+  {
+    bslice_sbox(q);
+    bslice_shift_rows(q);
+    bslice_mix_columns(q);
+    bslice_add_round_key(q, &bkschd[8 * round]);
+  }
+  bslice_sbox(q);
+  bslice_shift_rows(q);
+  bslice_add_round_key(q, &bkschd[8 * Nr]);
+  return;
+}
+
+/**
+ * @brief         Computes inverse cipher on the bit planes.
+ * @param q       Pointer to the 8 planes.
+ * @param bkschd  Pointer to the transposed key schedule.
+ * @param Nr      Number of rounds.
+ */
+static void bslice_decrypt(bslice_t *q, const bslice_t *bkschd, size_t Nr)
+{
+  bslice_add_round_key(q, &bkschd[8 * Nr]);
+  for(size_t round = Nr - 1; round > 0; round--)
+  {
+    bslice_inv_shift_rows(q);
+    bslice_inv_sbox(q);
+    bslice_add_round_key(q, &bkschd[8 * round]);
+    bslice_inv_mix_columns(q);
+  }
+  bslice_inv_shift_rows(q);
+  bslice_inv_sbox(q);
+  bslice_add_round_key(q, &bkschd[0]);
+  return;
+}
+
+/**
+ * @brief           Computes the sub-bytes transform on each byte of a 32-bit word without
+ *                  table lookups, used by the key expansion algorithm.
+ * @param word      32-bit word variable.
+ * @return uint32_t Mapped 32-bit word.
+ */
+uint32_t bslice_sub_word(uint32_t word)
+{
+  bslice_t q[8];
+
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    q[idx] = ( bslice_t ){ 0 };
+    q[idx][0] = ( word >> idx ) & 0x01010101ULL;
+  }
+  bslice_sbox(q);
+  word = 0;
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    word |= ( uint32_t )( q[idx][0] & 0x01010101ULL ) << idx;
+  }
+  return word;
+}
+
+/**
+ * @brief         Converts a key schedule into the transposed format, each round key is
+ *                broadcast to every block and stored as 8 bit planes.
+ * @param kschd   Pointer to key schedule buffer generated by key expansion algorithm.
+ * @param bkschd  Pointer to transposed key schedule buffer (8 * (Nr + 1) planes).
+ * @param Nr      Number of rounds.
+ */
+void bslice_key_schedule(const uint32_t *kschd, bslice_t *bkschd, size_t Nr)
+{
+  uint8_t rkey[uAES_BSLICE_BATCH_SIZE];
+
+  for(size_t round = 0; round <= Nr; round++)
+  {
+    for(size_t idx = 0; idx < uAES_BSLICE_BATCH_SIZE; idx++)
+    {
+      rkey[idx] = ( uint8_t )( kschd[4 * round + ( ( idx & 15 ) >> 2 )] >> ( 8 * ( idx & 3 ) ) );
+    }
+    bslice_load(&bkschd[8 * round], rkey);
+  }
+  memset(rkey, 0, sizeof(rkey));
+  return;
+}
+
+/**
+ * @brief         Encrypts independent blocks in place, uAES_BSLICE_BLOCKS at a time. A partial
+ *                batch is run in full on a zero padded copy.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param bkschd  Pointer to the transposed key schedule.
+ * @param Nr      Number of rounds.
+ */
+void bslice_encrypt_blocks(uint8_t *buf, size_t nblocks, const bslice_t *bkschd, size_t Nr)
+{
+  bslice_t q[8];
+  uint8_t  tail[uAES_BSLICE_BATCH_SIZE] = {0};
+
+  for(; nblocks >= uAES_BSLICE_BLOCKS; nblocks -= uAES_BSLICE_BLOCKS, buf += uAES_BSLICE_BATCH_SIZE)
+  {
+    bslice_load(q, buf);
+    bslice_encrypt(q, bkschd, Nr);
+    bslice_store(buf, q);
+  }
+  if(0 < nblocks)
+  {
+    memcpy(tail, buf, 16 * nblocks);
+    bslice_load(q, tail);
+    bslice_encrypt(q, bkschd, Nr);
+    bslice_store(tail, q);
+    memcpy(buf, tail, 16 * nblocks);
+  }
+  return;
+}
+
+/**
+ * @brief         Decrypts independent blocks in place, uAES_BSLICE_BLOCKS at a time.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param bkschd  Pointer to the transposed key schedule.
+ * @param Nr      Number of rounds.
+ */
+void bslice_decrypt_blocks(uint8_t *buf, size_t nblocks, const bslice_t *bkschd, size_t Nr)
+{
+  bslice_t q[8];
+  uint8_t  tail[uAES_BSLICE_BATCH_SIZE] = {0};
+
+  for(; nblocks >= uAES_BSLICE_BLOCKS; nblocks -= uAES_BSLICE_BLOCKS, buf += uAES_BSLICE_BATCH_SIZE)
+  {
+    bslice_load(q, buf);
+    bslice_decrypt(q, bkschd, Nr);
+    bslice_store(buf, q);
+  }
+  if(0 < nblocks)
+  {
+    memcpy(tail, buf, 16 * nblocks);
+    bslice_load(q, tail);
+    bslice_decrypt(q, bkschd, Nr);
+    bslice_store(tail, q);
+    memcpy(buf, tail, 16 * nblocks);
+  }
+  return;
+}
+
+/**
+ * @brief         Computes CBC encryption in place. Blocks are chained, so every block runs a
+ *                whole batch on its own, which keeps the engine constant-time.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param bkschd  Pointer to the transposed key schedule.
+ * @param Nr      Number of rounds.
+ * @param iv      16-Byte initialisation vector.
+ */
+void bslice_cbc_encrypt(uint8_t *buf, size_t nblocks, const bslice_t *bkschd, size_t Nr, const uint8_t *iv)
+{
+  const uint8_t *chain = iv;
+
+  for(; nblocks > 0; nblocks--, buf += 16)
+  {
+    for(size_t idx = 0; idx < 16; idx++)
+    {
+      buf[idx] ^= chain[idx];
+    }
+    bslice_encrypt_blocks(buf, 1UL, bkschd, Nr);
+    chain = buf;
+  }
+  return;
+}
+
+/**
+ * @brief         Computes CBC decryption in place from the first block onwards, blocks only
+ *                depend on ciphertext and are decrypted uAES_BSLICE_BLOCKS at a time.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param bkschd  Pointer to the transposed key schedule.
+ * @param Nr      Number of rounds.
+ * @param iv      16-Byte initialisation vector.
+ */
+void bslice_cbc_decrypt(uint8_t *buf, size_t nblocks, const bslice_t *bkschd, size_t Nr, const uint8_t *iv)
+{
+  bslice_t q[8];
+  uint8_t  batch[uAES_BSLICE_BATCH_SIZE] = {0};
+  uint8_t  chain[16] = {0};
+  size_t   count = 0;
+
+  memcpy(chain, iv, 16);
+  while(0 < nblocks)
+  {
+    count = ( nblocks < uAES_BSLICE_BLOCKS ) ? ( nblocks ) : ( uAES_BSLICE_BLOCKS );
+    memcpy(batch, buf, 16 * count);
+    bslice_load(q, batch);
+    bslice_decrypt(q, bkschd, Nr);
+    bslice_store(batch, q);
+    for(size_t idx = 0; idx < 16; idx++)
+    {
+      batch[idx] ^= chain[idx];
+    }
+    for(size_t idx = 16; idx < 16 * count; idx++)
+    {
+      batch[idx] ^= buf[idx - 16];
+    }
+    memcpy(chain, &buf[16 * ( count - 1 )], 16);
+    memcpy(buf, batch, 16 * count);
+    buf += 16 * count;
+    nblocks -= count;
+  }
+  return;
+}
+
+#endif /*__uAES_BSLICE__*/
@@ -0,0 +1,59 @@
+/**
+ * @file      bslice.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for the bitsliced constant-time cipher engine.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef BSLICE_H
+#define BSLICE_H
+
+#ifdef __uAES_BSLICE__
+
+/**
+ * NOTE: A bit plane holds one bit of every byte of 4 blocks per 64-bit lane. Planes are
+ *       128-bit vectors (8 blocks, SSE2/NEON) or 256-bit vectors on AVX2 builds (16 blocks).
+ */
+#ifdef __AVX2__
+#define uAES_BSLICE_LANES     4UL
+#else
+#define uAES_BSLICE_LANES     2UL
+#endif /*__AVX2__*/
+#define uAES_BSLICE_BLOCKS    ( 4UL * uAES_BSLICE_LANES )
+
+/**
+ * NOTE: Transposed key schedule, 8 bit planes per round key, see bslice_key_schedule().
+ */
+#define uAES_BSLICE_KSCHD_SIZE  ( 8UL * 15UL )
+
+typedef uint64_t bslice_t __attribute__((vector_size(8 * uAES_BSLICE_LANES)));
+
+extern uint32_t bslice_sub_word(uint32_t word);
+extern void bslice_key_schedule(const uint32_t* kschd, bslice_t* bkschd, size_t Nr);
+extern void bslice_encrypt_blocks(uint8_t* buf, size_t nblocks, const bslice_t* bkschd, size_t Nr);
+extern void bslice_decrypt_blocks(uint8_t* buf, size_t nblocks, const bslice_t* bkschd, size_t Nr);
+extern void bslice_cbc_encrypt(uint8_t* buf, size_t nblocks, const bslice_t* bkschd, size_t Nr, const uint8_t* iv);
+extern void bslice_cbc_decrypt(uint8_t* buf, size_t nblocks, const bslice_t* bkschd, size_t Nr, const uint8_t* iv);
+
+#endif /*__uAES_BSLICE__*/
+
+#endif /*BSLICE_H*/
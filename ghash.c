@@ -0,0 +1,470 @@
+/**
+ * @file      ghash.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     GHASH universal hash used by AES-GCM, with a portable table engine and a carry-less
+ *            multiply engine dispatched at runtime.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "udbg.h"
+#include "aesni.h"
+#include "ghash.h"
+
+/**
+ * @brief Shifts a 128-bit field element right by one bit, multiplying it by x in GHASH bit
+ *        order, and reduces it by the GCM polynomial.
+ */
+#define uAES_GHASH_REDUCE1BIT(hi, lo) do {                                                \
+  uint64_t t = 0xE100000000000000ULL & (0ULL - ((lo) & 1ULL));                            \
+  (lo) = ((hi) << 63) | ((lo) >> 1);                                                      \
+  (hi) = ((hi) >> 1) ^ t;                                                                 \
+} while(0)
+
+#ifdef __uAES_GHASH_TABLE8__
+/**
+ * @brief Reduction of the byte shifted out of the low end of the accumulator, as the top 16
+ *        bits of a 64-bit word.
+ */
+static const uint16_t rem_8bit[256] =
+{
+  0x0000, 0x01C2, 0x0384, 0x0246, 0x0708, 0x06CA, 0x048C, 0x054E,
+  0x0E10, 0x0FD2, 0x0D94, 0x0C56, 0x0918, 0x08DA, 0x0A9C, 0x0B5E,
+  0x1C20, 0x1DE2, 0x1FA4, 0x1E66, 0x1B28, 0x1AEA, 0x18AC, 0x196E,
+  0x1230, 0x13F2, 0x11B4, 0x1076, 0x1538, 0x14FA, 0x16BC, 0x177E,
+  0x3840, 0x3982, 0x3BC4, 0x3A06, 0x3F48, 0x3E8A, 0x3CCC, 0x3D0E,
+  0x3650, 0x3792, 0x35D4, 0x3416, 0x3158, 0x309A, 0x32DC, 0x331E,
+  0x2460, 0x25A2, 0x27E4, 0x2626, 0x2368, 0x22AA, 0x20EC, 0x212E,
+  0x2A70, 0x2BB2, 0x29F4, 0x2836, 0x2D78, 0x2CBA, 0x2EFC, 0x2F3E,
+  0x7080, 0x7142, 0x7304, 0x72C6, 0x7788, 0x764A, 0x740C, 0x75CE,
+  0x7E90, 0x7F52, 0x7D14, 0x7CD6, 0x7998, 0x785A, 0x7A1C, 0x7BDE,
+  0x6CA0, 0x6D62, 0x6F24, 0x6EE6, 0x6BA8, 0x6A6A, 0x682C, 0x69EE,
+  0x62B0, 0x6372, 0x6134, 0x60F6, 0x65B8, 0x647A, 0x663C, 0x67FE,
+  0x48C0, 0x4902, 0x4B44, 0x4A86, 0x4FC8, 0x4E0A, 0x4C4C, 0x4D8E,
+  0x46D0, 0x4712, 0x4554, 0x4496, 0x41D8, 0x401A, 0x425C, 0x439E,
+  0x54E0, 0x5522, 0x5764, 0x56A6, 0x53E8, 0x522A, 0x506C, 0x51AE,
+  0x5AF0, 0x5B32, 0x5974, 0x58B6, 0x5DF8, 0x5C3A, 0x5E7C, 0x5FBE,
+  0xE100, 0xE0C2, 0xE284, 0xE346, 0xE608, 0xE7CA, 0xE58C, 0xE44E,
+  0xEF10, 0xEED2, 0xEC94, 0xED56, 0xE818, 0xE9DA, 0xEB9C, 0xEA5E,
+  0xFD20, 0xFCE2, 0xFEA4, 0xFF66, 0xFA28, 0xFBEA, 0xF9AC, 0xF86E,
+  0xF330, 0xF2F2, 0xF0B4, 0xF176, 0xF438, 0xF5FA, 0xF7BC, 0xF67E,
+  0xD940, 0xD882, 0xDAC4, 0xDB06, 0xDE48, 0xDF8A, 0xDDCC, 0xDC0E,
+  0xD750, 0xD692, 0xD4D4, 0xD516, 0xD058, 0xD19A, 0xD3DC, 0xD21E,
+  0xC560, 0xC4A2, 0xC6E4, 0xC726, 0xC268, 0xC3AA, 0xC1EC, 0xC02E,
+  0xCB70, 0xCAB2, 0xC8F4, 0xC936, 0xCC78, 0xCDBA, 0xCFFC, 0xCE3E,
+  0x9180, 0x9042, 0x9204, 0x93C6, 0x9688, 0x974A, 0x950C, 0x94CE,
+  0x9F90, 0x9E52, 0x9C14, 0x9DD6, 0x9898, 0x995A, 0x9B1C, 0x9ADE,
+  0x8DA0, 0x8C62, 0x8E24, 0x8FE6, 0x8AA8, 0x8B6A, 0x892C, 0x88EE,
+  0x83B0, 0x8272, 0x8034, 0x81F6, 0x84B8, 0x857A, 0x873C, 0x86FE,
+  0xA9C0, 0xA802, 0xAA44, 0xAB86, 0xAEC8, 0xAF0A, 0xAD4C, 0xAC8E,
+  0xA7D0, 0xA612, 0xA454, 0xA596, 0xA0D8, 0xA11A, 0xA35C, 0xA29E,
+  0xB5E0, 0xB422, 0xB664, 0xB7A6, 0xB2E8, 0xB32A, 0xB16C, 0xB0AE,
+  0xBBF0, 0xBA32, 0xB874, 0xB9B6, 0xBCF8, 0xBD3A, 0xBF7C, 0xBEBE
+};
+#else
+/**
+ * @brief Reduction of the nibble shifted out of the low end of the accumulator, as the top 16
+ *        bits of a 64-bit word.
+ */
+static const uint16_t rem_4bit[16] =
+{
+  0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+  0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+};
+#endif /*__uAES_GHASH_TABLE8__*/
+
+static uint64_t ghash_load64(const uint8_t *src);
+static void     ghash_store64(uint8_t *dst, uint64_t val);
+static void     ghash_table_init(ghash_key_t *key, const uint8_t *h);
+static void     ghash_table_mult(uint8_t *xi, const ghash_key_t *key);
+static void     ghash_table_blocks(uint8_t *xi, const uint8_t *buf, size_t nblocks, const ghash_key_t *key);
+
+#ifdef __uAES_AESNI__
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+/**
+ * NOTE: Same scheme as the AES-NI engine, only these functions are compiled for PCLMULQDQ.
+ */
+#define uAES_CLMUL_TARGET       __attribute__((target("pclmul,ssse3,sse2")))
+#define uAES_CPUID_ECX_PCLMUL   (1U << 1)
+#define uAES_CPUID_ECX_SSSE3    (1U << 9)
+
+static volatile int clmul_state = -1;
+
+static int ghash_clmul_available(void);
+uAES_CLMUL_TARGET static inline __m128i ghash_bswap(__m128i x);
+uAES_CLMUL_TARGET static inline void    ghash_clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *hi);
+uAES_CLMUL_TARGET static inline __m128i ghash_clmul_reduce(__m128i lo, __m128i hi);
+uAES_CLMUL_TARGET static void           ghash_clmul_init(ghash_key_t *key, const uint8_t *h);
+uAES_CLMUL_TARGET static void           ghash_clmul_blocks(uint8_t *xi, const uint8_t *buf, size_t nblocks, const ghash_key_t *key);
+#endif /*__uAES_AESNI__*/
+
+/**
+ * @brief Loads a big-endian 64-bit word.
+ * @param src Pointer to 8 bytes.
+ * @return uint64_t Loaded word.
+ */
+static uint64_t ghash_load64(const uint8_t *src)
+{
+  uint64_t val = 0;
+
+  for(size_t idx = 0; idx < 8; idx++)
+  {
+    val = (val << 8) | src[idx];
+  }
+  return val;
+}
+
+/**
+ * @brief Stores a big-endian 64-bit word.
+ * @param dst Pointer to 8 bytes.
+ * @param val Word to be stored.
+ */
+static void ghash_store64(uint8_t *dst, uint64_t val)
+{
+  for(size_t idx = 8; idx > 0; idx--)
+  {
+    dst[idx - 1] = (uint8_t)val;
+    val >>= 8;
+  }
+  return;
+}
+
+/**
+ * @brief Computes the multiples of H indexed by every nibble (byte) value. Entries at powers
+ *        of two are H times successive powers of x, the others are XORs of those.
+ * @param key Pointer to GHASH key.
+ * @param h   16-Byte hash subkey.
+ */
+static void ghash_table_init(ghash_key_t *key, const uint8_t *h)
+{
+  uint64_t hi = ghash_load64(&h[0]);
+  uint64_t lo = ghash_load64(&h[8]);
+  size_t idx = uAES_GHASH_TABLE_SIZE >> 1;
+
+  key->htab[0][0] = 0;
+  key->htab[0][1] = 0;
+  key->htab[idx][0] = hi;
+  key->htab[idx][1] = lo;
+  for(idx >>= 1; idx > 0; idx >>= 1)
+  {
+    uAES_GHASH_REDUCE1BIT(hi, lo);
+    key->htab[idx][0] = hi;
+    key->htab[idx][1] = lo;
+  }
+  for(idx = 2; idx < uAES_GHASH_TABLE_SIZE; idx <<= 1)
+  {
+    for(size_t sub = 1; sub < idx; sub++)
+    {
+      key->htab[idx + sub][0] = key->htab[idx][0] ^ key->htab[sub][0];
+      key->htab[idx + sub][1] = key->htab[idx][1] ^ key->htab[sub][1];
+    }
+  }
+  return;
+}
+
+#ifdef __uAES_GHASH_TABLE8__
+/**
+ * @brief Multiplies the hash state by H one byte at a time, from the last byte to the first.
+ * @param xi  16-Byte hash state.
+ * @param key Pointer to GHASH key.
+ */
+static void ghash_table_mult(uint8_t *xi, const ghash_key_t *key)
+{
+  uint64_t hi = 0, lo = 0;
+  size_t rem = 0, idx = 15;
+
+  for(;;)
+  {
+    hi ^= key->htab[xi[idx]][0];
+    lo ^= key->htab[xi[idx]][1];
+    if(0 == idx)
+    {
+      break;
+    }
+    idx--;
+    rem = (size_t)(lo & 0xFF);
+    lo = (hi << 56) | (lo >> 8);
+    hi = (hi >> 8) ^ ((uint64_t)rem_8bit[rem] << 48);
+  }
+
+  ghash_store64(&xi[0], hi);
+  ghash_store64(&xi[8], lo);
+  return;
+}
+#else
+/**
+ * @brief Multiplies the hash state by H one nibble at a time, from the last byte to the first,
+ *        low nibble first. Shifting the accumulator while it is still zero has no effect.
+ * @param xi  16-Byte hash state.
+ * @param key Pointer to GHASH key.
+ */
+static void ghash_table_mult(uint8_t *xi, const ghash_key_t *key)
+{
+  uint64_t hi = 0, lo = 0;
+  size_t rem = 0, nib = 0;
+
+  for(size_t idx = 16; idx > 0; idx--)
+  {
+    for(size_t shift = 0; shift < 8; shift += 4)
+    {
+      nib = (xi[idx - 1] >> shift) & 0x0F;
+      rem = (size_t)(lo & 0x0F);
+      lo = (hi << 60) | (lo >> 4);
+      hi = (hi >> 4) ^ ((uint64_t)rem_4bit[rem] << 48);
+      hi ^= key->htab[nib][0];
+      lo ^= key->htab[nib][1];
+    }
+  }
+
+  ghash_store64(&xi[0], hi);
+  ghash_store64(&xi[8], lo);
+  return;
+}
+#endif /*__uAES_GHASH_TABLE8__*/
+
+/**
+ * @brief Hashes blocks into the hash state with the table engine.
+ * @param xi      16-Byte hash state.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param key     Pointer to GHASH key.
+ */
+static void ghash_table_blocks(uint8_t *xi, const uint8_t *buf, size_t nblocks, const ghash_key_t *key)
+{
+  for(; nblocks > 0; nblocks--, buf += 16)
+  {
+    for(size_t idx = 0; idx < 16; idx++)
+    {
+      xi[idx] ^= buf[idx];
+    }
+    ghash_table_mult(xi, key);
+  }
+  return;
+}
+
+#ifdef __uAES_AESNI__
+/**
+ * @brief       Checks, once, whether the CPU supports PCLMULQDQ and SSSE3.
+ * @return int  [1] if available, [0] otherwise.
+ */
+static int ghash_clmul_available(void)
+{
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  unsigned int msk = uAES_CPUID_ECX_PCLMUL | uAES_CPUID_ECX_SSSE3;
+
+  if(0 > clmul_state)
+  {
+    if(0 != __get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+      clmul_state = (msk == (ecx & msk)) ? (1) : (0);
+    }
+    else
+    {
+      clmul_state = 0;
+    }
+  }
+  return clmul_state;
+}
+
+/**
+ * @brief           Reverses the byte order of a block, GHASH operands are multiplied as
+ *                  byte reversed 128-bit integers.
+ * @param x         Block.
+ * @return __m128i  Byte reversed block.
+ */
+uAES_CLMUL_TARGET static inline __m128i ghash_bswap(__m128i x)
+{
+  return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+/**
+ * @brief     Accumulates the unreduced 256-bit carry-less product of a and b.
+ * @param a   First operand.
+ * @param b   Second operand.
+ * @param lo  Low 128 bits of the accumulator.
+ * @param hi  High 128 bits of the accumulator.
+ */
+uAES_CLMUL_TARGET static inline void ghash_clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *hi)
+{
+  __m128i mid;
+
+  *lo = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+  *hi = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+  mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+  *lo = _mm_xor_si128(*lo, _mm_slli_si128(mid, 8));
+  *hi = _mm_xor_si128(*hi, _mm_srli_si128(mid, 8));
+  return;
+}
+
+/**
+ * @brief           Reduces a 256-bit carry-less product modulo the GCM polynomial. The product
+ *                  is shifted left by one bit first, as the operands are bit reflected. Both
+ *                  steps are linear, so the sum of several products is reduced only once.
+ * @param lo        Low 128 bits of the product.
+ * @param hi        High 128 bits of the product.
+ * @return __m128i  Reduced field element.
+ */
+uAES_CLMUL_TARGET static inline __m128i ghash_clmul_reduce(__m128i lo, __m128i hi)
+{
+  __m128i t0, t1, t2;
+
+  t0 = _mm_srli_epi32(lo, 31);
+  t1 = _mm_srli_epi32(hi, 31);
+  lo = _mm_slli_epi32(lo, 1);
+  hi = _mm_slli_epi32(hi, 1);
+  t2 = _mm_srli_si128(t0, 12);
+  t1 = _mm_slli_si128(t1, 4);
+  t0 = _mm_slli_si128(t0, 4);
+  lo = _mm_or_si128(lo, t0);
+  hi = _mm_or_si128(hi, t1);
+  hi = _mm_or_si128(hi, t2);
+
+  t0 = _mm_slli_epi32(lo, 31);
+  t1 = _mm_slli_epi32(lo, 30);
+  t2 = _mm_slli_epi32(lo, 25);
+  t0 = _mm_xor_si128(t0, t1);
+  t0 = _mm_xor_si128(t0, t2);
+  t1 = _mm_srli_si128(t0, 4);
+  t0 = _mm_slli_si128(t0, 12);
+  lo = _mm_xor_si128(lo, t0);
+
+  t2 = _mm_srli_epi32(lo, 1);
+  t0 = _mm_srli_epi32(lo, 2);
+  t2 = _mm_xor_si128(t2, t0);
+  t0 = _mm_srli_epi32(lo, 7);
+  t2 = _mm_xor_si128(t2, t0);
+  t2 = _mm_xor_si128(t2, t1);
+  lo = _mm_xor_si128(lo, t2);
+  return _mm_xor_si128(hi, lo);
+}
+
+/**
+ * @brief     Computes the powers H^1 to H^4 used by the aggregated reduction.
+ * @param key Pointer to GHASH key.
+ * @param h   16-Byte hash subkey.
+ */
+uAES_CLMUL_TARGET static void ghash_clmul_init(ghash_key_t *key, const uint8_t *h)
+{
+  __m128i h1 = ghash_bswap(_mm_loadu_si128((const __m128i *)h));
+  __m128i hn = h1, lo, hi;
+
+  _mm_storeu_si128((__m128i *)key->hpow[0], h1);
+  for(size_t idx = 1; idx < uAES_GHASH_AGGREGATE; idx++)
+  {
+    lo = _mm_setzero_si128();
+    hi = _mm_setzero_si128();
+    ghash_clmul_acc(hn, h1, &lo, &hi);
+    hn = ghash_clmul_reduce(lo, hi);
+    _mm_storeu_si128((__m128i *)key->hpow[idx], hn);
+  }
+  return;
+}
+
+/**
+ * @brief         Hashes blocks into the hash state with PCLMULQDQ. Four blocks are multiplied
+ *                by H^4 to H^1 and summed before a single reduction.
+ * @param xi      16-Byte hash state.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param key     Pointer to GHASH key.
+ */
+uAES_CLMUL_TARGET static void ghash_clmul_blocks(uint8_t *xi, const uint8_t *buf, size_t nblocks, const ghash_key_t *key)
+{
+  const __m128i *p_blk = (const __m128i *)buf;
+  __m128i x = ghash_bswap(_mm_loadu_si128((const __m128i *)xi));
+  __m128i h1 = _mm_loadu_si128((const __m128i *)key->hpow[0]);
+  __m128i h2 = _mm_loadu_si128((const __m128i *)key->hpow[1]);
+  __m128i h3 = _mm_loadu_si128((const __m128i *)key->hpow[2]);
+  __m128i h4 = _mm_loadu_si128((const __m128i *)key->hpow[3]);
+  __m128i lo, hi;
+
+  for(; nblocks >= uAES_GHASH_AGGREGATE; nblocks -= uAES_GHASH_AGGREGATE, p_blk += uAES_GHASH_AGGREGATE)
+  {
+    lo = _mm_setzero_si128();
+    hi = _mm_setzero_si128();
+    ghash_clmul_acc(_mm_xor_si128(ghash_bswap(_mm_loadu_si128(&p_blk[0])), x), h4, &lo, &hi);
+    ghash_clmul_acc(ghash_bswap(_mm_loadu_si128(&p_blk[1])), h3, &lo, &hi);
+    ghash_clmul_acc(ghash_bswap(_mm_loadu_si128(&p_blk[2])), h2, &lo, &hi);
+    ghash_clmul_acc(ghash_bswap(_mm_loadu_si128(&p_blk[3])), h1, &lo, &hi);
+    x = ghash_clmul_reduce(lo, hi);
+  }
+
+  for(; nblocks > 0; nblocks--, p_blk++)
+  {
+    lo = _mm_setzero_si128();
+    hi = _mm_setzero_si128();
+    ghash_clmul_acc(_mm_xor_si128(ghash_bswap(_mm_loadu_si128(p_blk)), x), h1, &lo, &hi);
+    x = ghash_clmul_reduce(lo, hi);
+  }
+
+  _mm_storeu_si128((__m128i *)xi, ghash_bswap(x));
+  return;
+}
+#endif /*__uAES_AESNI__*/
+
+/**
+ * @brief     Prepares a GHASH key for the engine selected on this CPU.
+ * @param key Pointer to GHASH key.
+ * @param h   16-Byte hash subkey, the encryption of the all-zero block.
+ */
+void ghash_init(ghash_key_t *key, const uint8_t *h)
+{
+#ifdef __uAES_AESNI__
+  if(0 != ghash_clmul_available())
+  {
+    ghash_clmul_init(key, h);
+    return;
+  }
+#endif /*__uAES_AESNI__*/
+  ghash_table_init(key, h);
+  return;
+}
+
+/**
+ * @brief         Hashes blocks into the hash state, xi = (xi ^ block) * H for every block.
+ * @param xi      16-Byte hash state.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param key     Pointer to GHASH key prepared by ghash_init().
+ */
+void ghash_blocks(uint8_t *xi, const uint8_t *buf, size_t nblocks, const ghash_key_t *key)
+{
+#ifdef __uAES_AESNI__
+  if(0 != ghash_clmul_available())
+  {
+    ghash_clmul_blocks(xi, buf, nblocks, key);
+    return;
+  }
+#endif /*__uAES_AESNI__*/
+  ghash_table_blocks(xi, buf, nblocks, key);
+  return;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file      ghash.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for the GHASH universal hash used by AES-GCM.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef GHASH_H
+#define GHASH_H
+
+/**
+ * NOTE: The portable engine uses Shoup's method with 4-bit tables (256 bytes per key), or
+ *       8-bit tables (4 KB per key) when __uAES_GHASH_TABLE8__ is defined. Table lookups are
+ *       indexed by secret data, the carry-less multiply engine is used whenever the CPU
+ *       supports it.
+ */
+#ifdef __uAES_GHASH_TABLE8__
+#define uAES_GHASH_TABLE_SIZE   256UL
+#else
+#define uAES_GHASH_TABLE_SIZE   16UL
+#endif /*__uAES_GHASH_TABLE8__*/
+
+/**
+ * NOTE: Blocks hashed per carry-less multiply reduction, powers H^1 to H^4 are kept.
+ */
+#define uAES_GHASH_AGGREGATE    4UL
+
+typedef struct ghash_key
+{
+  uint64_t  htab[uAES_GHASH_TABLE_SIZE][2];   // Multiples of H, high and low 64 bits.
+  uint8_t   hpow[uAES_GHASH_AGGREGATE][16];   // Byte reversed H^1 to H^4.
+}ghash_key_t;
+
+extern void ghash_init(ghash_key_t* key, const uint8_t* h);
+extern void ghash_blocks(uint8_t* xi, const uint8_t* buf, size_t nblocks, const ghash_key_t* key);
+
+#endif /*GHASH_H*/
@@ -0,0 +1,344 @@
+/**
+ * @file      kcache.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Cache of expanded key schedules for the one-shot API. Keys are located
+ *            through a keyed hash so that probing time does not depend on key bits.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "uaes.h"
+#include "kcache.h"
+
+#ifdef __uAES_KEY_CACHE__
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define uAES_KEY_CACHE_SETS   ( uAES_KEY_CACHE_SIZE / uAES_KEY_CACHE_WAYS )
+
+#if (0 == uAES_KEY_CACHE_SETS) || (0 != (uAES_KEY_CACHE_SIZE % uAES_KEY_CACHE_WAYS))
+#error "uAES_KEY_CACHE_SIZE must be a non-zero multiple of uAES_KEY_CACHE_WAYS."
+#endif
+
+#define uAES_SIP_ROTL(x, b)   ( ((x) << (b)) | ((x) >> (64 - (b))) )
+
+/**
+ * @brief Cached key schedules. An entry with aes_length uAESRGE is free.
+ */
+typedef struct kcache_entry
+{
+  uaes_ctx_t    ctx;
+  uint8_t       key[uAES_MAX_KEY_SIZE];
+  aes_length_t  aes_length;
+  uint64_t      stamp;
+}kcache_entry_t;
+
+static struct
+{
+  kcache_entry_t  entry[uAES_KEY_CACHE_SIZE];
+  uint64_t        sip[2];
+  uint64_t        clock;
+  uint64_t        hits;
+  uint64_t        misses;
+  int             seeded;
+  int             ready;
+  volatile char   lock;
+} cache;
+
+static void     kcache_lock(void);
+static void     kcache_unlock(void);
+static void     kcache_init(void);
+static uint64_t kcache_hash(const uint8_t *key, aes_length_t aes_length);
+static size_t   kcache_match(const uint8_t *a, const uint8_t *b, size_t size);
+static size_t   kcache_probe(const kcache_entry_t *set, const uint8_t *key, aes_length_t aes_length, size_t *found);
+
+static void kcache_lock(void)
+{
+  while(__atomic_test_and_set(&cache.lock, __ATOMIC_ACQUIRE))
+  {
+    while(0 != __atomic_load_n(&cache.lock, __ATOMIC_RELAXED));
+  }
+  return;
+}
+
+static void kcache_unlock(void)
+{
+  __atomic_clear(&cache.lock, __ATOMIC_RELEASE);
+  return;
+}
+
+/**
+ * @brief Marks every entry free and, unless kcache_seed() was called, draws the hash key
+ *        from /dev/urandom on POSIX hosts. Called with the lock held. The cache stays
+ *        disabled until it is seeded, a known hash key would let keys be steered into one set.
+ */
+static void kcache_init(void)
+{
+  size_t idx = 0;
+#if defined(__unix__) || defined(__APPLE__)
+  int fd = -1;
+
+  if(0 == cache.seeded)
+  {
+    fd = open("/dev/urandom", O_RDONLY);
+    if(0 <= fd)
+    {
+      cache.seeded = (sizeof(cache.sip) == read(fd, cache.sip, sizeof(cache.sip))) ? (1) : (0);
+      close(fd);
+    }
+  }
+#endif
+  for(idx = 0; idx < uAES_KEY_CACHE_SIZE; idx++)
+  {
+    cache.entry[idx].aes_length = uAESRGE;
+  }
+  cache.ready = 1;
+  return;
+}
+
+/**
+ * @brief SipHash-2-4 of the key bytes and length under the secret hash key, so that the set
+ *        a key lands in reveals nothing about it.
+ */
+static uint64_t kcache_hash(const uint8_t *key, aes_length_t aes_length)
+{
+  uint64_t v0 = cache.sip[0] ^ 0x736f6d6570736575ULL;
+  uint64_t v1 = cache.sip[1] ^ 0x646f72616e646f6dULL;
+  uint64_t v2 = cache.sip[0] ^ 0x6c7967656e657261ULL;
+  uint64_t v3 = cache.sip[1] ^ 0x7465646279746573ULL;
+  uint64_t m = 0;
+  size_t size = 16UL + (8UL * aes_length);
+  size_t idx = 0, round = 0, byte = 0;
+
+#define uAES_SIP_ROUND                                                          \
+  do                                                                            \
+  {                                                                             \
+    v0 += v1; v1 = uAES_SIP_ROTL(v1, 13); v1 ^= v0; v0 = uAES_SIP_ROTL(v0, 32); \
+    v2 += v3; v3 = uAES_SIP_ROTL(v3, 16); v3 ^= v2;                             \
+    v0 += v3; v3 = uAES_SIP_ROTL(v3, 21); v3 ^= v0;                             \
+    v2 += v1; v1 = uAES_SIP_ROTL(v1, 17); v1 ^= v2; v2 = uAES_SIP_ROTL(v2, 32); \
+  } while(0)
+
+  /* Keys are whole 8-byte words, the final word only holds the length. */
+  for(idx = 0; idx <= size; idx += 8UL)
+  {
+    m = (idx < size) ? (0ULL) : ((uint64_t)size << 56);
+    for(byte = 0; (byte < 8UL) && (idx < size); byte++)
+    {
+      m |= (uint64_t)key[idx + byte] << (8UL * byte);
+    }
+    v3 ^= m;
+    for(round = 0; round < 2UL; round++)
+    {
+      uAES_SIP_ROUND;
+    }
+    v0 ^= m;
+  }
+  v2 ^= 0xFFULL;
+  for(round = 0; round < 4UL; round++)
+  {
+    uAES_SIP_ROUND;
+  }
+#undef uAES_SIP_ROUND
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/**
+ * @brief Compares two buffers in constant time.
+ * @return size_t [1] if equal, [0] otherwise.
+ */
+static size_t kcache_match(const uint8_t *a, const uint8_t *b, size_t size)
+{
+  uint8_t diff = 0U;
+  size_t idx = 0;
+
+  for(idx = 0; idx < size; idx++)
+  {
+    diff |= a[idx] ^ b[idx];
+  }
+  return (size_t)(1U & (((uint32_t)diff - 1U) >> 8));
+}
+
+/**
+ * @brief Looks a key up in its set. Every way is compared in full and the matching way is
+ *        picked with a mask, so the probe takes the same time wherever the key is found.
+ * @param set         First way of the key's set.
+ * @param key         Pointer to key.
+ * @param aes_length  Key length.
+ * @param found       Receives the matching way, left at [0] on a miss.
+ * @return size_t     [1] on a hit, [0] on a miss.
+ */
+static size_t kcache_probe(const kcache_entry_t *set, const uint8_t *key, aes_length_t aes_length, size_t *found)
+{
+  size_t way = 0, hit = 0, match = 0, mask = 0;
+
+  *found = 0;
+  for(way = 0; way < uAES_KEY_CACHE_WAYS; way++)
+  {
+    match = kcache_match(set[way].key, key, 16UL + (8UL * aes_length)) & (size_t)(set[way].aes_length == aes_length);
+    mask = 0UL - match;
+    *found = (*found & ~mask) | (way & mask);
+    hit |= match;
+  }
+  return hit;
+}
+
+/**
+ * @brief Copies the cached key schedules of a key into a context, see kcache_probe().
+ * @param ctx         Pointer to cipher context.
+ * @param key         Pointer to key.
+ * @param aes_length  Key length.
+ * @return int        [1] on a hit, [0] on a miss.
+ */
+int kcache_get(uaes_ctx_t *ctx, const uint8_t *key, aes_length_t aes_length)
+{
+  kcache_entry_t *set = NULL;
+  size_t hit = 0, found = 0;
+
+  kcache_lock();
+  if(0 == cache.ready)
+  {
+    kcache_init();
+  }
+  if(0 == cache.seeded)
+  {
+    kcache_unlock();
+    return 0;
+  }
+  set = &cache.entry[(kcache_hash(key, aes_length) % uAES_KEY_CACHE_SETS) * uAES_KEY_CACHE_WAYS];
+  hit = kcache_probe(set, key, aes_length, &found);
+  if(0UL != hit)
+  {
+    memcpy((void *)ctx, (void *)&set[found].ctx, sizeof(uaes_ctx_t));
+    set[found].stamp = ++cache.clock;
+    cache.hits++;
+  }
+  else
+  {
+    cache.misses++;
+  }
+  kcache_unlock();
+  return (int)hit;
+}
+
+/**
+ * @brief Stores the key schedules of a context in place of the least recently used way of the
+ *        key's set. A key stored by another thread since the lookup missed is overwritten, so
+ *        a set never holds a key twice.
+ * @param ctx   Pointer to cipher context holding both key schedules.
+ * @param key   Pointer to key.
+ */
+void kcache_put(const uaes_ctx_t *ctx, const uint8_t *key)
+{
+  kcache_entry_t *set = NULL;
+  size_t way = 0, lru = 0, found = 0;
+
+  kcache_lock();
+  if(0 == cache.ready)
+  {
+    kcache_init();
+  }
+  if(0 == cache.seeded)
+  {
+    kcache_unlock();
+    return;
+  }
+  set = &cache.entry[(kcache_hash(key, ctx->aes_length) % uAES_KEY_CACHE_SETS) * uAES_KEY_CACHE_WAYS];
+  for(way = 1; way < uAES_KEY_CACHE_WAYS; way++)
+  {
+    lru = (set[way].stamp < set[lru].stamp) ? (way) : (lru);
+  }
+  if(0UL != kcache_probe(set, key, ctx->aes_length, &found))
+  {
+    lru = found;
+  }
+  memcpy((void *)&set[lru].ctx, (void *)ctx, sizeof(uaes_ctx_t));
+  memset((void *)set[lru].key, 0, uAES_MAX_KEY_SIZE);
+  memcpy((void *)set[lru].key, (void *)key, 16UL + (8UL * ctx->aes_length));
+  set[lru].aes_length = ctx->aes_length;
+  set[lru].stamp = ++cache.clock;
+  kcache_unlock();
+  return;
+}
+
+/**
+ * @brief Sets the 16-byte hash key and empties the cache. POSIX hosts draw one from
+ *        /dev/urandom on first use, other targets must call this at start-up with a random
+ *        seed, the cache is bypassed until then.
+ * @param seed  16-Byte hash key.
+ */
+void kcache_seed(const uint8_t *seed)
+{
+  kcache_lock();
+  memcpy((void *)cache.sip, (void *)seed, sizeof(cache.sip));
+  cache.seeded = 1;
+  kcache_unlock();
+  kcache_wipe();
+  return;
+}
+
+/**
+ * @brief Reads the hit and miss counters.
+ */
+void kcache_stats(uint64_t *hits, uint64_t *misses)
+{
+  kcache_lock();
+  *hits = cache.hits;
+  *misses = cache.misses;
+  kcache_unlock();
+  return;
+}
+
+/**
+ * @brief Zeroes every cached key and key schedule and resets the counters. The hash key is
+ *        kept.
+ */
+void kcache_wipe(void)
+{
+  volatile uint8_t *p_byte = (volatile uint8_t *)cache.entry;
+  size_t idx = 0;
+
+  kcache_lock();
+  for(idx = 0; idx < sizeof(cache.entry); idx++)
+  {
+    p_byte[idx] = 0U;
+  }
+  for(idx = 0; idx < uAES_KEY_CACHE_SIZE; idx++)
+  {
+    cache.entry[idx].aes_length = uAESRGE;
+  }
+  cache.clock = 0;
+  cache.hits = 0;
+  cache.misses = 0;
+  kcache_unlock();
+  return;
+}
+
+#endif /*__uAES_KEY_CACHE__*/
@@ -0,0 +1,44 @@
+/**
+ * @file      kcache.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for the key schedule cache of the one-shot API.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef KCACHE_H
+#define KCACHE_H
+
+/**
+ * NOTE: The cache is only built when __uAES_KEY_CACHE__ is defined. uaes.h must be included
+ *       first.
+ */
+#ifdef __uAES_KEY_CACHE__
+
+extern int  kcache_get(uaes_ctx_t *ctx, const uint8_t *key, aes_length_t aes_length);
+extern void kcache_put(const uaes_ctx_t *ctx, const uint8_t *key);
+extern void kcache_seed(const uint8_t *seed);
+extern void kcache_stats(uint64_t *hits, uint64_t *misses);
+extern void kcache_wipe(void);
+
+#endif /*__uAES_KEY_CACHE__*/
+
+#endif /*KCACHE_H*/
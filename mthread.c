@@ -0,0 +1,222 @@
+/**
+ * @file      mthread.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Persistent pthread worker pool. A job is split into chunks that workers and the
+ *            calling thread claim from a shared atomic index until none are left.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mthread.h"
+
+#ifdef __uAES_PTHREAD__
+
+#include <pthread.h>
+
+/**
+ * @brief Pool state. Workers sleep on wake until gen changes, the submitting thread sleeps on
+ *        idle until every worker has left the current job. run serialises submitters.
+ */
+static struct
+{
+  pthread_mutex_t lock;
+  pthread_mutex_t run;
+  pthread_cond_t  wake;
+  pthread_cond_t  idle;
+  pthread_t       workers[uAES_MT_MAX_THREADS];
+  size_t          nworkers;
+  size_t          busy;
+  unsigned long   gen;
+  int             stop;
+  mthread_fn_t    fn;
+  void            *arg;
+  size_t          nchunks;
+  size_t          next;
+} pool = 
+{
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .run  = PTHREAD_MUTEX_INITIALIZER,
+  .wake = PTHREAD_COND_INITIALIZER,
+  .idle = PTHREAD_COND_INITIALIZER,
+};
+
+/**
+ * @brief Claims and processes chunks of the current job until none are left.
+ */
+static void mthread_drain(void)
+{
+  size_t chunk = __atomic_fetch_add(&pool.next, 1UL, __ATOMIC_RELAXED);
+
+  while(pool.nchunks > chunk)
+  {
+    pool.fn(pool.arg, chunk);
+    chunk = __atomic_fetch_add(&pool.next, 1UL, __ATOMIC_RELAXED);
+  }
+  return;
+}
+
+/**
+ * @brief Worker thread body.
+ * @param gen Job generation at creation time, a worker may only get scheduled after the first
+ *            job has been submitted, so it cannot read it from the pool itself.
+ * @return void* Always NULL.
+ */
+static void *mthread_worker(void *gen)
+{
+  unsigned long seen = (unsigned long)(uintptr_t)gen;
+
+  pthread_mutex_lock(&pool.lock);
+  for(;;)
+  {
+    while((0 == pool.stop) && (seen == pool.gen))
+    {
+      pthread_cond_wait(&pool.wake, &pool.lock);
+    }
+    if(0 != pool.stop)
+    {
+      break;
+    }
+    seen = pool.gen;
+    pthread_mutex_unlock(&pool.lock);
+
+    mthread_drain();
+
+    pthread_mutex_lock(&pool.lock);
+    pool.busy--;
+    if(0UL == pool.busy)
+    {
+      pthread_cond_signal(&pool.idle);
+    }
+  }
+  pthread_mutex_unlock(&pool.lock);
+  return NULL;
+}
+
+/**
+ * @brief Starts the worker pool. The thread submitting a job takes part in it, so nthreads - 1
+ *        workers are created.
+ * @param nthreads  Total number of threads working on a job [1, uAES_MT_MAX_THREADS].
+ * @return int      [0] if sucessful, [-1] on failure or if the pool is already running.
+ */
+int mthread_init(size_t nthreads)
+{
+  int err = -1;
+  size_t idx = 0UL;
+
+  if((0UL < nthreads) && (uAES_MT_MAX_THREADS >= nthreads))
+  {
+    pthread_mutex_lock(&pool.run);
+    if(0UL == pool.nworkers)
+    {
+      err = 0;
+      pool.stop = 0;
+      for(idx = 0UL; idx < (nthreads - 1UL); idx++)
+      {
+        if(0 != pthread_create(&pool.workers[idx], NULL, mthread_worker, (void *)(uintptr_t)pool.gen))
+        {
+          break;
+        }
+      }
+      __atomic_store_n(&pool.nworkers, idx, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&pool.run);
+  }
+
+  return err;
+}
+
+/**
+ * @brief Stops and joins every worker, waiting for a job in progress to finish first.
+ */
+void mthread_destroy(void)
+{
+  pthread_mutex_lock(&pool.run);
+
+  pthread_mutex_lock(&pool.lock);
+  pool.stop = 1;
+  pthread_cond_broadcast(&pool.wake);
+  pthread_mutex_unlock(&pool.lock);
+
+  for(size_t idx = 0UL; idx < pool.nworkers; idx++)
+  {
+    pthread_join(pool.workers[idx], NULL);
+  }
+  __atomic_store_n(&pool.nworkers, 0UL, __ATOMIC_RELAXED);
+
+  pthread_mutex_unlock(&pool.run);
+  return;
+}
+
+/**
+ * @brief Returns the number of threads taking part in a job, including the caller.
+ * @return size_t Number of threads, 1 when the pool is not running.
+ */
+size_t mthread_threads(void)
+{
+  return __atomic_load_n(&pool.nworkers, __ATOMIC_RELAXED) + 1UL;
+}
+
+/**
+ * @brief Runs fn on every chunk of a job, returning once all of them are done. When the pool is
+ *        already busy with a job submitted by another thread, the chunks are processed on the
+ *        calling thread alone instead of waiting for it.
+ * @param fn      Chunk handler.
+ * @param arg     Argument passed to the handler.
+ * @param nchunks Number of chunks.
+ */
+void mthread_run(mthread_fn_t fn, void *arg, size_t nchunks)
+{
+  if(0 != pthread_mutex_trylock(&pool.run))
+  {
+    for(size_t chunk = 0UL; chunk < nchunks; chunk++)
+    {
+      fn(arg, chunk);
+    }
+    return;
+  }
+
+  pthread_mutex_lock(&pool.lock);
+  pool.fn = fn;
+  pool.arg = arg;
+  pool.nchunks = nchunks;
+  pool.next = 0UL;
+  pool.busy = pool.nworkers;
+  pool.gen++;
+  pthread_cond_broadcast(&pool.wake);
+  pthread_mutex_unlock(&pool.lock);
+
+  mthread_drain();
+
+  pthread_mutex_lock(&pool.lock);
+  while(0UL != pool.busy)
+  {
+    pthread_cond_wait(&pool.idle, &pool.lock);
+  }
+  pthread_mutex_unlock(&pool.lock);
+
+  pthread_mutex_unlock(&pool.run);
+  return;
+}
+
+#endif /*__uAES_PTHREAD__*/
@@ -0,0 +1,46 @@
+/**
+ * @file      mthread.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for the pthread worker pool used by the multi-threaded modes.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef MTHREAD_H
+#define MTHREAD_H
+
+/**
+ * NOTE: The pool is only built when __uAES_PTHREAD__ is defined, link with -lpthread.
+ */
+#ifdef __uAES_PTHREAD__
+
+#define uAES_MT_MAX_THREADS   ( 64UL )
+
+typedef void (*mthread_fn_t)(void *arg, size_t chunk);
+
+extern int    mthread_init(size_t nthreads);
+extern void   mthread_destroy(void);
+extern size_t mthread_threads(void);
+extern void   mthread_run(mthread_fn_t fn, void *arg, size_t nchunks);
+
+#endif /*__uAES_PTHREAD__*/
+
+#endif /*MTHREAD_H*/
@@ -30,79 +30,131 @@
 #include <string.h>
 
 #include "udbg.h"
+#include "uprof.h"
 #include "ops.h"
+#include "ttab.h"
+#include "bslice.h"
 
-#define uAES_MAX_BLOCK_LEN  16
-
-static const uint8_t  s_box_fwd_map       = 0x63;
-static const uint8_t  s_box_inv_map       = 0x05;
-static const uint16_t rijndael_polynomial = 0x11B;
-
-static inline uint32_t rotword( uint32_t word );
-static inline uint32_t word_shift( uint32_t word, size_t nshifts );
-static inline uint32_t inv_word_shift( uint32_t word, size_t nshifts );
-static inline uint8_t  circ_shift( uint8_t byte, size_t nshifts );
-static inline uint8_t  inv_circ_shift( uint8_t byte, size_t nshifts );
-static uint8_t  gf256_mul( uint8_t Na, uint8_t Nb );
-static uint8_t  gf256_inv( uint8_t Na );
-static uint32_t rcon( uint8_t val );
-static uint8_t  sub_bytes( uint8_t byte );
-static uint32_t sub_word( uint32_t word );
+/**
+ * @brief State columns are packed little-endian, row r of a column in byte r, the same order
+ *        as the key schedule words.
+ */
+#define uAES_COL_BYTE0(w)     ( ( uint8_t )( ( w ) ) )
+#define uAES_COL_BYTE1(w)     ( ( uint8_t )( ( w ) >> 8 ) )
+#define uAES_COL_BYTE2(w)     ( ( uint8_t )( ( w ) >> 16 ) )
+#define uAES_COL_BYTE3(w)     ( ( uint8_t )( ( w ) >> 24 ) )
+#define uAES_COL_ROT(w, n)    ( ( ( w ) >> ( n ) ) | ( ( w ) << ( 32 - ( n ) ) ) )
 
 /**
- * @brief           Performs word rotation operation on given 32-bit variable.
- * @param word      32-bit variable
- * @return uint32_t Rotated 32-bit word.
+ * @brief Traces the state columns, only debug builds spill them to memory.
  */
-static inline uint32_t rotword(uint32_t word)
-{
-  return ( word >> 8 ) | ( word << 24 );
-}
+#ifdef __uAES_DEBUG__
+#define uAES_TRACE_STATE(msk, fmt, v, round) do {               \
+  uint8_t state[16];                                            \
+  col_store(&state[0], v##0);                                   \
+  col_store(&state[4], v##1);                                   \
+  col_store(&state[8], v##2);                                   \
+  col_store(&state[12], v##3);                                  \
+  uAES_TRACE_BLOCK(msk, fmt, state, ( size_t )( round ));       \
+} while(0)
+#else
+#define uAES_TRACE_STATE(msk, fmt, v, round) do {} while(0)
+#endif /*__uAES_DEBUG__*/
 
 /**
- * @brief           Performs a cyclical byte shift operation on given 32-bit variable.
- * @param word      32-bit variable
- * @param nshifts   Number of desired shifts.
- * @return uint32_t Cyclical-shifted 32-bit variable.
+ * @brief Round constants for the key expansion algorithm, packed as 32-bit words
+ *        in the same byte order used by the key schedule (constant on the first byte).
+ *        Index 0 is never used by the key expansion algorithm.
  */
-static inline uint32_t word_shift(uint32_t word, size_t nshifts)
+static const uint32_t rcon[11] =
 {
-  return ( ( word >> 8 * nshifts ) | ( word << ( 32 - 8 * nshifts ) ) );
-}
+  0x00000000, 0x00000001, 0x00000002, 0x00000004, 0x00000008, 0x00000010,
+  0x00000020, 0x00000040, 0x00000080, 0x0000001b, 0x00000036
+};
 
+#ifdef __uAES_RUNTIME_TABLES__
 /**
- * @brief           Performs an inverse cyclical byte shift operation on 32-bit variable.
- * @param word      32-bit variable.
- * @param nshifts   Number of desired shifts.
- * @return uint32_t Inverse cyclical-shifted 32-bit variable.
+ * @brief S-box tables are generated by uaes_tables_init() on startup, trading
+ *        512 bytes of flash for RAM.
  */
-static inline uint32_t inv_word_shift(uint32_t word, size_t nshifts)
+static const uint8_t  s_box_fwd_map = 0x63;
+uint8_t s_box[256]     = {0};
+uint8_t inv_s_box[256] = {0};
+#else
+/**
+ * @brief Pre-computed sub-bytes transform, s_box[x] = A(x^-1) + 0x63 over GF(2^8).
+ */
+const uint8_t s_box[256] =
 {
-  return ( ( word << 8 * nshifts ) | ( word >> ( 32 - 8 * nshifts ) ) );
-}
-
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
 /**
- * @brief           Performs a circular bit-shift operation on given byte.
- * @param byte      Byte variable.
- * @param nshifts   Number of desired shifts.
- * @return uint8_t  Shifted byte.
+ * @brief Pre-computed inverse sub-bytes transform, inv_s_box[s_box[x]] = x.
  */
-static inline uint8_t circ_shift(uint8_t byte, size_t nshifts)
+const uint8_t inv_s_box[256] =
 {
-  return ( byte << nshifts ) | ( byte >> ( 8 - nshifts ) );
-}
+  0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+  0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+  0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+  0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+  0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+  0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+  0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+  0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+  0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+  0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+  0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+  0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+  0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+  0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+  0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+  0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
+};
+#endif /*__uAES_RUNTIME_TABLES__*/
+
+static inline uint32_t rotword( uint32_t word );
+static inline uint32_t col_load( const uint8_t *buf );
+static inline void     col_store( uint8_t *buf, uint32_t col );
+static inline uint32_t sub_shift( uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3 );
+static inline uint32_t inv_sub_shift( uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3 );
+static inline uint32_t xtime_col( uint32_t col );
+static inline uint32_t mix_column( uint32_t col );
+static inline uint32_t inv_mix_column( uint32_t col );
+static uint32_t sub_word( uint32_t word );
+#ifdef __uAES_RUNTIME_TABLES__
+static uint8_t  gf256_mul( uint8_t Na, uint8_t Nb );
+static inline uint8_t  circ_shift( uint8_t byte, size_t nshifts );
+static uint8_t  gf256_inv( uint8_t Na );
+#endif /*__uAES_RUNTIME_TABLES__*/
 
 /**
- * @brief           Performs an inverse circular bit-shift operation on given byte.
- * @param byte      Byte variable. 
- * @param nshifts   Number of desired shifts.
- * @return uint8_t  Inverse shifted byte.
+ * @brief           Performs word rotation operation on given 32-bit variable.
+ * @param word      32-bit variable
+ * @return uint32_t Rotated 32-bit word.
  */
-static inline uint8_t inv_circ_shift(uint8_t byte, size_t nshifts)
+static inline uint32_t rotword(uint32_t word)
 {
-  return ( ( byte >> nshifts ) | ( byte << ( 8 - nshifts ) ) );
+  return ( word >> 8 ) | ( word << 24 );
 }
 
+#ifdef __uAES_RUNTIME_TABLES__
+static const uint16_t rijndael_polynomial = 0x11B;
+
 /**
  * @brief           Computes the 256-element Galois Field multiplication on given unsigned 8-bit numbers. 
  * @param Na        Unsigned 8-bit number.
@@ -120,6 +172,17 @@ static uint8_t gf256_mul(uint8_t Na, uint8_t Nb)
   return prod;
 }
 
+/**
+ * @brief           Performs a circular bit-shift operation on given byte.
+ * @param byte      Byte variable.
+ * @param nshifts   Number of desired shifts.
+ * @return uint8_t  Shifted byte.
+ */
+static inline uint8_t circ_shift(uint8_t byte, size_t nshifts)
+{
+  return ( byte << nshifts ) | ( byte >> ( 8 - nshifts ) );
+}
+
 /**
  * @brief           Computes the inverse multiplier of a given unsigned 8-bit number.
  * @param Na        Unsigned 8-bit number.
@@ -140,40 +203,33 @@ static uint8_t gf256_inv(uint8_t Na)
 }
 
 /**
- * @brief           Computes round constant for key expansion algorithm.
- * @param val       Indexed value.
- * @return uint32_t Round constant
+ * @brief Generates the forward and inverse S-box tables. Runs once on startup on
+ *        hosted targets, bare-metal targets whose start-up code does not walk the
+ *        constructor list must call it before any cipher operation.
  */
-static uint32_t rcon(uint8_t val)
+__attribute__((constructor)) void uaes_tables_init(void)
 {
-  uint32_t rconst = 0;
-  rconst = (val == 9)?(0x1b000000):((val == 10)?(0x36000000):(0x01000000 << (val - 1)));
-  return rconst;
-}
+  uint8_t sbyte = 0;
+  size_t  idx = 0;
 
-/**
- * @brief           Computes sub-bytes transform on given byte variable. 
- * @param byte      Byte variable
- * @return uint8_t  Mapped byte.
- */
-static uint8_t sub_bytes(uint8_t byte)
-{
-  uint8_t sbyte = gf256_inv(byte);
-  sbyte = ( sbyte ^ circ_shift(sbyte, 1) ^ circ_shift(sbyte, 2) ^ circ_shift(sbyte, 3) ^ circ_shift(sbyte, 4) ) ^ s_box_fwd_map;
-  return sbyte;
+  for(idx = 0; idx < 256; idx++)
+  {
+    sbyte = gf256_inv((uint8_t)idx);
+    sbyte = ( sbyte ^ circ_shift(sbyte, 1) ^ circ_shift(sbyte, 2) ^ circ_shift(sbyte, 3) ^ circ_shift(sbyte, 4) ) ^ s_box_fwd_map;
+    s_box[idx] = sbyte;
+    inv_s_box[sbyte] = (uint8_t)idx;
+  }
+#ifdef __uAES_TTABLE__
+  ttab_tables_init();
+#endif /*__uAES_TTABLE__*/
+  return;
 }
-
-/**
- * @brief           Computes the inverse sub-bytes transform on given byte variable.
- * @param sbyte     Byte variable (MUST have been previously mapped by sub-bytes transform).
- * @return uint8_t  Re-mapped byte.
- */
-static uint8_t inv_sub_bytes(uint8_t sbyte)
+#else
+void uaes_tables_init(void)
 {
-  uint8_t byte = ( circ_shift(sbyte, 1) ^ circ_shift(sbyte, 3) ^ circ_shift(sbyte, 6) ) ^ s_box_inv_map;
-  byte = gf256_inv(byte);
-  return byte;
+  return;
 }
+#endif /*__uAES_RUNTIME_TABLES__*/
 
 /**
  * @brief           Computes the sub-bytes transform on each byte of the given 32-bit word.
@@ -182,6 +238,10 @@ static uint8_t inv_sub_bytes(uint8_t sbyte)
  */
 static uint32_t sub_word(uint32_t word)
 {
+#ifdef __uAES_BSLICE__
+  /* Key dependent table lookups are avoided on the constant-time engine. */
+  return bslice_sub_word(word);
+#else
   uint8_t  tmp = 0;
   uint32_t s_word = 0;
   size_t idx = 0;
@@ -189,124 +249,152 @@ static uint32_t sub_word(uint32_t word)
   while( idx < 4 )
   {
     tmp = ( uint8_t )( ( word ) >> ( idx*8 ) );
-    tmp = sub_bytes(tmp);
+    tmp = s_box[tmp];
     s_word |= ( ( uint32_t )( tmp ) ) << ( idx*8 );
     idx++;
   }
   return s_word;
+#endif /*__uAES_BSLICE__*/
 }
 
 /**
- * @brief       Computes the sub-bytes transform on each byte of the given data block.
- * @param block Pointer to the first element from the data block array.  
- * @param Nb    Number of 32-bit words present on data block array.
+ * @brief           Loads a state column from the data buffer, row r in byte r.
+ * @param buf       Pointer to the first byte of the column.
+ * @return uint32_t Packed column.
  */
-void sub_block(uint8_t *block, size_t Nb)
+static inline uint32_t col_load(const uint8_t *buf)
 {
-  for(size_t idx = 0; idx < 4*Nb; idx++)
-  {   
-    block[idx] = sub_bytes(block[idx]);
-  }
-  return;
+  return ( uint32_t )( buf[0] | buf[1] << 8 | buf[2] << 16 | ( uint32_t )( buf[3] ) << 24 );
 }
 
 /**
- * @brief       Computes the inverse sub-bytes transform on each byte of the given data block.
- * @param block Pointer to the first element from the data block array.
- * @param Nb    Number of 32-bit words present on data block array.
+ * @brief       Stores a state column into the data buffer.
+ * @param buf   Pointer to the first byte of the column.
+ * @param col   Packed column.
  */
-void inv_sub_block(uint8_t *block, size_t Nb)
+static inline void col_store(uint8_t *buf, uint32_t col)
 {
-  for(size_t idx = 0; idx < 4*Nb; idx++)
-  {   
-    block[idx] = inv_sub_bytes(block[idx]);
-  }
+  buf[0] = uAES_COL_BYTE0(col);
+  buf[1] = uAES_COL_BYTE1(col);
+  buf[2] = uAES_COL_BYTE2(col);
+  buf[3] = uAES_COL_BYTE3(col);
   return;
 }
 
 /**
- * @brief         Computes the shift-rows operation on given data block.
- * @param block   Pointer to the first element from the data block array.
- * @param Nb      Number of 32-bit words present on data block array.
+ * @brief           Computes sub-bytes and shift-rows for one output column. Row r of the
+ *                  column comes from column c + r, so the shift is a byte select.
+ * @param c0        Column c, supplies row 0.
+ * @param c1        Column c + 1, supplies row 1.
+ * @param c2        Column c + 2, supplies row 2.
+ * @param c3        Column c + 3, supplies row 3.
+ * @return uint32_t Output column.
  */
-void shift_rows(uint8_t *block, size_t Nb)
-{   
-  uint32_t tmp = 0;
-  for(size_t C = 0; C < Nb; C++)
-  {
-    tmp = (uint32_t)( block[C] | block[C + 4] << 8 | block[C + 8] << 16 | block[C + 12] << 24 );
-    tmp = word_shift(tmp, C);    
-    for(size_t R = 0; R < Nb; R++)
-    {
-        block[C + 4*R] = ( uint8_t )( tmp >> 8*R );
-    }     
-  }
-  return;
+static inline uint32_t sub_shift(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3)
+{
+  return ( uint32_t )( s_box[uAES_COL_BYTE0(c0)] | s_box[uAES_COL_BYTE1(c1)] << 8 | s_box[uAES_COL_BYTE2(c2)] << 16 | ( uint32_t )( s_box[uAES_COL_BYTE3(c3)] ) << 24 );
 }
 
 /**
- * @brief       Computes the inverse shift-rows operation on given data block.
- * @param block Pointer to the first element from the data block array.
- * @param Nb    Number of 32-bit words present on data block array.
+ * @brief           Computes inverse sub-bytes and inverse shift-rows for one output column.
+ *                  Row r of the column comes from column c - r.
+ * @param c0        Column c, supplies row 0.
+ * @param c1        Column c - 1, supplies row 1.
+ * @param c2        Column c - 2, supplies row 2.
+ * @param c3        Column c - 3, supplies row 3.
+ * @return uint32_t Output column.
  */
-void inv_shift_rows(uint8_t *block, size_t Nb)
+static inline uint32_t inv_sub_shift(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-  uint32_t tmp = 0;
-  for(size_t C = 0; C < Nb; C++)
-  {
-    tmp = (uint32_t)( block[C] | block[C + 4] << 8 | block[C + 8] << 16 | block[C + 12] << 24 );
-    tmp = inv_word_shift(tmp, C);   
-    for(size_t R = 0; R < Nb; R++)
-    {
-        block[C + 4*R] = ( uint8_t )( tmp >> 8*R );
-    }     
-  }
-  return;
+  return ( uint32_t )( inv_s_box[uAES_COL_BYTE0(c0)] | inv_s_box[uAES_COL_BYTE1(c1)] << 8 | inv_s_box[uAES_COL_BYTE2(c2)] << 16 | ( uint32_t )( inv_s_box[uAES_COL_BYTE3(c3)] ) << 24 );
 }
 
+#ifdef __uAES_PROFILE__
 /**
- * @brief       Computes the mix-columns operation on given data block.
- * @param block Pointer to the first element from the data block array.
- * @param Nb    Number of 32-bit words present on data block array. 
+ * @brief           Computes shift-rows alone for one output column, profiling builds time it
+ *                  apart from sub-bytes. Row r of the column comes from argument r.
+ * @param c0        Supplies row 0.
+ * @param c1        Supplies row 1.
+ * @param c2        Supplies row 2.
+ * @param c3        Supplies row 3.
+ * @return uint32_t Output column.
  */
-void mix_columns(uint8_t *block, size_t Nb)
+static inline uint32_t shift_col(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-  uint8_t  idx = 0;
-  uint8_t  tmp[uAES_MAX_BLOCK_LEN] = {0};
+  return ( c0 & 0x000000FFU ) | ( c1 & 0x0000FF00U ) | ( c2 & 0x00FF0000U ) | ( c3 & 0xFF000000U );
+}
 
-  memcpy(tmp, block, 4*Nb);
+/**
+ * @brief           Computes sub-bytes alone on a packed column.
+ * @param col       Packed column.
+ * @return uint32_t Substituted column.
+ */
+static inline uint32_t sub_col(uint32_t col)
+{
+  return sub_shift(col, col, col, col);
+}
 
-  while(idx < Nb)
-  {
-    block[4*idx + 0] = gf256_mul(0x02, tmp[4*idx]) ^ gf256_mul(0x03, tmp[4*idx + 1]) ^ tmp[4*idx + 2] ^ tmp[4*idx + 3];
-    block[4*idx + 1] = tmp[4*idx] ^ gf256_mul(0x02, tmp[4*idx + 1]) ^ gf256_mul(0x03, tmp[4*idx + 2]) ^ tmp[4*idx + 3];
-    block[4*idx + 2] = tmp[4*idx] ^ tmp[4*idx + 1] ^ gf256_mul(0x02, tmp[4*idx + 2]) ^ gf256_mul(0x03, tmp[4*idx + 3]);
-    block[4*idx + 3] = gf256_mul(0x03, tmp[4*idx]) ^ tmp[4*idx + 1] ^ tmp[4*idx + 2] ^ gf256_mul(0x02, tmp[4*idx + 3]); 
-    idx++;
-  }    
-  return;
+/**
+ * @brief           Computes inverse sub-bytes alone on a packed column.
+ * @param col       Packed column.
+ * @return uint32_t Substituted column.
+ */
+static inline uint32_t inv_sub_col(uint32_t col)
+{
+  return inv_sub_shift(col, col, col, col);
+}
+#endif /*__uAES_PROFILE__*/
+
+/**
+ * @brief           Multiplies the four bytes of a column by {02} at once.
+ * @param col       Packed column.
+ * @return uint32_t Packed product.
+ */
+static inline uint32_t xtime_col(uint32_t col)
+{
+  return ( ( col & 0x7F7F7F7FU ) << 1 ) ^ ( ( ( col >> 7 ) & 0x01010101U ) * 0x1BU );
+}
+
+/**
+ * @brief           Computes the mix-columns operation on a packed column. With r(x) the
+ *                  column rotated by one row, out = {02}(x ^ r(x)) ^ r(x) ^ r^2(x) ^ r^3(x).
+ * @param col       Packed column.
+ * @return uint32_t Mixed column.
+ */
+static inline uint32_t mix_column(uint32_t col)
+{
+  uint32_t r1 = uAES_COL_ROT(col, 8);
+
+  return xtime_col(col ^ r1) ^ r1 ^ uAES_COL_ROT(col, 16) ^ uAES_COL_ROT(col, 24);
 }
 
 /**
- * @brief       Computes the inverse mix-columns operation on given data block.
- * @param block Pointer to the first element from the data block array.
- * @param Nb    Number of 32-bit words present on data block array. 
+ * @brief           Computes the inverse mix-columns operation on a packed column. The inverse
+ *                  matrix {0e,0b,0d,09} is factored as {02,03,01,01} x {05,00,04,00}, so the
+ *                  column is pre-multiplied by {05,00,04,00} and handed to mix_column.
+ * @param col       Packed column.
+ * @return uint32_t Mixed column.
  */
-void inv_mix_columns(uint8_t *block, size_t Nb)
+static inline uint32_t inv_mix_column(uint32_t col)
 {
-  uint8_t idx = 0;
-  uint8_t tmp[uAES_MAX_BLOCK_LEN] = {0};
+  uint32_t pre = xtime_col(xtime_col(col ^ uAES_COL_ROT(col, 16)));
 
-  memcpy(tmp, block, 4*Nb);
+  return mix_column(col ^ pre);
+}
 
-  while( idx < Nb )
+/**
+ * @brief           Converts an expanded key schedule into the equivalent inverse cipher key
+ *                  schedule, applying inverse mix-columns to the round keys 1 to Nr - 1.
+ * @param keysched  Pointer to the first element of key schedule array.
+ * @param Nb        Number of 32-bit words present on data block array.
+ * @param Nr        Number of rounds.
+ */
+void inv_key_schedule(uint32_t *keysched, size_t Nb, size_t Nr)
+{
+  for(size_t idx = Nb; idx < Nb * Nr; idx++)
   {
-    block[4*idx + 0] =  gf256_mul(0x0e, tmp[4*idx]) ^ gf256_mul(0x0b, tmp[4*idx + 1]) ^ gf256_mul(0x0d, tmp[4*idx + 2]) ^ gf256_mul(0x09, tmp[4*idx + 3]);
-    block[4*idx + 1] =  gf256_mul(0x09, tmp[4*idx]) ^ gf256_mul(0x0e, tmp[4*idx + 1]) ^ gf256_mul(0x0b, tmp[4*idx + 2]) ^ gf256_mul(0x0d, tmp[4*idx + 3]);
-    block[4*idx + 2] =  gf256_mul(0x0d, tmp[4*idx]) ^ gf256_mul(0x09, tmp[4*idx + 1]) ^ gf256_mul(0x0e, tmp[4*idx + 2]) ^ gf256_mul(0x0b, tmp[4*idx + 3]);
-    block[4*idx + 3] =  gf256_mul(0x0b, tmp[4*idx]) ^ gf256_mul(0x0d, tmp[4*idx + 1]) ^ gf256_mul(0x09, tmp[4*idx + 2]) ^ gf256_mul(0x0e, tmp[4*idx + 3]);
-    idx++;
-  }    
+    keysched[idx] = inv_mix_column(keysched[idx]);
+  }
   return;
 }
 
@@ -338,7 +426,7 @@ void key_expansion(uint8_t *key, uint32_t *keysched, size_t Nk, size_t Ns)
           uAES_TRACE(uAES_TRACE_MSK_KEXP, "keyexp.after rotword = %.8x", tmp);
           tmp = sub_word(tmp);
           uAES_TRACE(uAES_TRACE_MSK_KEXP, "keyexp.after sub-word = %.8x", tmp);
-          tmp ^= rcon(idx/Nk);
+          tmp ^= rcon[idx/Nk];
           uAES_TRACE(uAES_TRACE_MSK_KEXP, "keyexp.after XOR with rcon = %.8x", tmp);
       }
       else if ( ( Nk > 6 ) && ( idx % Nk == 4 ) )
@@ -355,25 +443,263 @@ void key_expansion(uint8_t *key, uint32_t *keysched, size_t Nk, size_t Ns)
 }
 
 /**
- * @brief           Computes round key addition on given data block.
- * @param block     Pointer to the first element from the data block array.
- * @param keysched  Pointer to the first element from the key schedule array
- * @param round     Correspondent encryption/decryption round.
- * @param Nb        Number of 32-bit words present on data block array.
+ * @brief Round steps shared by the rolled and unrolled ciphers. Columns a0..a3 hold the state
+ *        entering the round, b0..b3 receive the state leaving it, n is the round number and
+ *        selects the round key in kschd.
+ */
+#define OPS_FWD_ADD(buf)                                                                \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].block = ", buf, 0UL);              \
+  s0 = col_load(&buf[0])  ^ kschd[0];                                                   \
+  s1 = col_load(&buf[4])  ^ kschd[1];                                                   \
+  s2 = col_load(&buf[8])  ^ kschd[2];                                                   \
+  s3 = col_load(&buf[12]) ^ kschd[3];
+
+#define OPS_FWD_ROUND(a, b, n)                                                          \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_FWD, "round[%lu].start = ", a, n);                  \
+  b##0 = mix_column(sub_shift(a##0, a##1, a##2, a##3)) ^ kschd[4 * ( n ) + 0];          \
+  b##1 = mix_column(sub_shift(a##1, a##2, a##3, a##0)) ^ kschd[4 * ( n ) + 1];          \
+  b##2 = mix_column(sub_shift(a##2, a##3, a##0, a##1)) ^ kschd[4 * ( n ) + 2];          \
+  b##3 = mix_column(sub_shift(a##3, a##0, a##1, a##2)) ^ kschd[4 * ( n ) + 3];
+
+#define OPS_FWD_FINAL(a, buf, n)                                                        \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_FWD, "round[%lu].start = ", a, n);                  \
+  col_store(&buf[0],  sub_shift(a##0, a##1, a##2, a##3) ^ kschd[4 * ( n ) + 0]);        \
+  col_store(&buf[4],  sub_shift(a##1, a##2, a##3, a##0) ^ kschd[4 * ( n ) + 1]);        \
+  col_store(&buf[8],  sub_shift(a##2, a##3, a##0, a##1) ^ kschd[4 * ( n ) + 2]);        \
+  col_store(&buf[12], sub_shift(a##3, a##0, a##1, a##2) ^ kschd[4 * ( n ) + 3]);        \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].end = ", buf, ( size_t )( n ));
+
+#define OPS_INV_ADD(buf, n)                                                             \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].block = ", buf, ( size_t )( n ));  \
+  s0 = col_load(&buf[0])  ^ kschd[4 * ( n ) + 0];                                       \
+  s1 = col_load(&buf[4])  ^ kschd[4 * ( n ) + 1];                                       \
+  s2 = col_load(&buf[8])  ^ kschd[4 * ( n ) + 2];                                       \
+  s3 = col_load(&buf[12]) ^ kschd[4 * ( n ) + 3];
+
+#define OPS_INV_ROUND(a, b, n)                                                          \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_INV, "round[%lu].start = ", a, n);                  \
+  b##0 = inv_mix_column(inv_sub_shift(a##0, a##3, a##2, a##1)) ^ kschd[4 * ( n ) + 0];  \
+  b##1 = inv_mix_column(inv_sub_shift(a##1, a##0, a##3, a##2)) ^ kschd[4 * ( n ) + 1];  \
+  b##2 = inv_mix_column(inv_sub_shift(a##2, a##1, a##0, a##3)) ^ kschd[4 * ( n ) + 2];  \
+  b##3 = inv_mix_column(inv_sub_shift(a##3, a##2, a##1, a##0)) ^ kschd[4 * ( n ) + 3];
+
+#define OPS_INV_FINAL(a, buf)                                                           \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_INV, "round[%lu].start = ", a, 0UL);                \
+  col_store(&buf[0],  inv_sub_shift(a##0, a##3, a##2, a##1) ^ kschd[0]);                \
+  col_store(&buf[4],  inv_sub_shift(a##1, a##0, a##3, a##2) ^ kschd[1]);                \
+  col_store(&buf[8],  inv_sub_shift(a##2, a##1, a##0, a##3) ^ kschd[2]);                \
+  col_store(&buf[12], inv_sub_shift(a##3, a##2, a##1, a##0) ^ kschd[3]);                \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].end = ", buf, 0UL);
+
+#ifdef __uAES_PROFILE__
+/**
+ * @brief Profiling builds replace the round steps above with ones that compute ShiftRows,
+ *        SubBytes, MixColumns and AddRoundKey one after the other and charge each of them to
+ *        its phase. The columns of a phase are pinned before its lap so that the compiler does
+ *        not move work across phases.
+ */
+#define OPS_PROF_LAP(v, phase)                                                          \
+  uAES_PROF_KEEP(v##0);                                                                 \
+  uAES_PROF_KEEP(v##1);                                                                 \
+  uAES_PROF_KEEP(v##2);                                                                 \
+  uAES_PROF_KEEP(v##3);                                                                 \
+  uAES_PROF_LAP(prof, phase);
+
+#undef OPS_FWD_ADD
+#undef OPS_FWD_ROUND
+#undef OPS_FWD_FINAL
+#undef OPS_INV_ADD
+#undef OPS_INV_ROUND
+#undef OPS_INV_FINAL
+
+#define OPS_FWD_ADD(buf)                                                                \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].block = ", buf, 0UL);              \
+  uAES_PROF_START(prof);                                                                \
+  s0 = col_load(&buf[0])  ^ kschd[0];                                                   \
+  s1 = col_load(&buf[4])  ^ kschd[1];                                                   \
+  s2 = col_load(&buf[8])  ^ kschd[2];                                                   \
+  s3 = col_load(&buf[12]) ^ kschd[3];                                                   \
+  OPS_PROF_LAP(s, uAES_PROF_ADD)
+
+#define OPS_FWD_STEPS(a, b)                                                             \
+  b##0 = shift_col(a##0, a##1, a##2, a##3);                                             \
+  b##1 = shift_col(a##1, a##2, a##3, a##0);                                             \
+  b##2 = shift_col(a##2, a##3, a##0, a##1);                                             \
+  b##3 = shift_col(a##3, a##0, a##1, a##2);                                             \
+  OPS_PROF_LAP(b, uAES_PROF_SHIFT)                                                      \
+  b##0 = sub_col(b##0);                                                                 \
+  b##1 = sub_col(b##1);                                                                 \
+  b##2 = sub_col(b##2);                                                                 \
+  b##3 = sub_col(b##3);                                                                 \
+  OPS_PROF_LAP(b, uAES_PROF_SUB)
+
+#define OPS_INV_STEPS(a, b)                                                             \
+  b##0 = shift_col(a##0, a##3, a##2, a##1);                                             \
+  b##1 = shift_col(a##1, a##0, a##3, a##2);                                             \
+  b##2 = shift_col(a##2, a##1, a##0, a##3);                                             \
+  b##3 = shift_col(a##3, a##2, a##1, a##0);                                             \
+  OPS_PROF_LAP(b, uAES_PROF_SHIFT)                                                      \
+  b##0 = inv_sub_col(b##0);                                                             \
+  b##1 = inv_sub_col(b##1);                                                             \
+  b##2 = inv_sub_col(b##2);                                                             \
+  b##3 = inv_sub_col(b##3);                                                             \
+  OPS_PROF_LAP(b, uAES_PROF_SUB)
+
+#define OPS_PROF_ADD(b, n)                                                              \
+  b##0 ^= kschd[4 * ( n ) + 0];                                                         \
+  b##1 ^= kschd[4 * ( n ) + 1];                                                         \
+  b##2 ^= kschd[4 * ( n ) + 2];                                                         \
+  b##3 ^= kschd[4 * ( n ) + 3];                                                         \
+  OPS_PROF_LAP(b, uAES_PROF_ADD)
+
+#define OPS_FWD_ROUND(a, b, n)                                                          \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_FWD, "round[%lu].start = ", a, n);                  \
+  OPS_FWD_STEPS(a, b)                                                                   \
+  b##0 = mix_column(b##0);                                                              \
+  b##1 = mix_column(b##1);                                                              \
+  b##2 = mix_column(b##2);                                                              \
+  b##3 = mix_column(b##3);                                                              \
+  OPS_PROF_LAP(b, uAES_PROF_MIX)                                                        \
+  OPS_PROF_ADD(b, n)
+
+#define OPS_FWD_FINAL(a, buf, n)                                                        \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_FWD, "round[%lu].start = ", a, n);                  \
+  uint32_t a##_f0, a##_f1, a##_f2, a##_f3;                                              \
+  OPS_FWD_STEPS(a, a##_f)                                                               \
+  OPS_PROF_ADD(a##_f, n)                                                                \
+  col_store(&buf[0],  a##_f0);                                                          \
+  col_store(&buf[4],  a##_f1);                                                          \
+  col_store(&buf[8],  a##_f2);                                                          \
+  col_store(&buf[12], a##_f3);                                                          \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].end = ", buf, ( size_t )( n ));
+
+#define OPS_INV_ADD(buf, n)                                                             \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].block = ", buf, ( size_t )( n ));  \
+  uAES_PROF_START(prof);                                                                \
+  s0 = col_load(&buf[0])  ^ kschd[4 * ( n ) + 0];                                       \
+  s1 = col_load(&buf[4])  ^ kschd[4 * ( n ) + 1];                                       \
+  s2 = col_load(&buf[8])  ^ kschd[4 * ( n ) + 2];                                       \
+  s3 = col_load(&buf[12]) ^ kschd[4 * ( n ) + 3];                                       \
+  OPS_PROF_LAP(s, uAES_PROF_ADD)
+
+#define OPS_INV_ROUND(a, b, n)                                                          \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_INV, "round[%lu].start = ", a, n);                  \
+  OPS_INV_STEPS(a, b)                                                                   \
+  b##0 = inv_mix_column(b##0);                                                          \
+  b##1 = inv_mix_column(b##1);                                                          \
+  b##2 = inv_mix_column(b##2);                                                          \
+  b##3 = inv_mix_column(b##3);                                                          \
+  OPS_PROF_LAP(b, uAES_PROF_MIX)                                                        \
+  OPS_PROF_ADD(b, n)
+
+#define OPS_INV_FINAL(a, buf)                                                           \
+  uAES_TRACE_STATE(uAES_TRACE_MSK_INV, "round[%lu].start = ", a, 0UL);                \
+  uint32_t a##_f0, a##_f1, a##_f2, a##_f3;                                              \
+  OPS_INV_STEPS(a, a##_f)                                                               \
+  OPS_PROF_ADD(a##_f, 0)                                                                \
+  col_store(&buf[0],  a##_f0);                                                          \
+  col_store(&buf[4],  a##_f1);                                                          \
+  col_store(&buf[8],  a##_f2);                                                          \
+  col_store(&buf[12], a##_f3);                                                          \
+  uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].end = ", buf, 0UL);
+#endif /*__uAES_PROFILE__*/
+
+#ifdef __uAES_NO_UNROLL__
+/**
+ * @brief       Computes foward cipher encryption on a single block. The state is held in four
+ *              packed columns from load to store and round keys are added a word at a time.
+ * @param buf   Pointer to data block.
+ * @param kschd Pointer to key schedule buffer generated by key expansion algorithm.
+ * @param Nr    Number of rounds.
+ */
+static void foward_cipher(uint8_t *buf, const uint32_t *kschd, size_t Nr)
+{
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+
+  OPS_FWD_ADD(buf)
+  for(size_t round = 1; round < Nr; round++)
+  {
+    OPS_FWD_ROUND(s, t, round)
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+  OPS_FWD_FINAL(s, buf, Nr)
+  return;
+}
+
+/**
+ * @brief       Computes equivalent inverse cipher decryption on a single block, the round
+ *              structure mirrors foward_cipher.
+ * @param buf   Pointer to data block.
+ * @param kschd Pointer to key schedule buffer converted by inv_key_schedule().
+ * @param Nr    Number of rounds.
  */
-void add_round_key(uint8_t *block, uint32_t *keysched, size_t round, size_t Nb)
+static void inverse_cipher(uint8_t *buf, const uint32_t *kschd, size_t Nr)
 {
-  uint8_t keyidx = round * Nb;
-  uint32_t tmp = 0;   
-  for(size_t C = 0; C < Nb; C++)
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+
+  OPS_INV_ADD(buf, Nr)
+  for(size_t round = Nr - 1; round > 0; round--)
   {
-    tmp = (uint32_t)( block[4*C] | block[4*C + 1] << 8 | block[4*C + 2] << 16 | block[4*C + 3] << 24 );
-    tmp ^= keysched[keyidx];
-    for (size_t R = 0; R < Nb; R++)
-    {
-      block[4*C + R] = ( uint8_t )( tmp >> 8 * R );
-    }
-    keyidx++;
+    OPS_INV_ROUND(s, t, round)
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
   }
+  OPS_INV_FINAL(s, buf)
   return;
 }
+
+#define OPS_FOWARD_CIPHER(bits, Nr)                                                     \
+void foward_cipher_##bits(uint8_t *buf, const uint32_t *kschd)                          \
+{                                                                                       \
+  foward_cipher(buf, kschd, Nr);                                                        \
+  return;                                                                               \
+}
+
+#define OPS_INVERSE_CIPHER(bits, Nr)                                                    \
+void inverse_cipher_##bits(uint8_t *buf, const uint32_t *kschd)                         \
+{                                                                                       \
+  inverse_cipher(buf, kschd, Nr);                                                       \
+  return;                                                                               \
+}
+#else
+#define OPS_FOWARD_CIPHER(bits, Nr)                                                     \
+void foward_cipher_##bits(uint8_t *buf, const uint32_t *kschd)                          \
+{                                                                                       \
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;                                              \
+                                                                                        \
+  OPS_FWD_ADD(buf)                                                                      \
+  uAES_FWD_ROUNDS_##Nr(OPS_FWD_ROUND)                                                   \
+  OPS_FWD_FINAL(t, buf, Nr)                                                             \
+  return;                                                                               \
+}
+
+#define OPS_INVERSE_CIPHER(bits, Nr)                                                    \
+void inverse_cipher_##bits(uint8_t *buf, const uint32_t *kschd)                         \
+{                                                                                       \
+  uint32_t s0, s1, s2, s3, t0, t1, t2, t3;                                              \
+                                                                                        \
+  OPS_INV_ADD(buf, Nr)                                                                  \
+  uAES_INV_ROUNDS_##Nr(OPS_INV_ROUND)                                                   \
+  OPS_INV_FINAL(t, buf)                                                                 \
+  return;                                                                               \
+}
+#endif /*__uAES_NO_UNROLL__*/
+
+/**
+ * @brief Foward and equivalent inverse ciphers on a single block, one per key length, with
+ *        the number of rounds fixed at compile time. Unless __uAES_NO_UNROLL__ is defined
+ *        every round is unrolled and the state stays in the eight column words.
+ *        buf is the data block and kschd the key schedule, converted by inv_key_schedule()
+ *        for the inverse ciphers.
+ */
+OPS_FOWARD_CIPHER(128, 10)
+OPS_FOWARD_CIPHER(192, 12)
+OPS_FOWARD_CIPHER(256, 14)
+OPS_INVERSE_CIPHER(128, 10)
+OPS_INVERSE_CIPHER(192, 12)
+OPS_INVERSE_CIPHER(256, 14)
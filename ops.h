@@ -27,13 +27,45 @@
 #ifndef OPS_H
 #define OPS_H
 
-extern void sub_block(uint8_t* block, size_t Nb);
-extern void inv_sub_block(uint8_t* block, size_t Nb);
-extern void shift_rows(uint8_t* block, size_t Nb);
-extern void inv_shift_rows(uint8_t* block, size_t Nb);
-extern void mix_columns(uint8_t* block, size_t Nb);
-extern void inv_mix_columns(uint8_t* block, size_t Nb);
+#ifdef __uAES_RUNTIME_TABLES__
+#define uAES_TABLE_CONST
+#else
+#define uAES_TABLE_CONST const
+#endif /*__uAES_RUNTIME_TABLES__*/
+
+extern uAES_TABLE_CONST uint8_t s_box[256];
+extern uAES_TABLE_CONST uint8_t inv_s_box[256];
+
+/**
+ * @brief Builds optimised for size keep the rolled round loops.
+ */
+#if defined(__OPTIMIZE_SIZE__) && !defined(__uAES_NO_UNROLL__)
+#define __uAES_NO_UNROLL__
+#endif /*__OPTIMIZE_SIZE__*/
+
+/**
+ * @brief Unrolled middle rounds of each key length. R(in, out, round) computes the state
+ *        columns out0..out3 from in0..in3 with the round key of the given round. Every key
+ *        length has an odd number of middle rounds, so every sequence starts in the s
+ *        columns and ends in the t columns.
+ */
+#define uAES_FWD_ROUNDS_10(R) \
+  R(s, t, 1) R(t, s, 2) R(s, t, 3) R(t, s, 4) R(s, t, 5) R(t, s, 6) R(s, t, 7) R(t, s, 8) R(s, t, 9)
+#define uAES_FWD_ROUNDS_12(R) uAES_FWD_ROUNDS_10(R) R(t, s, 10) R(s, t, 11)
+#define uAES_FWD_ROUNDS_14(R) uAES_FWD_ROUNDS_12(R) R(t, s, 12) R(s, t, 13)
+#define uAES_INV_ROUNDS_10(R) \
+  R(s, t, 9) R(t, s, 8) R(s, t, 7) R(t, s, 6) R(s, t, 5) R(t, s, 4) R(s, t, 3) R(t, s, 2) R(s, t, 1)
+#define uAES_INV_ROUNDS_12(R) R(s, t, 11) R(t, s, 10) uAES_INV_ROUNDS_10(R)
+#define uAES_INV_ROUNDS_14(R) R(s, t, 13) R(t, s, 12) uAES_INV_ROUNDS_12(R)
+
+extern void uaes_tables_init(void);
+extern void inv_key_schedule(uint32_t* keysched, size_t Nb, size_t Nr);
 extern void key_expansion(uint8_t* key, uint32_t* keysched, size_t Nk, size_t Ns);
-extern void add_round_key(uint8_t* block, uint32_t* keysched, size_t round, size_t Nb);
+extern void foward_cipher_128(uint8_t* buf, const uint32_t* kschd);
+extern void foward_cipher_192(uint8_t* buf, const uint32_t* kschd);
+extern void foward_cipher_256(uint8_t* buf, const uint32_t* kschd);
+extern void inverse_cipher_128(uint8_t* buf, const uint32_t* kschd);
+extern void inverse_cipher_192(uint8_t* buf, const uint32_t* kschd);
+extern void inverse_cipher_256(uint8_t* buf, const uint32_t* kschd);
 
 #endif /*OPS_H*/
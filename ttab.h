@@ -0,0 +1,41 @@
+/**
+ * @file      ttab.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for the T-table cipher engine.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef TTAB_H
+#define TTAB_H
+
+#ifdef __uAES_TTABLE__
+extern void ttab_tables_init(void);
+extern void ttab_inv_key_schedule(uint32_t* kschd, size_t Nr);
+extern void ttab_foward_cipher_128(uint8_t* buf, const uint32_t* kschd);
+extern void ttab_foward_cipher_192(uint8_t* buf, const uint32_t* kschd);
+extern void ttab_foward_cipher_256(uint8_t* buf, const uint32_t* kschd);
+extern void ttab_inverse_cipher_128(uint8_t* buf, const uint32_t* kschd);
+extern void ttab_inverse_cipher_192(uint8_t* buf, const uint32_t* kschd);
+extern void ttab_inverse_cipher_256(uint8_t* buf, const uint32_t* kschd);
+#endif /*__uAES_TTABLE__*/
+
+#endif /*TTAB_H*/
@@ -31,20 +31,188 @@
 
 #include "uaes.h"
 #include "ops.h"
+#include "ttab.h"
+#include "aesni.h"
+#include "bslice.h"
+#include "mthread.h"
+#include "ghash.h"
+#include "kcache.h"
 
-#define uAES128_KSCHD_SIZE    ( 44UL )
-#define uAES192_KSCHD_SIZE    ( 52UL )
-#define uAES256_KSCHD_SIZE    ( 60UL )
-#define uAES_MAX_KSCHD_SIZE   ( uAES256_KSCHD_SIZE )
+#if defined(__uAES_TTABLE__) && defined(__uAES_BSLICE__)
+#error "__uAES_TTABLE__ and __uAES_BSLICE__ select different engines, define only one of them."
+#endif
+
+/**
+ * @brief Key schedules to be computed by uaes_ctx_expand.
+ */
+#define uAES_CTX_ENC    ( 0x01U )
+#define uAES_CTX_DEC    ( 0x02U )
+
+/**
+ * @brief XTS blocks per run, the tweaks of a run are doubled together and the run goes through
+ *        the multi-block engines in one call. IEEE 1619 limits a data unit to 2^20 blocks.
+ */
+#define uAES_XTS_BLOCKS         ( 32UL )
+#define uAES_XTS_MAX_UNIT       ( 16UL * MB )
+
+/**
+ * @brief Counter blocks encrypted per keystream batch, matches the widest block engine.
+ */
+#ifdef __uAES_BSLICE__
+#define uAES_CTR_BLOCKS ( uAES_BSLICE_BLOCKS )
+#else
+#define uAES_CTR_BLOCKS ( 8UL )
+#endif /*__uAES_BSLICE__*/
+
+/**
+ * @brief Messages advanced in lock-step by multi-buffer CBC encryption.
+ */
+#define uAES_MB_LANES   ( 8UL )
+
+/**
+ * @brief Streaming modes.
+ */
+#define uAES_STREAM_ECB_ENC     ( 0x00U )
+#define uAES_STREAM_ECB_DEC     ( 0x01U )
+#define uAES_STREAM_CBC_ENC     ( 0x02U )
+#define uAES_STREAM_CBC_DEC     ( 0x03U )
+#define uAES_STREAM_DONE        ( 0x04U )
+
+/**
+ * @brief Bytes moved to the destination and processed there at a time by the out-of-place and
+ *        scatter-gather functions, small enough to stay in the L1 cache between both steps.
+ */
+#define uAES_SG_BATCH           ( 4UL * KB )
+
+/**
+ * @brief AES-GCM message phases, counter width and limits from NIST SP 800-38D.
+ */
+#define uAES_GCM_AAD            ( 0x00U )
+#define uAES_GCM_MSG            ( 0x01U )
+#define uAES_GCM_DONE           ( 0x02U )
+#define uAES_GCM_CTR_SIZE       ( 4UL )
+#define uAES_GCM_MIN_TAG_SIZE   ( 4UL )
+#define uAES_GCM_MAX_MSG_SIZE   ( (1ULL << 36) - 32ULL )
+#define uAES_GCM_MAX_AAD_SIZE   ( (1ULL << 61) - 1ULL )
+
+/**
+ * @brief AES-CMAC message phases, subkey reduction constant and shortest tag from
+ *        NIST SP 800-38B.
+ */
+#define uAES_CMAC_MSG           ( 0x00U )
+#define uAES_CMAC_DONE          ( 0x01U )
+#define uAES_CMAC_RB            ( 0x87U )
+#define uAES_CMAC_MIN_TAG_SIZE  ( 8UL )
+
+#ifdef __uAES_PTHREAD__
+/**
+ * @brief Multi-threaded job operations and chunking.
+ */
+#define uAES_MT_ECB_ENC         ( 0x00U )
+#define uAES_MT_ECB_DEC         ( 0x01U )
+#define uAES_MT_CBC_DEC         ( 0x02U )
+#define uAES_MT_CHUNK_BLOCKS    ( uAES_MT_CHUNK_SIZE / uAES_BLOCK_SIZE )
+#define uAES_MT_MAX_CHUNKS      ( (uAES_MAX_INPUT_SIZE + uAES_MT_CHUNK_SIZE - 1UL) / uAES_MT_CHUNK_SIZE )
+
+typedef struct uaes_mt_job
+{
+        uaes_ctx_t      *ctx;
+        uint8_t         *buf;
+        size_t          nblocks;
+        unsigned int    op;
+        uint8_t         (*ivs)[uAES_BLOCK_SIZE];
+}uaes_mt_job_t;
+
+typedef struct uaes_mt_xts
+{
+        uaes_xts_t      *xts;
+        uint8_t         *buf;
+        size_t          sector_size;
+        size_t          nsectors;
+        size_t          per_chunk;
+        uint64_t        sector;
+        int             decrypt;
+}uaes_mt_xts_t;
+
+static size_t mt_threshold = uAES_MT_THRESHOLD;
+#endif /*__uAES_PTHREAD__*/
+
+/**
+ * @brief Key schedules of the one-shot functions, see uAES_SCRATCH in uaes_config.h.
+ */
+#if (uAES_SCRATCH == uAES_SCRATCH_STATIC)
+static uaes_ctx_t scratch_ctx;
+#define uAES_SCRATCH_CTX(name)  uaes_ctx_t *name = &scratch_ctx
+#elif (uAES_SCRATCH == uAES_SCRATCH_CALLER)
+static uaes_ctx_t *scratch_ctx = NULL;
+#define uAES_SCRATCH_CTX(name)  uaes_ctx_t *name = scratch_ctx
+#else
+#define uAES_SCRATCH_CTX(name)  uaes_ctx_t name##_mem; uaes_ctx_t *name = &name##_mem
+#endif /*uAES_SCRATCH*/
+
+/**
+ * @brief Single block cipher specialised for one key length, see uaes_foward_cipher().
+ */
+typedef void (*uaes_cipher_t)(uint8_t *buf, const uint32_t *kschd);
+
+#ifdef __uAES_TTABLE__
+#define uAES_CIPHER(name)       ttab_##name
+#else
+#define uAES_CIPHER(name)       name
+#endif /*__uAES_TTABLE__*/
 
 uint8_t trace_msk = 0x00;
-static uint8_t input_buffer[uAES_MAX_INPUT_SIZE] = { 0 };
-static uint8_t key_buffer[uAES_MAX_KEY_SIZE] = { 0 };
 
-static size_t uaes_strnlen(char *str, size_t lim);
 static void   uaes_xor_iv(void *block, void *iv);
-static void   uaes_foward_cipher(uint8_t *buf, uint32_t *kschd, size_t Nk, size_t Nb, size_t Nr);
-static void   uaes_inverse_cipher(uint8_t *buf, uint32_t *kschd, size_t Nk, size_t Nb, size_t Nr);
+static void   uaes_memzero(void *ptr, size_t size);
+static int    uaes_memeq(const uint8_t *a, const uint8_t *b, size_t size);
+static void   uaes_ctx_expand(uaes_ctx_t *ctx, uint8_t *key, aes_length_t aes_length, unsigned int dirs);
+static void   uaes_ctx_load(uaes_ctx_t *ctx, uint8_t *key, aes_length_t aes_length, unsigned int dirs);
+static uaes_cipher_t uaes_foward_cipher(const uaes_ctx_t *ctx);
+static uaes_cipher_t uaes_inverse_cipher(const uaes_ctx_t *ctx);
+static void   uaes_ecb_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks);
+static void   uaes_ecb_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks);
+static void   uaes_cbc_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv);
+static void   uaes_cbc_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv);
+static void   uaes_mb_encrypt(uaes_ctx_t **ctx, uint8_t **buf, uint8_t *state, size_t nlanes, size_t nblocks);
+static void   uaes_mb_cbc(uaes_cbc_job_t *jobs, size_t njobs, size_t Nr);
+static void   uaes_ctr_increment(uint8_t *ctr, size_t ctr_size);
+static void   uaes_xor_stream(uint8_t *buf, uint8_t *stream, size_t size);
+#ifdef __uAES_PTHREAD__
+static void   uaes_mt_chunk(void *arg, size_t chunk);
+static void   uaes_mt_run(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, unsigned int op, uint8_t *iv);
+static void   uaes_mt_xts_chunk(void *arg, size_t chunk);
+static void   uaes_mt_xts_run(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors, int decrypt);
+#endif /*__uAES_PTHREAD__*/
+static void   uaes_ctr_stream(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *ctr, size_t ctr_size);
+static void   uaes_pcbc_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv);
+static void   uaes_pcbc_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv);
+static void   uaes_cfb_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv);
+static void   uaes_cfb_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv);
+static void   uaes_ofb_stream(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv, int keystream);
+static int    uaes_stream_init(uaes_stream_t *stream, uaes_ctx_t *ctx, uint8_t *iv, unsigned int mode);
+static void   uaes_stream_blocks(uaes_stream_t *stream, uint8_t *buf, size_t nblocks);
+static size_t uaes_iov_total(const uaes_iovec_t *iov, size_t cnt);
+static void   uaes_iov_copy(const uaes_iovec_t *iov, size_t *idx, size_t *off, uint8_t *block, int gather);
+static int    uaes_sg_xcrypt(uaes_ctx_t *ctx, const uaes_iovec_t *src, size_t src_cnt, const uaes_iovec_t *dst, size_t dst_cnt, uint8_t *iv, unsigned int mode);
+static void   uaes_store64(uint8_t *dst, uint64_t val);
+static void   uaes_gcm_absorb(uaes_gcm_t *gcm, uint8_t *data, size_t size);
+static void   uaes_gcm_flush(uaes_gcm_t *gcm, uint64_t total);
+static void   uaes_gcm_stream(uaes_gcm_t *gcm, uint8_t *buf, size_t size, int decrypt);
+static void   uaes_gcm_tag(uaes_gcm_t *gcm, uint8_t *tag);
+static void   uaes_xts_load(const uint8_t *src, uint64_t *t);
+static void   uaes_xts_store(uint8_t *dst, const uint64_t *t);
+static inline void uaes_xts_double(uint64_t *t);
+static void   uaes_xts_run(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint64_t *t, int decrypt);
+static void   uaes_xts_unit(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint64_t *t, int decrypt);
+static void   uaes_xts_sectors(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors, int decrypt);
+static int    uaes_xts_valid(uaes_xts_t *xts, uint8_t *buf, size_t sector_size, size_t nsectors);
+static void   uaes_cmac_double(uint8_t *out, const uint8_t *in);
+static void   uaes_cmac_blocks(uaes_ctx_t *ctx, uint8_t *x, uint8_t *data, size_t nblocks);
+static void   uaes_cmac_last(const uaes_cmac_t *cmac, uint8_t *last, const uint8_t *data, size_t size);
+static void   uaes_cmac_tag(uaes_cmac_t *cmac, uint8_t *tag);
+static void   uaes_mb_mac(uaes_ctx_t **ctx, uint8_t **buf, uint8_t *state, size_t nlanes, size_t nblocks);
+static void   uaes_mb_cmac(uaes_cmac_job_t *jobs, size_t njobs, size_t Nr);
 
 /**
  * @brief Sets trace mask for debugging.
@@ -59,119 +227,3586 @@ uint8_t uaes_set_trace_msk(unsigned char msk)
         trace_msk |= msk;
         return trace_msk;
 }
-#else
+#else
+
+uint8_t uaes_set_trace_msk(unsigned char msk)
+{
+        return 0;
+}
+#endif /*__uAES_DEBUG__*/
+
+#if defined(__uAES_DEBUG__) && defined(__uAES_TRACE_RING__)
+/**
+ * @brief Saves the trace rings of every thread, render the file with uaes_tests/tdecode.c.
+ * @param path    File path.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+int uaes_trace_save(const char *path)
+{
+        int err = -1;
+
+        if(NULL != path)
+        {
+                err = udbg_save(path);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Drops the trace records of the calling thread and restarts its dbg[] line count.
+ */
+void uaes_trace_reset(void)
+{
+        udbg_reset();
+        return;
+}
+#endif /*__uAES_DEBUG__ && __uAES_TRACE_RING__*/
+
+#if (uAES_SCRATCH == uAES_SCRATCH_CALLER)
+/**
+ * @brief Hands over the context used by the one-shot functions to expand their keys, it is
+ *        cleared after every call.
+ * @param scratch Pointer to scratch context, owned by the caller.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+int uaes_set_scratch(uaes_ctx_t *scratch)
+{
+        int err = -1;
+
+        if(NULL != scratch)
+        {
+                scratch_ctx = scratch;
+                err = 0;
+        }
+
+        return err;
+}
+#endif /*uAES_SCRATCH_CALLER*/
+
+#ifdef __uAES_KEY_CACHE__
+/**
+ * @brief Sets the secret key of the hash that places keys in the key schedule cache, and
+ *        empties the cache. Required at start-up on targets without /dev/urandom, the cache
+ *        is bypassed until a hash key is set.
+ * @param seed    16-Byte random hash key.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+int uaes_key_cache_seed(uint8_t *seed)
+{
+        int err = -1;
+
+        if(NULL != seed)
+        {
+                kcache_seed(seed);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Reads the key schedule cache counters, one-shot calls that found their key
+ *        schedules cached and calls that had to expand the key.
+ * @param hits    Pointer to hit count.
+ * @param misses  Pointer to miss count.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+int uaes_key_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+        int err = -1;
+
+        if((NULL != hits) && (NULL != misses))
+        {
+                kcache_stats(hits, misses);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Zeroes every key and key schedule held by the cache and resets its counters, e.g.
+ *        after a key is retired.
+ */
+void uaes_key_cache_wipe(void)
+{
+        kcache_wipe();
+        return;
+}
+#endif /*__uAES_KEY_CACHE__*/
+
+#ifdef __uAES_PROFILE__
+/**
+ * @brief Reads the profiling counters of the calling thread.
+ * @param prof    Pointer to counters.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+int uaes_prof_read(uaes_prof_t *prof)
+{
+        int err = -1;
+
+        if(NULL != prof)
+        {
+                uprof_read(prof);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Clears the profiling counters of the calling thread, e.g. after a warm-up.
+ */
+void uaes_prof_reset(void)
+{
+        uprof_reset();
+        return;
+}
+
+/**
+ * @brief Prints the profiling counters of every thread to stderr.
+ */
+void uaes_prof_dump(void)
+{
+        uprof_dump();
+        return;
+}
+#endif /*__uAES_PROFILE__*/
+
+/**
+ * @brief Performs XOR operation between initialisation vector and data block
+ * 
+ * @param block Pointer to data block.
+ * @param iv    Pointer to initialisation vector.
+ */
+static void uaes_xor_iv(void *block, void *iv)
+{
+        uint32_t *p_blk = block;
+        uint32_t *p_iv = iv;
+        uAES_PROF_START(prof);
+        
+        p_blk[0] ^= p_iv[0];
+        p_blk[1] ^= p_iv[1];
+        p_blk[2] ^= p_iv[2];
+        p_blk[3] ^= p_iv[3];
+        
+        uAES_PROF_LAP(prof, uAES_PROF_MODE);
+        return;
+}
+
+/**
+ * @brief Clears memory holding key material, the empty asm statement keeps the compiler from
+ *        removing the memset as a dead store.
+ * 
+ * @param ptr   Pointer to memory.
+ * @param size  Memory size in bytes.
+ */
+static void uaes_memzero(void *ptr, size_t size)
+{
+        memset(ptr, 0, size);
+        __asm__ __volatile__("" : : "r"(ptr) : "memory");
+        return;
+}
+
+/**
+ * @brief Compares two buffers holding key material in constant time.
+ * 
+ * @param a     Pointer to first buffer.
+ * @param b     Pointer to second buffer.
+ * @param size  Buffer size in bytes.
+ * @return int  [1] if equal, [0] otherwise.
+ */
+static int uaes_memeq(const uint8_t *a, const uint8_t *b, size_t size)
+{
+        uint8_t diff = 0U;
+
+        for(size_t idx = 0UL; idx < size; idx++)
+        {
+                diff |= a[idx] ^ b[idx];
+        }
+        return (int)(1U & (((uint32_t)diff - 1U) >> 8));
+}
+
+/**
+ * @brief Computes the key schedules held by a cipher context. Key expansion runs on the AES-NI
+ *        engine when the CPU supports it. The decryption schedule is the encryption schedule
+ *        with InvMixColumns applied to the round keys 1 to Nr - 1, as the equivalent inverse
+ *        cipher expects. The bitsliced engine decrypts with the transposed encryption schedule.
+ * @param ctx         Pointer to cipher context.
+ * @param key         Pointer to key buffer.
+ * @param aes_length  Encryption/Decryption key length.
+ * @param dirs        Key schedules to be computed, uAES_CTX_ENC and/or uAES_CTX_DEC.
+ */
+static void uaes_ctx_expand(uaes_ctx_t *ctx, uint8_t *key, aes_length_t aes_length, unsigned int dirs)
+{
+        int hw = 0;
+        uAES_PROF_START(prof);
+
+        ctx->aes_length = aes_length;
+        ctx->Nb = 4UL;
+        ctx->Nk = ctx->Nb + (aes_length * 2UL);
+        ctx->Nr = 10UL + (aes_length * 2UL);
+
+#ifdef __uAES_AESNI__
+        hw = aesni_available();
+        if(0 != hw)
+        {
+                aesni_key_expansion(key, ctx->ekschd, ctx->Nk);
+        }
+        else
+#endif /*__uAES_AESNI__*/
+        {
+                key_expansion(key, ctx->ekschd, ctx->Nk, (ctx->Nb * (ctx->Nr + 1)));
+        }
+
+        if(0 != (dirs & uAES_CTX_DEC))
+        {
+                memcpy((void *)ctx->dkschd, (void *)ctx->ekschd, sizeof(ctx->dkschd));
+                if(0 != hw)
+                {
+#ifdef __uAES_AESNI__
+                        aesni_inv_key_schedule(ctx->dkschd, ctx->Nr);
+#endif /*__uAES_AESNI__*/
+                }
+                else
+                {
+#ifdef __uAES_TTABLE__
+                        ttab_inv_key_schedule(ctx->dkschd, ctx->Nr);
+#else
+                        inv_key_schedule(ctx->dkschd, ctx->Nb, ctx->Nr);
+#endif /*__uAES_TTABLE__*/
+                }
+        }
+
+#ifdef __uAES_BSLICE__
+        if(0 == hw)
+        {
+                bslice_key_schedule(ctx->ekschd, ctx->bkschd, ctx->Nr);
+        }
+#endif /*__uAES_BSLICE__*/
+        uAES_PROF_LAP(prof, uAES_PROF_KEXP);
+        return;
+}
+
+/**
+ * @brief Fills the scratch context of a one-shot function. With __uAES_KEY_CACHE__ the key
+ *        schedules of a recently used key are copied from the cache, otherwise both are
+ *        computed and cached. The cache is bypassed on the AES-NI engine, which expands a
+ *        key faster than the cache can be probed.
+ * @param ctx         Pointer to cipher context.
+ * @param key         Pointer to key buffer.
+ * @param aes_length  Encryption/Decryption key length.
+ * @param dirs        Key schedules needed, uAES_CTX_ENC and/or uAES_CTX_DEC.
+ */
+static void uaes_ctx_load(uaes_ctx_t *ctx, uint8_t *key, aes_length_t aes_length, unsigned int dirs)
+{
+#ifdef __uAES_KEY_CACHE__
+#ifdef __uAES_AESNI__
+        if(0 != aesni_available())
+        {
+                uaes_ctx_expand(ctx, key, aes_length, dirs);
+                return;
+        }
+#else
+        /* Cached contexts always hold both key schedules. */
+        (void)(dirs);
+#endif /*__uAES_AESNI__*/
+        if(0 == kcache_get(ctx, key, aes_length))
+        {
+                uaes_ctx_expand(ctx, key, aes_length, (uAES_CTX_ENC | uAES_CTX_DEC));
+                kcache_put(ctx, key);
+        }
+#else
+        uaes_ctx_expand(ctx, key, aes_length, dirs);
+#endif /*__uAES_KEY_CACHE__*/
+        return;
+}
+
+/**
+ * @brief Selects the foward cipher of the portable or T-table engine specialised for the key
+ *        length of the context, with the number of rounds fixed at compile time.
+ * @param ctx         Pointer to cipher context.
+ * @return uaes_cipher_t Single block cipher.
+ */
+static uaes_cipher_t uaes_foward_cipher(const uaes_ctx_t *ctx)
+{
+        uaes_cipher_t cipher = NULL;
+
+        switch(ctx->aes_length)
+        {
+                case uAES192:
+                        cipher = uAES_CIPHER(foward_cipher_192);
+                        break;
+                case uAES256:
+                        cipher = uAES_CIPHER(foward_cipher_256);
+                        break;
+                default:
+                        cipher = uAES_CIPHER(foward_cipher_128);
+                        break;
+        }
+        return cipher;
+}
+
+/**
+ * @brief Selects the equivalent inverse cipher of the portable or T-table engine specialised
+ *        for the key length of the context.
+ * @param ctx         Pointer to cipher context.
+ * @return uaes_cipher_t Single block cipher.
+ */
+static uaes_cipher_t uaes_inverse_cipher(const uaes_ctx_t *ctx)
+{
+        uaes_cipher_t cipher = NULL;
+
+        switch(ctx->aes_length)
+        {
+                case uAES192:
+                        cipher = uAES_CIPHER(inverse_cipher_192);
+                        break;
+                case uAES256:
+                        cipher = uAES_CIPHER(inverse_cipher_256);
+                        break;
+                default:
+                        cipher = uAES_CIPHER(inverse_cipher_128);
+                        break;
+        }
+        return cipher;
+}
+
+/**
+ * @brief Computes foward cipher encryption on independent blocks.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ */
+static void uaes_ecb_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks)
+{
+        const uaes_cipher_t cipher = uaes_foward_cipher(ctx);
+        size_t idx = 0UL;
+#ifdef __uAES_AESNI__
+        if(0 != aesni_available())
+        {
+                aesni_encrypt_blocks(buf, nblocks, ctx->ekschd, ctx->Nr);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        bslice_encrypt_blocks(buf, nblocks, ctx->bkschd, ctx->Nr);
+        return;
+#endif /*__uAES_BSLICE__*/
+        while(nblocks > idx)
+        {
+                cipher(&buf[uAES_BLOCK_SIZE * idx], ctx->ekschd);
+                idx++;
+        }
+        return;
+}
+
+/**
+ * @brief Computes inverse cipher decryption on independent blocks.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ */
+static void uaes_ecb_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks)
+{
+        const uaes_cipher_t cipher = uaes_inverse_cipher(ctx);
+        size_t idx = 0UL;
+#ifdef __uAES_AESNI__
+        if(0 != aesni_available())
+        {
+                aesni_decrypt_blocks(buf, nblocks, ctx->dkschd, ctx->Nr);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        bslice_decrypt_blocks(buf, nblocks, ctx->bkschd, ctx->Nr);
+        return;
+#endif /*__uAES_BSLICE__*/
+        while(nblocks > idx)
+        {
+                cipher(&buf[uAES_BLOCK_SIZE * idx], ctx->dkschd);
+                idx++;
+        }
+        return;
+}
+
+/**
+ * @brief Computes cipher block chaining encryption on given buffer.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param iv      16-Byte initialisation vector.
+ */
+static void uaes_cbc_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv)
+{
+        const uaes_cipher_t cipher = uaes_foward_cipher(ctx);
+        size_t idx = 0UL;
+#ifdef __uAES_AESNI__
+        if(0 != aesni_available())
+        {
+                aesni_cbc_encrypt(buf, nblocks, ctx->ekschd, ctx->Nr, iv);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        bslice_cbc_encrypt(buf, nblocks, ctx->bkschd, ctx->Nr, iv);
+        return;
+#endif /*__uAES_BSLICE__*/
+        uaes_xor_iv(buf, iv);
+        cipher(&buf[uAES_BLOCK_SIZE * idx], ctx->ekschd);
+        idx++;
+
+        while(nblocks > idx)
+        {
+                uaes_xor_iv(&buf[uAES_BLOCK_SIZE * idx], &buf[uAES_BLOCK_SIZE * (idx - 1)]);
+                cipher(&buf[uAES_BLOCK_SIZE * idx], ctx->ekschd);
+                idx++;
+        }
+        return;
+}
+
+/**
+ * @brief Computes cipher block chaining decryption on given buffer, from the first block to the
+ *        last. The ciphertext block needed by the next one is saved before it is overwritten.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param iv      16-Byte initialisation vector.
+ */
+static void uaes_cbc_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv)
+{
+        uint8_t chain[2][uAES_BLOCK_SIZE];
+        const uaes_cipher_t cipher = uaes_inverse_cipher(ctx);
+        size_t idx = 0UL;
+#ifdef __uAES_AESNI__
+        if(0 != aesni_available())
+        {
+                aesni_cbc_decrypt(buf, nblocks, ctx->dkschd, ctx->Nr, iv);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        bslice_cbc_decrypt(buf, nblocks, ctx->bkschd, ctx->Nr, iv);
+        return;
+#endif /*__uAES_BSLICE__*/
+        memcpy((void *)chain[0], (void *)iv, uAES_BLOCK_SIZE);
+        while(nblocks > idx)
+        {
+                uAES_PROF_START(prof);
+                memcpy((void *)chain[(idx + 1UL) & 1UL], (void *)&buf[uAES_BLOCK_SIZE * idx], uAES_BLOCK_SIZE);
+                uAES_PROF_LAP(prof, uAES_PROF_MODE);
+                cipher(&buf[uAES_BLOCK_SIZE * idx], ctx->dkschd);
+                uaes_xor_iv(&buf[uAES_BLOCK_SIZE * idx], chain[idx & 1UL]);
+                idx++;
+        }
+        return;
+}
+
+/**
+ * @brief Advances every lane by the same number of CBC blocks. The AES-NI engine interleaves
+ *        the lanes, and so does the bitsliced engine when the lanes share a context. Otherwise
+ *        the lanes are encrypted one after the other.
+ * @param ctx     Context of every lane, all with the same number of rounds.
+ * @param buf     Position of every lane in its message.
+ * @param state   Chaining value of every lane.
+ * @param nlanes  Number of lanes [1, uAES_MB_LANES].
+ * @param nblocks Number of 16-byte blocks processed in every lane.
+ */
+static void uaes_mb_encrypt(uaes_ctx_t **ctx, uint8_t **buf, uint8_t *state, size_t nlanes, size_t nblocks)
+{
+        size_t lane = 0UL;
+#ifdef __uAES_AESNI__
+        const uint32_t *kschd[uAES_MB_LANES];
+
+        if(0 != aesni_available())
+        {
+                for(lane = 0UL; lane < nlanes; lane++)
+                {
+                        kschd[lane] = ctx[lane]->ekschd;
+                }
+                aesni_cbc_encrypt_lanes(buf, nlanes, nblocks, kschd, ctx[0]->Nr, state);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        size_t blk = 0UL;
+
+        for(lane = 1UL; (lane < nlanes) && (ctx[lane] == ctx[0]); lane++);
+        if(nlanes == lane)
+        {
+                for(blk = 0UL; blk < nblocks; blk++)
+                {
+                        for(lane = 0UL; lane < nlanes; lane++)
+                        {
+                                uaes_xor_iv(&state[uAES_BLOCK_SIZE * lane], &buf[lane][uAES_BLOCK_SIZE * blk]);
+                        }
+                        bslice_encrypt_blocks(state, nlanes, ctx[0]->bkschd, ctx[0]->Nr);
+                        for(lane = 0UL; lane < nlanes; lane++)
+                        {
+                                memcpy((void *)&buf[lane][uAES_BLOCK_SIZE * blk], (void *)&state[uAES_BLOCK_SIZE * lane], uAES_BLOCK_SIZE);
+                        }
+                }
+                return;
+        }
+#endif /*__uAES_BSLICE__*/
+        for(lane = 0UL; lane < nlanes; lane++)
+        {
+                uaes_cbc_foward(ctx[lane], buf[lane], nblocks, &state[uAES_BLOCK_SIZE * lane]);
+                memcpy((void *)&state[uAES_BLOCK_SIZE * lane], (void *)&buf[lane][uAES_BLOCK_SIZE * (nblocks - 1UL)], uAES_BLOCK_SIZE);
+        }
+        return;
+}
+
+/**
+ * @brief Encrypts the CBC messages with Nr rounds, up to uAES_MB_LANES at a time. Every lane
+ *        holds the chaining value of its message. All lanes are advanced together up to the
+ *        end of the shortest one, then finished lanes are refilled with the next messages, or
+ *        replaced by the last lane when none is left.
+ * @param jobs    Pointer to messages.
+ * @param njobs   Number of messages.
+ * @param Nr      Number of rounds of the messages to be processed.
+ */
+static void uaes_mb_cbc(uaes_cbc_job_t *jobs, size_t njobs, size_t Nr)
+{
+        uint8_t state[uAES_MB_LANES * uAES_BLOCK_SIZE];
+        uaes_ctx_t *ctx[uAES_MB_LANES];
+        uint8_t *buf[uAES_MB_LANES];
+        size_t left[uAES_MB_LANES];
+        size_t next = 0UL, nlanes = 0UL, lane = 0UL, step = 0UL;
+
+        for(;;)
+        {
+                for(; (next < njobs) && (uAES_MB_LANES > nlanes); next++)
+                {
+                        if(Nr == jobs[next].ctx->Nr)
+                        {
+                                ctx[nlanes]  = jobs[next].ctx;
+                                buf[nlanes]  = jobs[next].buf;
+                                left[nlanes] = uAES_ALIGN(jobs[next].size, uAES_BLOCK_ALIGN) >> 4UL;
+                                memcpy((void *)&state[uAES_BLOCK_SIZE * nlanes], (void *)jobs[next].iv, uAES_BLOCK_SIZE);
+                                nlanes++;
+                        }
+                }
+                if(0UL == nlanes)
+                {
+                        break;
+                }
+
+                step = left[0];
+                for(lane = 1UL; lane < nlanes; lane++)
+                {
+                        step = (left[lane] < step) ? (left[lane]) : (step);
+                }
+                uaes_mb_encrypt(ctx, buf, state, nlanes, step);
+
+                lane = 0UL;
+                while(nlanes > lane)
+                {
+                        buf[lane] += uAES_BLOCK_SIZE * step;
+                        left[lane] -= step;
+                        if(0UL != left[lane])
+                        {
+                                lane++;
+                                continue;
+                        }
+                        nlanes--;
+                        ctx[lane]  = ctx[nlanes];
+                        buf[lane]  = buf[nlanes];
+                        left[lane] = left[nlanes];
+                        memcpy((void *)&state[uAES_BLOCK_SIZE * lane], (void *)&state[uAES_BLOCK_SIZE * nlanes], uAES_BLOCK_SIZE);
+                }
+        }
+        uaes_memzero(state, sizeof(state));
+        return;
+}
+
+#ifdef __uAES_PTHREAD__
+/**
+ * @brief Processes one chunk of a multi-threaded job on the calling worker.
+ * @param arg   Pointer to job descriptor.
+ * @param chunk Chunk index.
+ */
+static void uaes_mt_chunk(void *arg, size_t chunk)
+{
+        uaes_mt_job_t *job = arg;
+        size_t first = chunk * uAES_MT_CHUNK_BLOCKS;
+        size_t nblocks = job->nblocks - first;
+        uint8_t *buf = &job->buf[uAES_BLOCK_SIZE * first];
+
+        if(uAES_MT_CHUNK_BLOCKS < nblocks)
+        {
+                nblocks = uAES_MT_CHUNK_BLOCKS;
+        }
+
+        switch(job->op)
+        {
+                case uAES_MT_ECB_ENC:
+                        uaes_ecb_foward(job->ctx, buf, nblocks);
+                        break;
+                case uAES_MT_ECB_DEC:
+                        uaes_ecb_inverse(job->ctx, buf, nblocks);
+                        break;
+                case uAES_MT_CBC_DEC:
+                        uaes_cbc_inverse(job->ctx, buf, nblocks, job->ivs[chunk]);
+                        break;
+                default:
+                        break;
+        }
+        return;
+}
+
+/**
+ * @brief Splits a buffer into uAES_MT_CHUNK_SIZE chunks processed across the worker pool.
+ *        Buffers below the pool threshold, or any buffer when the pool is not running, are
+ *        processed on the calling thread. For CBC decryption the ciphertext block preceding
+ *        every chunk is copied out before any chunk is decrypted in place, it is the chunk IV.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param op      uAES_MT_ECB_ENC, uAES_MT_ECB_DEC or uAES_MT_CBC_DEC.
+ * @param iv      16-Byte initialisation vector, only used by uAES_MT_CBC_DEC.
+ */
+static void uaes_mt_run(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, unsigned int op, uint8_t *iv)
+{
+        uint8_t ivs[uAES_MT_MAX_CHUNKS][uAES_BLOCK_SIZE];
+        uaes_mt_job_t job = { ctx, buf, nblocks, op, ivs };
+        size_t nchunks = (nblocks + uAES_MT_CHUNK_BLOCKS - 1UL) / uAES_MT_CHUNK_BLOCKS;
+
+        if(((uAES_BLOCK_SIZE * nblocks) < mt_threshold) || (1UL == mthread_threads()))
+        {
+                if(uAES_MT_ECB_ENC == op)
+                {
+                        uaes_ecb_foward(ctx, buf, nblocks);
+                }
+                else if(uAES_MT_ECB_DEC == op)
+                {
+                        uaes_ecb_inverse(ctx, buf, nblocks);
+                }
+                else
+                {
+                        uaes_cbc_inverse(ctx, buf, nblocks, iv);
+                }
+                return;
+        }
+
+        if(uAES_MT_CBC_DEC == op)
+        {
+                memcpy((void *)ivs[0], (void *)iv, uAES_BLOCK_SIZE);
+                for(size_t chunk = 1UL; chunk < nchunks; chunk++)
+                {
+                        memcpy((void *)ivs[chunk], (void *)&buf[uAES_BLOCK_SIZE * ((chunk * uAES_MT_CHUNK_BLOCKS) - 1UL)], uAES_BLOCK_SIZE);
+                }
+        }
+
+        mthread_run(uaes_mt_chunk, &job, nchunks);
+        return;
+}
+
+/**
+ * @brief Processes one group of sectors of a multi-threaded XTS call.
+ * @param arg   Pointer to uaes_mt_xts_t job.
+ * @param chunk Group index.
+ */
+static void uaes_mt_xts_chunk(void *arg, size_t chunk)
+{
+        uaes_mt_xts_t *job = arg;
+        size_t first = chunk * job->per_chunk;
+        size_t nsectors = job->nsectors - first;
+
+        if(job->per_chunk < nsectors)
+        {
+                nsectors = job->per_chunk;
+        }
+
+        uaes_xts_sectors(job->xts, job->sector + first, &job->buf[job->sector_size * first], job->sector_size, nsectors, job->decrypt);
+        return;
+}
+
+/**
+ * @brief Splits consecutive sectors into groups of about uAES_MT_CHUNK_SIZE bytes processed
+ *        across the worker pool. Calls below the pool threshold, or any call when the pool is
+ *        not running, are processed on the calling thread.
+ * @param xts         Pointer to XTS state.
+ * @param sector      Data unit number of the first sector.
+ * @param buf         Pointer to first sector.
+ * @param sector_size Sector size in bytes.
+ * @param nsectors    Number of sectors.
+ * @param decrypt     Non-zero to decrypt.
+ */
+static void uaes_mt_xts_run(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors, int decrypt)
+{
+        uaes_mt_xts_t job = { xts, buf, sector_size, nsectors, 1UL, sector, decrypt };
+
+        if(((sector_size * nsectors) < mt_threshold) || (1UL == mthread_threads()))
+        {
+                uaes_xts_sectors(xts, sector, buf, sector_size, nsectors, decrypt);
+                return;
+        }
+
+        if(uAES_MT_CHUNK_SIZE > sector_size)
+        {
+                job.per_chunk = uAES_MT_CHUNK_SIZE / sector_size;
+        }
+        mthread_run(uaes_mt_xts_chunk, &job, (nsectors + job.per_chunk - 1UL) / job.per_chunk);
+        return;
+}
+#endif /*__uAES_PTHREAD__*/
+
+/**
+ * @brief Increments the big-endian counter held by the last ctr_size bytes of a counter block,
+ *        the remaining bytes (nonce) are left untouched when the counter wraps around.
+ * @param ctr       16-Byte counter block.
+ * @param ctr_size  Counter length in bytes.
+ */
+static void uaes_ctr_increment(uint8_t *ctr, size_t ctr_size)
+{
+        size_t idx = uAES_BLOCK_SIZE;
+
+        while((uAES_BLOCK_SIZE - ctr_size) < idx)
+        {
+                idx--;
+                ctr[idx]++;
+                if(0U != ctr[idx])
+                {
+                        break;
+                }
+        }
+        return;
+}
+
+/**
+ * @brief XORs keystream into data 64 bits at a time, the compiler widens the loop to vector
+ *        registers where available. The tail shorter than 8 bytes is handled bytewise.
+ * @param buf     Pointer to data buffer.
+ * @param stream  Pointer to keystream buffer.
+ * @param size    Number of bytes.
+ */
+static void uaes_xor_stream(uint8_t *buf, uint8_t *stream, size_t size)
+{
+        size_t idx = 0UL;
+        uint64_t d, k;
+        uAES_PROF_START(prof);
+
+        for(; (idx + sizeof(uint64_t)) <= size; idx += sizeof(uint64_t))
+        {
+                memcpy((void *)&d, (void *)&buf[idx], sizeof(uint64_t));
+                memcpy((void *)&k, (void *)&stream[idx], sizeof(uint64_t));
+                d ^= k;
+                memcpy((void *)&buf[idx], (void *)&d, sizeof(uint64_t));
+        }
+        for(; idx < size; idx++)
+        {
+                buf[idx] ^= stream[idx];
+        }
+        uAES_PROF_LAP(prof, uAES_PROF_MODE);
+        return;
+}
+
+/**
+ * @brief Computes counter mode encryption/decryption on given buffer. Keystream is produced for
+ *        uAES_CTR_BLOCKS counters per batch through the multi-block engines.
+ * @param ctx       Pointer to cipher context.
+ * @param buf       Pointer to data buffer.
+ * @param size      Buffer size in bytes.
+ * @param ctr       16-Byte counter block, left holding the next unused counter.
+ * @param ctr_size  Counter length in bytes.
+ */
+static void uaes_ctr_stream(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *ctr, size_t ctr_size)
+{
+        uint8_t stream[uAES_CTR_BLOCKS * uAES_BLOCK_SIZE];
+        size_t nblocks = 0UL;
+        size_t chunk = 0UL;
+
+        while(0UL < size)
+        {
+                chunk = (size < sizeof(stream)) ? size : sizeof(stream);
+                nblocks = (chunk + uAES_BLOCK_SIZE - 1UL) >> 4UL;
+                uAES_PROF_START(prof);
+                for(size_t idx = 0UL; idx < nblocks; idx++)
+                {
+                        memcpy((void *)&stream[uAES_BLOCK_SIZE * idx], (void *)ctr, uAES_BLOCK_SIZE);
+                        uaes_ctr_increment(ctr, ctr_size);
+                }
+                uAES_PROF_LAP(prof, uAES_PROF_MODE);
+                uaes_ecb_foward(ctx, stream, nblocks);
+                uaes_xor_stream(buf, stream, chunk);
+                buf += chunk;
+                size -= chunk;
+        }
+
+        uaes_memzero(stream, sizeof(stream));
+        return;
+}
+
+/**
+ * @brief Computes propagating cipher block chaining encryption on given buffer, every block is
+ *        chained with the plaintext and ciphertext of the block before it.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param iv      16-Byte initialisation vector.
+ */
+static void uaes_pcbc_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv)
+{
+        uint8_t chain[uAES_BLOCK_SIZE];
+        uint8_t plain[uAES_BLOCK_SIZE];
+
+        memcpy((void *)chain, (void *)iv, uAES_BLOCK_SIZE);
+        for(size_t idx = 0UL; idx < nblocks; idx++, buf += uAES_BLOCK_SIZE)
+        {
+                memcpy((void *)plain, (void *)buf, uAES_BLOCK_SIZE);
+                uaes_xor_iv(buf, chain);
+                uaes_ecb_foward(ctx, buf, 1UL);
+                memcpy((void *)chain, (void *)buf, uAES_BLOCK_SIZE);
+                uaes_xor_iv(chain, plain);
+        }
+
+        uaes_memzero(chain, sizeof(chain));
+        uaes_memzero(plain, sizeof(plain));
+        return;
+}
+
+/**
+ * @brief Computes propagating cipher block chaining decryption on given buffer. The block
+ *        decryptions only depend on the ciphertext, so uAES_CTR_BLOCKS of them go through the
+ *        multi-block engines at once and the chain is applied afterwards.
+ * @param ctx     Pointer to cipher context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param iv      16-Byte initialisation vector.
+ */
+static void uaes_pcbc_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint8_t *iv)
+{
+        uint8_t cipher[uAES_CTR_BLOCKS * uAES_BLOCK_SIZE];
+        uint8_t chain[uAES_BLOCK_SIZE];
+        size_t run = 0UL;
+
+        memcpy((void *)chain, (void *)iv, uAES_BLOCK_SIZE);
+        while(0UL < nblocks)
+        {
+                run = (uAES_CTR_BLOCKS < nblocks) ? uAES_CTR_BLOCKS : nblocks;
+                memcpy((void *)cipher, (void *)buf, uAES_BLOCK_SIZE * run);
+                uaes_ecb_inverse(ctx, buf, run);
+                for(size_t idx = 0UL; idx < run; idx++, buf += uAES_BLOCK_SIZE)
+                {
+                        uaes_xor_iv(buf, chain);
+                        memcpy((void *)chain, (void *)buf, uAES_BLOCK_SIZE);
+                        uaes_xor_iv(chain, &cipher[uAES_BLOCK_SIZE * idx]);
+                }
+                nblocks -= run;
+        }
+
+        uaes_memzero(cipher, sizeof(cipher));
+        uaes_memzero(chain, sizeof(chain));
+        return;
+}
+
+/**
+ * @brief Computes 128-bit cipher feedback encryption on given buffer, the last block may be
+ *        partial. Every keystream block is the encryption of the previous ciphertext block.
+ * @param ctx   Pointer to cipher context.
+ * @param buf   Pointer to data buffer.
+ * @param size  Buffer size in bytes.
+ * @param iv    16-Byte feedback block, updated to the last ciphertext block.
+ */
+static void uaes_cfb_foward(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv)
+{
+        size_t chunk = 0UL;
+
+        while(0UL < size)
+        {
+                chunk = (uAES_BLOCK_SIZE < size) ? uAES_BLOCK_SIZE : size;
+                uaes_ecb_foward(ctx, iv, 1UL);
+                uaes_xor_stream(buf, iv, chunk);
+                memcpy((void *)iv, (void *)buf, chunk);
+                buf += chunk;
+                size -= chunk;
+        }
+        return;
+}
+
+/**
+ * @brief Computes 128-bit cipher feedback decryption on given buffer. Every keystream block is
+ *        the encryption of a ciphertext block that is already known, so uAES_CTR_BLOCKS of them
+ *        go through the multi-block engines at once.
+ * @param ctx   Pointer to cipher context.
+ * @param buf   Pointer to data buffer.
+ * @param size  Buffer size in bytes.
+ * @param iv    16-Byte feedback block, updated to the last ciphertext block.
+ */
+static void uaes_cfb_inverse(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv)
+{
+        uint8_t stream[uAES_CTR_BLOCKS * uAES_BLOCK_SIZE];
+        size_t nblocks = 0UL;
+        size_t chunk = 0UL;
+
+        while(0UL < size)
+        {
+                chunk = (size < sizeof(stream)) ? size : sizeof(stream);
+                nblocks = (chunk + uAES_BLOCK_SIZE - 1UL) >> 4UL;
+                memcpy((void *)stream, (void *)iv, uAES_BLOCK_SIZE);
+                memcpy((void *)&stream[uAES_BLOCK_SIZE], (void *)buf, uAES_BLOCK_SIZE * (nblocks - 1UL));
+                memcpy((void *)iv, (void *)&buf[uAES_BLOCK_SIZE * (nblocks - 1UL)], chunk - (uAES_BLOCK_SIZE * (nblocks - 1UL)));
+                uaes_ecb_foward(ctx, stream, nblocks);
+                uaes_xor_stream(buf, stream, chunk);
+                buf += chunk;
+                size -= chunk;
+        }
+
+        uaes_memzero(stream, sizeof(stream));
+        return;
+}
+
+/**
+ * @brief Computes the output feedback keystream, every block is the encryption of the block
+ *        before it. The keystream is either written to the buffer or produced uAES_CTR_BLOCKS
+ *        blocks ahead of the data and XORed into it.
+ * @param ctx       Pointer to cipher context.
+ * @param buf       Pointer to data buffer, or to the keystream buffer.
+ * @param size      Buffer size in bytes.
+ * @param iv        16-Byte feedback block, updated to the last keystream block.
+ * @param keystream Non-zero to write the keystream instead of XORing it into buf.
+ */
+static void uaes_ofb_stream(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv, int keystream)
+{
+        uint8_t stream[uAES_CTR_BLOCKS * uAES_BLOCK_SIZE];
+        size_t nblocks = 0UL;
+        size_t chunk = 0UL;
+
+        while(0UL < size)
+        {
+                chunk = (size < sizeof(stream)) ? size : sizeof(stream);
+                nblocks = (chunk + uAES_BLOCK_SIZE - 1UL) >> 4UL;
+                for(size_t idx = 0UL; idx < nblocks; idx++)
+                {
+                        uaes_ecb_foward(ctx, iv, 1UL);
+                        memcpy((void *)&stream[uAES_BLOCK_SIZE * idx], (void *)iv, uAES_BLOCK_SIZE);
+                }
+                if(0 != keystream)
+                {
+                        memcpy((void *)buf, (void *)stream, chunk);
+                }
+                else
+                {
+                        uaes_xor_stream(buf, stream, chunk);
+                }
+                buf += chunk;
+                size -= chunk;
+        }
+
+        uaes_memzero(stream, sizeof(stream));
+        return;
+}
+
+/**
+ * @brief Starts an incremental ECB/CBC operation.
+ * @param stream  Pointer to stream state.
+ * @param ctx     Pointer to cipher context.
+ * @param iv      16-Byte initialisation vector, NULL for ECB.
+ * @param mode    uAES_STREAM_ECB_ENC, uAES_STREAM_ECB_DEC, uAES_STREAM_CBC_ENC or uAES_STREAM_CBC_DEC.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+static int uaes_stream_init(uaes_stream_t *stream, uaes_ctx_t *ctx, uint8_t *iv, unsigned int mode)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != stream) && (NULL != ctx) && (uAESRGE > ctx->aes_length)))
+        {
+                memset((void *)stream, 0, sizeof(uaes_stream_t));
+                if(NULL != iv)
+                {
+                        memcpy((void *)stream->iv, (void *)iv, uAES_BLOCK_SIZE);
+                }
+                stream->ctx = ctx;
+                stream->mode = mode;
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Runs the stream mode on whole blocks in place and carries the chaining value.
+ * @param stream  Pointer to stream state.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ */
+static void uaes_stream_blocks(uaes_stream_t *stream, uint8_t *buf, size_t nblocks)
+{
+        uint8_t *last = NULL;
+
+        if(0UL == nblocks)
+        {
+                return;
+        }
+
+        last = &buf[uAES_BLOCK_SIZE * (nblocks - 1UL)];
+        switch(stream->mode)
+        {
+                case uAES_STREAM_ECB_ENC:
+                        uaes_ecb_foward(stream->ctx, buf, nblocks);
+                        break;
+                case uAES_STREAM_ECB_DEC:
+                        uaes_ecb_inverse(stream->ctx, buf, nblocks);
+                        break;
+                case uAES_STREAM_CBC_ENC:
+                        uaes_cbc_foward(stream->ctx, buf, nblocks, stream->iv);
+                        memcpy((void *)stream->iv, (void *)last, uAES_BLOCK_SIZE);
+                        break;
+                case uAES_STREAM_CBC_DEC:
+                {
+                        uint8_t next[uAES_BLOCK_SIZE];
+
+                        memcpy((void *)next, (void *)last, uAES_BLOCK_SIZE);
+                        uaes_cbc_inverse(stream->ctx, buf, nblocks, stream->iv);
+                        memcpy((void *)stream->iv, (void *)next, uAES_BLOCK_SIZE);
+                        break;
+                }
+                default:
+                        break;
+        }
+        return;
+}
+
+/**
+ * @brief Sums the lengths of scatter-gather segments.
+ * @param iov     Pointer to segment array.
+ * @param cnt     Number of segments.
+ * @return size_t Total length in bytes, SIZE_MAX if a non-empty segment has no base.
+ */
+static size_t uaes_iov_total(const uaes_iovec_t *iov, size_t cnt)
+{
+        size_t total = 0UL;
+
+        for(size_t idx = 0UL; idx < cnt; idx++)
+        {
+                if((NULL == iov[idx].iov_base) && (0UL < iov[idx].iov_len))
+                {
+                        return SIZE_MAX;
+                }
+                total += iov[idx].iov_len;
+        }
+        return total;
+}
+
+/**
+ * @brief Copies one block between a 16-byte buffer and scatter-gather segments, across as
+ *        many segments as the block straddles.
+ * @param iov     Pointer to segment array.
+ * @param idx     Current segment, advanced past the block.
+ * @param off     Offset in current segment, advanced past the block.
+ * @param block   16-Byte buffer.
+ * @param gather  [1] to copy from the segments into block, [0] to copy block into them.
+ */
+static void uaes_iov_copy(const uaes_iovec_t *iov, size_t *idx, size_t *off, uint8_t *block, int gather)
+{
+        size_t done = 0UL;
+        size_t take = 0UL;
+        uint8_t *seg = NULL;
+
+        while(uAES_BLOCK_SIZE > done)
+        {
+                if(iov[*idx].iov_len == *off)
+                {
+                        (*idx)++;
+                        *off = 0UL;
+                        continue;
+                }
+                seg = (uint8_t *)iov[*idx].iov_base + *off;
+                take = iov[*idx].iov_len - *off;
+                take = ((uAES_BLOCK_SIZE - done) < take) ? (uAES_BLOCK_SIZE - done) : (take);
+                if(0 != gather)
+                {
+                        memcpy((void *)&block[done], (void *)seg, take);
+                }
+                else
+                {
+                        memcpy((void *)seg, (void *)&block[done], take);
+                }
+                done += take;
+                *off += take;
+        }
+        return;
+}
+
+/**
+ * @brief Runs ECB/CBC from source segments into destination segments. Where both current
+ *        segments hold whole blocks, up to uAES_SG_BATCH bytes are moved to the destination and
+ *        processed there in place. Blocks straddling a segment boundary are gathered into a
+ *        16-byte buffer, processed and scattered.
+ * @param ctx     Pointer to cipher context.
+ * @param src     Pointer to source segment array.
+ * @param src_cnt Number of source segments.
+ * @param dst     Pointer to destination segment array.
+ * @param dst_cnt Number of destination segments.
+ * @param iv      16-Byte initialisation vector, NULL for ECB.
+ * @param mode    uAES_STREAM_ECB_ENC, uAES_STREAM_ECB_DEC, uAES_STREAM_CBC_ENC or uAES_STREAM_CBC_DEC.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+static int uaes_sg_xcrypt(uaes_ctx_t *ctx, const uaes_iovec_t *src, size_t src_cnt, const uaes_iovec_t *dst, size_t dst_cnt, uint8_t *iv, unsigned int mode)
+{
+        uaes_stream_t stream;
+        uint8_t block[uAES_BLOCK_SIZE];
+        size_t remaining = 0UL;
+        size_t si = 0UL, soff = 0UL;
+        size_t di = 0UL, doff = 0UL;
+        size_t len = 0UL;
+        uint8_t *from = NULL, *to = NULL;
+
+        if((NULL == src) || (NULL == dst) || (0 != uaes_stream_init(&stream, ctx, iv, mode)))
+        {
+                return -1;
+        }
+
+        remaining = uaes_iov_total(src, src_cnt);
+        len = uaes_iov_total(dst, dst_cnt);
+        if(uAES_PROF_CHECK((SIZE_MAX == remaining) || (SIZE_MAX == len) || (0UL == remaining) || (remaining > len) || (0UL != (remaining & uAES_BLOCK_ALIGN_MASK))))
+        {
+                return -1;
+        }
+
+        while(0UL < remaining)
+        {
+                for(; src[si].iov_len == soff; si++, soff = 0UL);
+                for(; dst[di].iov_len == doff; di++, doff = 0UL);
+
+                len = src[si].iov_len - soff;
+                len = ((dst[di].iov_len - doff) < len) ? (dst[di].iov_len - doff) : (len);
+                len = (uAES_SG_BATCH < len) ? (uAES_SG_BATCH) : (len);
+                len &= ~(uAES_BLOCK_SIZE - 1UL);
+                if(0UL < len)
+                {
+                        from = (uint8_t *)src[si].iov_base + soff;
+                        to = (uint8_t *)dst[di].iov_base + doff;
+                        memmove((void *)to, (void *)from, len);
+                        uaes_stream_blocks(&stream, to, len >> 4UL);
+                        soff += len;
+                        doff += len;
+                }
+                else
+                {
+                        len = uAES_BLOCK_SIZE;
+                        uaes_iov_copy(src, &si, &soff, block, 1);
+                        uaes_stream_blocks(&stream, block, 1UL);
+                        uaes_iov_copy(dst, &di, &doff, block, 0);
+                }
+                remaining -= len;
+        }
+
+        uaes_memzero(block, sizeof(block));
+        uaes_memzero(&stream, sizeof(stream));
+        return 0;
+}
+
+/**
+ * @brief Stores a big-endian 64-bit word.
+ * @param dst Pointer to 8 bytes.
+ * @param val Word to be stored.
+ */
+static void uaes_store64(uint8_t *dst, uint64_t val)
+{
+        for(size_t idx = 8UL; idx > 0UL; idx--)
+        {
+                dst[idx - 1UL] = (uint8_t)val;
+                val >>= 8UL;
+        }
+        return;
+}
+
+/**
+ * @brief Hashes AAD into the GCM state, bytes short of a full block are kept in gcm->part
+ *        until the next call or the end of the AAD.
+ * @param gcm   Pointer to GCM state.
+ * @param data  Pointer to AAD buffer.
+ * @param size  Number of bytes.
+ */
+static void uaes_gcm_absorb(uaes_gcm_t *gcm, uint8_t *data, size_t size)
+{
+        size_t used = (size_t)(gcm->aad_size & uAES_BLOCK_ALIGN_MASK);
+        size_t nblocks = 0UL;
+
+        gcm->aad_size += size;
+        for(; (0UL != used) && (0UL < size); size--)
+        {
+                gcm->part[used++] = *data++;
+                if(uAES_BLOCK_SIZE == used)
+                {
+                        ghash_blocks(gcm->xi, gcm->part, 1UL, &gcm->hkey);
+                        used = 0UL;
+                }
+        }
+
+        nblocks = size >> 4UL;
+        ghash_blocks(gcm->xi, data, nblocks, &gcm->hkey);
+        data += uAES_BLOCK_SIZE * nblocks;
+        size -= uAES_BLOCK_SIZE * nblocks;
+
+        if(0UL < size)
+        {
+                memcpy((void *)gcm->part, (void *)data, size);
+        }
+        return;
+}
+
+/**
+ * @brief Hashes the partial block left in gcm->part, zero padded.
+ * @param gcm   Pointer to GCM state.
+ * @param total AAD or data bytes processed so far.
+ */
+static void uaes_gcm_flush(uaes_gcm_t *gcm, uint64_t total)
+{
+        size_t used = (size_t)(total & uAES_BLOCK_ALIGN_MASK);
+
+        if(0UL != used)
+        {
+                memset((void *)&gcm->part[used], 0, uAES_BLOCK_SIZE - used);
+                ghash_blocks(gcm->xi, gcm->part, 1UL, &gcm->hkey);
+        }
+        return;
+}
+
+/**
+ * @brief Computes GCM encryption/decryption on given buffer. Keystream is produced for
+ *        uAES_CTR_BLOCKS counters per batch and every batch of ciphertext is hashed right
+ *        after it is written, or right before it is decrypted, while it is still in cache.
+ * @param gcm     Pointer to GCM state.
+ * @param buf     Pointer to data buffer.
+ * @param size    Buffer size in bytes.
+ * @param decrypt [0] to encrypt, [1] to decrypt.
+ */
+static void uaes_gcm_stream(uaes_gcm_t *gcm, uint8_t *buf, size_t size, int decrypt)
+{
+        uint8_t stream[uAES_CTR_BLOCKS * uAES_BLOCK_SIZE];
+        size_t used = (size_t)(gcm->msg_size & uAES_BLOCK_ALIGN_MASK);
+        size_t nblocks = 0UL;
+
+        gcm->msg_size += size;
+        for(; (0UL != used) && (0UL < size); size--, buf++)
+        {
+                gcm->part[used] = (0 != decrypt) ? (*buf) : (*buf ^ gcm->stream[used]);
+                *buf ^= gcm->stream[used++];
+                if(uAES_BLOCK_SIZE == used)
+                {
+                        ghash_blocks(gcm->xi, gcm->part, 1UL, &gcm->hkey);
+                        used = 0UL;
+                }
+        }
+
+        while(uAES_BLOCK_SIZE <= size)
+        {
+                nblocks = size >> 4UL;
+                nblocks = (uAES_CTR_BLOCKS < nblocks) ? (uAES_CTR_BLOCKS) : (nblocks);
+                for(size_t idx = 0UL; idx < nblocks; idx++)
+                {
+                        memcpy((void *)&stream[uAES_BLOCK_SIZE * idx], (void *)gcm->ctr, uAES_BLOCK_SIZE);
+                        uaes_ctr_increment(gcm->ctr, uAES_GCM_CTR_SIZE);
+                }
+                uaes_ecb_foward(gcm->ctx, stream, nblocks);
+                if(0 != decrypt)
+                {
+                        ghash_blocks(gcm->xi, buf, nblocks, &gcm->hkey);
+                        uaes_xor_stream(buf, stream, uAES_BLOCK_SIZE * nblocks);
+                }
+                else
+                {
+                        uaes_xor_stream(buf, stream, uAES_BLOCK_SIZE * nblocks);
+                        ghash_blocks(gcm->xi, buf, nblocks, &gcm->hkey);
+                }
+                buf += uAES_BLOCK_SIZE * nblocks;
+                size -= uAES_BLOCK_SIZE * nblocks;
+        }
+
+        if(0UL < size)
+        {
+                memcpy((void *)gcm->stream, (void *)gcm->ctr, uAES_BLOCK_SIZE);
+                uaes_ctr_increment(gcm->ctr, uAES_GCM_CTR_SIZE);
+                uaes_ecb_foward(gcm->ctx, gcm->stream, 1UL);
+                for(used = 0UL; used < size; used++)
+                {
+                        gcm->part[used] = (0 != decrypt) ? (buf[used]) : (buf[used] ^ gcm->stream[used]);
+                        buf[used] ^= gcm->stream[used];
+                }
+        }
+
+        uaes_memzero(stream, sizeof(stream));
+        return;
+}
+
+/**
+ * @brief Completes the GHASH with the pending partial block and the length block, then
+ *        encrypts it with the pre-counter block.
+ * @param gcm Pointer to GCM state.
+ * @param tag 16-Byte buffer receiving the full tag.
+ */
+static void uaes_gcm_tag(uaes_gcm_t *gcm, uint8_t *tag)
+{
+        uint8_t lens[uAES_BLOCK_SIZE];
+
+        uaes_gcm_flush(gcm, (uAES_GCM_AAD == gcm->phase) ? (gcm->aad_size) : (gcm->msg_size));
+        uaes_store64(&lens[0], gcm->aad_size << 3UL);
+        uaes_store64(&lens[8], gcm->msg_size << 3UL);
+        ghash_blocks(gcm->xi, lens, 1UL, &gcm->hkey);
+
+        memcpy((void *)tag, (void *)gcm->j0, uAES_BLOCK_SIZE);
+        uaes_ecb_foward(gcm->ctx, tag, 1UL);
+        uaes_xor_iv(tag, gcm->xi);
+        gcm->phase = uAES_GCM_DONE;
+        return;
+}
+
+/**
+ * @brief Loads an XTS tweak, a little-endian 128-bit value, into two 64-bit halves.
+ * @param src Pointer to 16-byte tweak.
+ * @param t   Tweak halves, t[0] holds bits 0 to 63.
+ */
+static void uaes_xts_load(const uint8_t *src, uint64_t *t)
+{
+        t[0] = 0UL;
+        t[1] = 0UL;
+        for(size_t idx = 8UL; idx > 0UL; idx--)
+        {
+                t[0] = (t[0] << 8UL) | src[idx - 1UL];
+                t[1] = (t[1] << 8UL) | src[idx + 7UL];
+        }
+        return;
+}
+
+/**
+ * @brief Stores the two 64-bit halves of an XTS tweak as a little-endian 128-bit value.
+ * @param dst Pointer to 16 bytes.
+ * @param t   Tweak halves, t[0] holds bits 0 to 63.
+ */
+static void uaes_xts_store(uint8_t *dst, const uint64_t *t)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        memcpy((void *)dst, (void *)t, uAES_BLOCK_SIZE);
+#else
+        for(size_t idx = 0UL; idx < 8UL; idx++)
+        {
+                dst[idx]       = (uint8_t)(t[0] >> (8UL * idx));
+                dst[idx + 8UL] = (uint8_t)(t[1] >> (8UL * idx));
+        }
+#endif /*__BYTE_ORDER__*/
+        return;
+}
+
+/**
+ * @brief Multiplies an XTS tweak by x in GF(2^128) modulo x^128 + x^7 + x^2 + x + 1.
+ * @param t Tweak halves, t[0] holds bits 0 to 63.
+ */
+static inline void uaes_xts_double(uint64_t *t)
+{
+        uint64_t carry = t[1] >> 63UL;
+
+        t[1] = (t[1] << 1UL) | (t[0] >> 63UL);
+        t[0] = (t[0] << 1UL) ^ (carry * 0x87UL);
+        return;
+}
+
+/**
+ * @brief Processes whole XTS blocks. The tweaks of up to uAES_XTS_BLOCKS blocks are laid out
+ *        first, each one the previous tweak multiplied by x in GF(2^128), then the run is masked,
+ *        encrypted or decrypted by the multi-block engines in one call and masked again. The
+ *        AES-NI engine keeps the tweaks in registers instead.
+ * @param ctx     Pointer to data key context.
+ * @param buf     Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ * @param t       Tweak of the first block, left at the tweak of the next block.
+ * @param decrypt Non-zero to decrypt.
+ */
+static void uaes_xts_run(uaes_ctx_t *ctx, uint8_t *buf, size_t nblocks, uint64_t *t, int decrypt)
+{
+        uint8_t tw[uAES_XTS_BLOCKS * uAES_BLOCK_SIZE];
+        size_t run = 0UL;
+#ifdef __uAES_AESNI__
+        if(0 != aesni_available())
+        {
+                uaes_xts_store(tw, t);
+                if(0 != decrypt)
+                {
+                        aesni_xts_decrypt(buf, nblocks, ctx->dkschd, ctx->Nr, tw);
+                }
+                else
+                {
+                        aesni_xts_encrypt(buf, nblocks, ctx->ekschd, ctx->Nr, tw);
+                }
+                uaes_xts_load(tw, t);
+                uaes_memzero(tw, uAES_BLOCK_SIZE);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+
+        while(0UL < nblocks)
+        {
+                run = (uAES_XTS_BLOCKS < nblocks) ? uAES_XTS_BLOCKS : nblocks;
+                for(size_t idx = 0UL; idx < run; idx++)
+                {
+                        uaes_xts_store(&tw[uAES_BLOCK_SIZE * idx], t);
+                        uaes_xts_double(t);
+                }
+                uaes_xor_stream(buf, tw, uAES_BLOCK_SIZE * run);
+                if(0 != decrypt)
+                {
+                        uaes_ecb_inverse(ctx, buf, run);
+                }
+                else
+                {
+                        uaes_ecb_foward(ctx, buf, run);
+                }
+                uaes_xor_stream(buf, tw, uAES_BLOCK_SIZE * run);
+                buf += uAES_BLOCK_SIZE * run;
+                nblocks -= run;
+        }
+
+        uaes_memzero(tw, sizeof(tw));
+        return;
+}
+
+/**
+ * @brief Processes one XTS data unit of at least 16 bytes. A partial last block borrows the
+ *        tail of the ciphertext of the block before it (ciphertext stealing), which is then
+ *        processed again with the last tweak. Decryption swaps the two tweaks.
+ * @param ctx     Pointer to data key context.
+ * @param buf     Pointer to data unit.
+ * @param size    Data unit size in bytes.
+ * @param t       Encrypted tweak of the data unit, clobbered.
+ * @param decrypt Non-zero to decrypt.
+ */
+static void uaes_xts_unit(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint64_t *t, int decrypt)
+{
+        size_t nblocks = size >> 4UL;
+        size_t part = size & uAES_BLOCK_ALIGN_MASK;
+        uint8_t *last = NULL;
+        uint8_t tmp[uAES_BLOCK_SIZE];
+        uint64_t prev[2];
+
+        if(0UL == part)
+        {
+                uaes_xts_run(ctx, buf, nblocks, t, decrypt);
+                return;
+        }
+
+        uaes_xts_run(ctx, buf, nblocks - 1UL, t, decrypt);
+        last = &buf[uAES_BLOCK_SIZE * (nblocks - 1UL)];
+        prev[0] = t[0];
+        prev[1] = t[1];
+        uaes_xts_double(t);
+
+        uaes_xts_run(ctx, last, 1UL, (0 != decrypt) ? t : prev, decrypt);
+        memcpy((void *)tmp, (void *)&last[uAES_BLOCK_SIZE], part);
+        memcpy((void *)&last[uAES_BLOCK_SIZE], (void *)last, part);
+        memcpy((void *)last, (void *)tmp, part);
+        uaes_xts_run(ctx, last, 1UL, (0 != decrypt) ? prev : t, decrypt);
+
+        uaes_memzero(tmp, sizeof(tmp));
+        uaes_memzero(prev, sizeof(prev));
+        return;
+}
+
+/**
+ * @brief Processes consecutive sectors, sector i using the data unit number sector + i. The
+ *        tweaks of up to uAES_XTS_BLOCKS sectors are encrypted together with the tweak key.
+ * @param xts         Pointer to XTS state.
+ * @param sector      Data unit number of the first sector.
+ * @param buf         Pointer to first sector.
+ * @param sector_size Sector size in bytes.
+ * @param nsectors    Number of sectors.
+ * @param decrypt     Non-zero to decrypt.
+ */
+static void uaes_xts_sectors(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors, int decrypt)
+{
+        uint8_t tw[uAES_XTS_BLOCKS * uAES_BLOCK_SIZE];
+        uint64_t num[2] = { sector, 0UL };
+        uint64_t t[2];
+        size_t run = 0UL;
+
+        while(0UL < nsectors)
+        {
+                run = (uAES_XTS_BLOCKS < nsectors) ? uAES_XTS_BLOCKS : nsectors;
+                for(size_t idx = 0UL; idx < run; idx++)
+                {
+                        uaes_xts_store(&tw[uAES_BLOCK_SIZE * idx], num);
+                        num[0]++;
+                        num[1] += (0UL == num[0]) ? 1UL : 0UL;
+                }
+                uaes_ecb_foward(xts->tctx, tw, run);
+                for(size_t idx = 0UL; idx < run; idx++)
+                {
+                        uaes_xts_load(&tw[uAES_BLOCK_SIZE * idx], t);
+                        uaes_xts_unit(xts->ctx, buf, sector_size, t, decrypt);
+                        buf += sector_size;
+                }
+                nsectors -= run;
+        }
+
+        uaes_memzero(tw, sizeof(tw));
+        uaes_memzero(t, sizeof(t));
+        return;
+}
+
+/**
+ * @brief Checks the arguments of the XTS sector functions.
+ * @param xts         Pointer to XTS state.
+ * @param buf         Pointer to first sector.
+ * @param sector_size Sector size in bytes, a data unit of 16 bytes to uAES_XTS_MAX_UNIT.
+ * @param nsectors    Number of sectors.
+ * @return int        [0] if valid, [-1] otherwise.
+ */
+static int uaes_xts_valid(uaes_xts_t *xts, uint8_t *buf, size_t sector_size, size_t nsectors)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != xts)                                &&
+                           (NULL != xts->ctx)                           &&
+                           (NULL != xts->tctx)                          &&
+                           (NULL != buf)                                &&
+                           (uAES_BLOCK_SIZE <= sector_size)             &&
+                           (uAES_XTS_MAX_UNIT >= sector_size)           &&
+                           (0UL < nsectors)                             &&
+                           ((SIZE_MAX / sector_size) >= nsectors)))
+        {
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Doubles a block in GF(2^128) as in NIST SP 800-38B, the block is read big-endian and
+ *        reduced without branching on the carried out bit.
+ * @param out   Doubled block.
+ * @param in    Block to be doubled.
+ */
+static void uaes_cmac_double(uint8_t *out, const uint8_t *in)
+{
+        const uint8_t carry = (uint8_t)(0U - (in[0] >> 7U));
+
+        for(size_t idx = 0UL; idx < (uAES_BLOCK_SIZE - 1UL); idx++)
+        {
+                out[idx] = (uint8_t)((in[idx] << 1U) | (in[idx + 1UL] >> 7U));
+        }
+        out[uAES_BLOCK_SIZE - 1UL] = (uint8_t)(in[uAES_BLOCK_SIZE - 1UL] << 1U) ^ (carry & uAES_CMAC_RB);
+        return;
+}
+
+/**
+ * @brief Absorbs complete blocks into a CBC-MAC chaining value, the data is only read.
+ * @param ctx     Pointer to cipher context.
+ * @param x       16-Byte chaining value.
+ * @param data    Pointer to data buffer.
+ * @param nblocks Number of 16-byte blocks.
+ */
+static void uaes_cmac_blocks(uaes_ctx_t *ctx, uint8_t *x, uint8_t *data, size_t nblocks)
+{
+        const uaes_cipher_t cipher = uaes_foward_cipher(ctx);
+        size_t idx = 0UL;
+#ifdef __uAES_AESNI__
+        const uint32_t *kschd = ctx->ekschd;
+
+        if(0 != aesni_available())
+        {
+                aesni_cbc_mac_lanes(&data, 1UL, nblocks, &kschd, ctx->Nr, x);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        for(idx = 0UL; idx < nblocks; idx++)
+        {
+                uaes_xor_iv(x, &data[uAES_BLOCK_SIZE * idx]);
+                bslice_encrypt_blocks(x, 1UL, ctx->bkschd, ctx->Nr);
+        }
+        return;
+#endif /*__uAES_BSLICE__*/
+        for(idx = 0UL; idx < nblocks; idx++)
+        {
+                uaes_xor_iv(x, &data[uAES_BLOCK_SIZE * idx]);
+                cipher(x, ctx->ekschd);
+        }
+        return;
+}
+
+/**
+ * @brief Builds the last block of a CMAC message, a complete block is masked with K1 and a
+ *        partial or empty one is padded with 10* and masked with K2.
+ * @param cmac  Pointer to keyed CMAC state.
+ * @param last  16-Byte last block.
+ * @param data  Pointer to the last message bytes.
+ * @param size  Number of last message bytes [0, 16].
+ */
+static void uaes_cmac_last(const uaes_cmac_t *cmac, uint8_t *last, const uint8_t *data, size_t size)
+{
+        if(uAES_BLOCK_SIZE == size)
+        {
+                memcpy((void *)last, (void *)data, uAES_BLOCK_SIZE);
+                uaes_xor_iv(last, (void *)cmac->k1);
+        }
+        else
+        {
+                memset((void *)last, 0, uAES_BLOCK_SIZE);
+                memcpy((void *)last, (void *)data, size);
+                last[size] = 0x80U;
+                uaes_xor_iv(last, (void *)cmac->k2);
+        }
+        return;
+}
+
+/**
+ * @brief Completes the current CMAC message and computes its full 16-byte tag.
+ * @param cmac  Pointer to CMAC state.
+ * @param tag   16-Byte tag.
+ */
+static void uaes_cmac_tag(uaes_cmac_t *cmac, uint8_t *tag)
+{
+        uint8_t last[uAES_BLOCK_SIZE];
+
+        uaes_cmac_last(cmac, last, cmac->part, cmac->used);
+        uaes_cmac_blocks(cmac->ctx, cmac->x, last, 1UL);
+        memcpy((void *)tag, (void *)cmac->x, uAES_BLOCK_SIZE);
+        uaes_memzero(last, sizeof(last));
+        uaes_memzero(cmac->x, uAES_BLOCK_SIZE);
+        uaes_memzero(cmac->part, uAES_BLOCK_SIZE);
+        cmac->used = 0UL;
+        cmac->phase = uAES_CMAC_DONE;
+        return;
+}
+
+/**
+ * @brief Absorbs the same number of blocks into the CBC-MAC of every lane, see uaes_mb_encrypt().
+ *        The messages are only read.
+ * @param ctx     Context of every lane, all with the same number of rounds.
+ * @param buf     Position of every lane in its message.
+ * @param state   Chaining value of every lane.
+ * @param nlanes  Number of lanes [1, uAES_MB_LANES].
+ * @param nblocks Number of 16-byte blocks absorbed in every lane.
+ */
+static void uaes_mb_mac(uaes_ctx_t **ctx, uint8_t **buf, uint8_t *state, size_t nlanes, size_t nblocks)
+{
+        size_t lane = 0UL;
+#ifdef __uAES_AESNI__
+        const uint32_t *kschd[uAES_MB_LANES];
+
+        if(0 != aesni_available())
+        {
+                for(lane = 0UL; lane < nlanes; lane++)
+                {
+                        kschd[lane] = ctx[lane]->ekschd;
+                }
+                aesni_cbc_mac_lanes(buf, nlanes, nblocks, kschd, ctx[0]->Nr, state);
+                return;
+        }
+#endif /*__uAES_AESNI__*/
+#ifdef __uAES_BSLICE__
+        size_t blk = 0UL;
+
+        for(lane = 1UL; (lane < nlanes) && (ctx[lane] == ctx[0]); lane++);
+        if(nlanes == lane)
+        {
+                for(blk = 0UL; blk < nblocks; blk++)
+                {
+                        for(lane = 0UL; lane < nlanes; lane++)
+                        {
+                                uaes_xor_iv(&state[uAES_BLOCK_SIZE * lane], &buf[lane][uAES_BLOCK_SIZE * blk]);
+                        }
+                        bslice_encrypt_blocks(state, nlanes, ctx[0]->bkschd, ctx[0]->Nr);
+                }
+                return;
+        }
+#endif /*__uAES_BSLICE__*/
+        for(lane = 0UL; lane < nlanes; lane++)
+        {
+                uaes_cmac_blocks(ctx[lane], &state[uAES_BLOCK_SIZE * lane], buf[lane], nblocks);
+        }
+        return;
+}
+
+/**
+ * @brief Computes the CMAC of the messages with Nr rounds, up to uAES_MB_LANES at a time, see
+ *        uaes_mb_cbc(). When a lane has absorbed every block of its message but the last, it
+ *        is switched to its masked last block so that the tag is computed in lock-step too.
+ * @param jobs    Pointer to messages.
+ * @param njobs   Number of messages.
+ * @param Nr      Number of rounds of the messages to be processed.
+ */
+static void uaes_mb_cmac(uaes_cmac_job_t *jobs, size_t njobs, size_t Nr)
+{
+        uint8_t state[uAES_MB_LANES * uAES_BLOCK_SIZE];
+        uint8_t last[uAES_MB_LANES][uAES_BLOCK_SIZE];
+        uaes_ctx_t *ctx[uAES_MB_LANES];
+        uint8_t *buf[uAES_MB_LANES];
+        size_t left[uAES_MB_LANES];
+        size_t job[uAES_MB_LANES];
+        int final[uAES_MB_LANES];
+        size_t next = 0UL, nlanes = 0UL, lane = 0UL, step = 0UL, tail = 0UL;
+
+        for(;;)
+        {
+                for(; (next < njobs) && (uAES_MB_LANES > nlanes); next++)
+                {
+                        if(Nr == jobs[next].cmac->ctx->Nr)
+                        {
+                                ctx[nlanes]   = jobs[next].cmac->ctx;
+                                buf[nlanes]   = jobs[next].msg;
+                                left[nlanes]  = (0UL == jobs[next].size) ? (0UL) : ((jobs[next].size - 1UL) >> 4UL);
+                                job[nlanes]   = next;
+                                final[nlanes] = 0;
+                                memset((void *)&state[uAES_BLOCK_SIZE * nlanes], 0, uAES_BLOCK_SIZE);
+                                nlanes++;
+                        }
+                }
+                if(0UL == nlanes)
+                {
+                        break;
+                }
+
+                for(lane = 0UL; lane < nlanes; lane++)
+                {
+                        if((0UL == left[lane]) && (0 == final[lane]))
+                        {
+                                tail = jobs[job[lane]].size - (size_t)(buf[lane] - jobs[job[lane]].msg);
+                                uaes_cmac_last(jobs[job[lane]].cmac, last[lane], buf[lane], tail);
+                                buf[lane]   = last[lane];
+                                left[lane]  = 1UL;
+                                final[lane] = 1;
+                        }
+                }
+
+                step = left[0];
+                for(lane = 1UL; lane < nlanes; lane++)
+                {
+                        step = (left[lane] < step) ? (left[lane]) : (step);
+                }
+                uaes_mb_mac(ctx, buf, state, nlanes, step);
+
+                lane = 0UL;
+                while(nlanes > lane)
+                {
+                        buf[lane] += uAES_BLOCK_SIZE * step;
+                        left[lane] -= step;
+                        if((0UL != left[lane]) || (0 == final[lane]))
+                        {
+                                lane++;
+                                continue;
+                        }
+                        memcpy((void *)jobs[job[lane]].tag, (void *)&state[uAES_BLOCK_SIZE * lane], jobs[job[lane]].tag_size);
+                        nlanes--;
+                        ctx[lane]   = ctx[nlanes];
+                        buf[lane]   = (0 != final[nlanes]) ? (last[lane]) : (buf[nlanes]);
+                        left[lane]  = left[nlanes];
+                        job[lane]   = job[nlanes];
+                        final[lane] = final[nlanes];
+                        memcpy((void *)last[lane], (void *)last[nlanes], uAES_BLOCK_SIZE);
+                        memcpy((void *)&state[uAES_BLOCK_SIZE * lane], (void *)&state[uAES_BLOCK_SIZE * nlanes], uAES_BLOCK_SIZE);
+                }
+        }
+        uaes_memzero(state, sizeof(state));
+        uaes_memzero(last, sizeof(last));
+        return;
+}
+
+/**
+ * @brief Initialises a cipher context, expanding the encryption and decryption key schedules
+ *        once so that they can be reused by every uaes_ctx_* call.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param key                   Pointer to key buffer.
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_init(uaes_ctx_t *ctx, uint8_t *key, aes_length_t aes_length)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
+        {
+                uaes_ctx_expand(ctx, key, aes_length, (uAES_CTX_ENC | uAES_CTX_DEC));
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Clears the key schedules held by a cipher context.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ */
+void uaes_wipe(uaes_ctx_t *ctx)
+{
+        if(NULL != ctx)
+        {
+                uaes_memzero(ctx, sizeof(uaes_ctx_t));
+                ctx->aes_length = uAESRGE;
+        }
+        return;
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining encryption on given plaintext.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param plaintext             Pointer to plaintext buffer
+ * @param plaintext_size        Plaintext buffer size.
+ * @param iv                    16-Byte Initialisation vector.
+ * @return int                  [0] if sucessful. [-1] on failure. 
+ */
+int uaes_ctx_cbc_encryption(uaes_ctx_t *ctx, 
+                            uint8_t *plaintext, 
+                            size_t plaintext_size, 
+                            uint8_t *iv)
+{
+        int err = -1;
+        size_t offset = plaintext_size;
+
+        if(0 != (plaintext_size & uAES_BLOCK_ALIGN_MASK))
+        {
+                offset = uAES_ALIGN(plaintext_size, uAES_BLOCK_ALIGN);
+        }
+
+        offset >>= 4UL; 
+
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != plaintext)                         &&
+                            (NULL != iv)                                && 
+                            (0 < plaintext_size)                        && 
+                            (uAES_MAX_INPUT_SIZE >= plaintext_size)     && 
+                            (uAESRGE > ctx->aes_length) ))
+        {
+                uaes_cbc_foward(ctx, plaintext, offset, iv);
+                err = 0;
+        }
+        
+        return err;
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining decryption on given ciphertext 
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cbc_decryption(uaes_ctx_t *ctx, 
+                            uint8_t *ciphertext, 
+                            size_t ciphertext_size, 
+                            uint8_t *iv)
+{
+        int err = -1;
+        size_t offset = ciphertext_size;
+
+        if(0 != ( ciphertext_size & uAES_BLOCK_ALIGN_MASK))
+        {
+                offset = uAES_ALIGN(ciphertext_size, uAES_BLOCK_ALIGN);
+        }
+        
+        offset >>= 4UL; 
+
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != ciphertext)                        &&
+                            (NULL != iv)                                && 
+                            (0 < ciphertext_size)                       && 
+                            (uAES_MAX_INPUT_SIZE >= ciphertext_size)    && 
+                            (uAESRGE > ctx->aes_length) ))
+        {
+                uaes_cbc_inverse(ctx, ciphertext, offset, iv);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Counter mode encryption or decryption on given buffer. Any byte length is
+ *        accepted, no padding is applied. The counter block is updated to the next unused
+ *        counter so that a message can be processed over several calls, as long as every call
+ *        but the last one processes a multiple of 16 bytes.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param buf                   Pointer to plaintext/ciphertext buffer.
+ * @param size                  Buffer size.
+ * @param ctr                   16-Byte counter block, nonce followed by a big-endian counter.
+ * @param ctr_size              Counter length in bytes [1, 16], e.g. 4 for a 96-bit nonce.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ctr_xcrypt(uaes_ctx_t *ctx, 
+                        uint8_t *buf, 
+                        size_t size, 
+                        uint8_t *ctr, 
+                        size_t ctr_size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                &&
+                           (NULL != buf)                                &&
+                           (NULL != ctr)                                &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)                &&
+                           (0 < ctr_size)                               &&
+                           (uAES_BLOCK_SIZE >= ctr_size)                &&
+                           (uAESRGE > ctx->aes_length)))
+        {
+                uaes_ctr_stream(ctx, buf, size, ctr, ctr_size);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Propagating Cipher Block Chaining encryption on given plaintext.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Plaintext buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_pcbc_encryption(uaes_ctx_t *ctx, 
+                             uint8_t *plaintext, 
+                             size_t plaintext_size, 
+                             uint8_t *iv)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != plaintext)                         &&
+                            (NULL != iv)                                && 
+                            (0 < plaintext_size)                        && 
+                            (uAES_MAX_INPUT_SIZE >= plaintext_size)     && 
+                            (uAESRGE > ctx->aes_length) ))
+        {
+                uaes_pcbc_foward(ctx, plaintext, uAES_ALIGN(plaintext_size, uAES_BLOCK_ALIGN) >> 4UL, iv);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Propagating Cipher Block Chaining decryption on given ciphertext.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_pcbc_decryption(uaes_ctx_t *ctx, 
+                             uint8_t *ciphertext, 
+                             size_t ciphertext_size, 
+                             uint8_t *iv)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != ciphertext)                        &&
+                            (NULL != iv)                                && 
+                            (0 < ciphertext_size)                       && 
+                            (uAES_MAX_INPUT_SIZE >= ciphertext_size)    && 
+                            (uAESRGE > ctx->aes_length) ))
+        {
+                uaes_pcbc_inverse(ctx, ciphertext, uAES_ALIGN(ciphertext_size, uAES_BLOCK_ALIGN) >> 4UL, iv);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES 128-bit Cipher Feedback encryption on given plaintext. Any byte length
+ *        is accepted, no padding is applied. The IV is updated to the last ciphertext block so
+ *        that a message can be processed over several calls, as long as every call but the
+ *        last one processes a multiple of 16 bytes.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Plaintext buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cfb_encryption(uaes_ctx_t *ctx, 
+                            uint8_t *plaintext, 
+                            size_t plaintext_size, 
+                            uint8_t *iv)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != plaintext)                         &&
+                            (NULL != iv)                                && 
+                            (0 < plaintext_size)                        && 
+                            (uAES_MAX_INPUT_SIZE >= plaintext_size)     && 
+                            (uAESRGE > ctx->aes_length) ))
+        {
+                uaes_cfb_foward(ctx, plaintext, plaintext_size, iv);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES 128-bit Cipher Feedback decryption on given ciphertext, the IV is
+ *        updated as by uaes_ctx_cfb_encryption(). Only the encryption key schedule is used.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cfb_decryption(uaes_ctx_t *ctx, 
+                            uint8_t *ciphertext, 
+                            size_t ciphertext_size, 
+                            uint8_t *iv)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != ciphertext)                        &&
+                            (NULL != iv)                                && 
+                            (0 < ciphertext_size)                       && 
+                            (uAES_MAX_INPUT_SIZE >= ciphertext_size)    && 
+                            (uAESRGE > ctx->aes_length) ))
+        {
+                uaes_cfb_inverse(ctx, ciphertext, ciphertext_size, iv);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Output Feedback encryption or decryption on given buffer. Any byte length
+ *        is accepted, the IV is updated to the last keystream block so that a message can be
+ *        processed over several calls, as long as every call but the last one processes a
+ *        multiple of 16 bytes.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param buf                   Pointer to plaintext/ciphertext buffer.
+ * @param size                  Buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ofb_xcrypt(uaes_ctx_t *ctx, 
+                        uint8_t *buf, 
+                        size_t size, 
+                        uint8_t *iv)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                &&
+                           (NULL != buf)                                &&
+                           (NULL != iv)                                 &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)                &&
+                           (uAESRGE > ctx->aes_length)))
+        {
+                uaes_ofb_stream(ctx, buf, size, iv, 0);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Computes the AES Output Feedback keystream ahead of the data. The keystream only
+ *        depends on the key and IV, so it can be produced while the data is still on its way
+ *        and XORed into it later. The IV is updated as by uaes_ctx_ofb_xcrypt().
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param stream                Pointer to keystream buffer.
+ * @param size                  Keystream length in bytes.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ofb_keystream(uaes_ctx_t *ctx, 
+                           uint8_t *stream, 
+                           size_t size, 
+                           uint8_t *iv)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                &&
+                           (NULL != stream)                             &&
+                           (NULL != iv)                                 &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)                &&
+                           (uAESRGE > ctx->aes_length)))
+        {
+                uaes_ofb_stream(ctx, stream, size, iv, 1);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES Electronic Code Book encryption on given plaintext.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Size of plaintext buffer.
+ * @return int                  [0] if sucessful, [-1] on failure. 
+ */
+int uaes_ctx_ecb_encryption(uaes_ctx_t *ctx, 
+                            uint8_t *plaintext, 
+                            size_t plaintext_size)
+{
+        int err = -1;
+        size_t offset = plaintext_size;
+
+        if(0 != (plaintext_size & uAES_BLOCK_ALIGN_MASK))
+        {
+                offset = uAES_ALIGN( plaintext_size, uAES_BLOCK_ALIGN );
+        }
+
+        offset >>= 4UL;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                &&
+                           (NULL != plaintext)                          && 
+                           (0 < plaintext_size)                         && 
+                           (uAES_MAX_INPUT_SIZE >= plaintext_size)      && 
+                           (uAESRGE > ctx->aes_length)))
+        {
+                uaes_ecb_foward(ctx, plaintext, offset);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES-ECB decryption on given ciphertext.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Size of ciphertext buffer.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ecb_decryption(uaes_ctx_t *ctx, 
+                            uint8_t *ciphertext, 
+                            size_t ciphertext_size)
+{
+        int err = -1;
+        size_t offset = ciphertext_size;
+
+        if(0 != ( ciphertext_size & uAES_BLOCK_ALIGN_MASK ) )
+        {
+                offset = uAES_ALIGN( ciphertext_size, uAES_BLOCK_ALIGN );
+        }
+        
+        offset >>= 4UL;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                && 
+                           (NULL != ciphertext)                         && 
+                           (0 < ciphertext_size)                        && 
+                           (uAES_MAX_INPUT_SIZE >= ciphertext_size)     && 
+                           (uAESRGE > ctx->aes_length)))
+        {
+                uaes_ecb_inverse(ctx, ciphertext, offset);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Computes AES encryption on a single 16 byte plaintext block.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Plaintext buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_block_encryption(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != plaintext) && (0 < plaintext_size) && (uAES_BLOCK_SIZE >= plaintext_size) && (uAESRGE > ctx->aes_length)))
+        {
+                err = 0;
+                uaes_ecb_foward(ctx, plaintext, 1UL);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Computes AES decryption on a single 16 byte ciphertext block.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_block_decryption(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != ciphertext) && (0 < ciphertext_size) && (uAES_BLOCK_SIZE >= ciphertext_size) && (uAESRGE > ctx->aes_length)))
+        {
+                err = 0;
+                uaes_ecb_inverse(ctx, ciphertext, 1UL);
+        }
+
+        return err;
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES Electronic Code Book encryption from src into dst.
+ *        src is left untouched, dst may be the same buffer as src, otherwise they must not
+ *        overlap. Both hold size rounded up to 16 bytes, as with the in-place functions.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to input buffer.
+ * @param dst                   Pointer to output buffer.
+ * @param size                  Buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ecb_encryption_to(uaes_ctx_t *ctx, 
+                               uint8_t *src, 
+                               uint8_t *dst, 
+                               size_t size)
+{
+        int err = -1;
+        uaes_iovec_t in = { src, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+        uaes_iovec_t out = { dst, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+
+        if(uAES_PROF_CHECK((NULL != src)                                &&
+                           (NULL != dst)                                &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)))
+        {
+                err = uaes_sg_xcrypt(ctx, &in, 1UL, &out, 1UL, NULL, uAES_STREAM_ECB_ENC);
+        }
+
+        return err;
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES-ECB decryption from src into dst.
+ *        src is left untouched, dst may be the same buffer as src, otherwise they must not
+ *        overlap. Both hold size rounded up to 16 bytes, as with the in-place functions.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to input buffer.
+ * @param dst                   Pointer to output buffer.
+ * @param size                  Buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ecb_decryption_to(uaes_ctx_t *ctx, 
+                               uint8_t *src, 
+                               uint8_t *dst, 
+                               size_t size)
+{
+        int err = -1;
+        uaes_iovec_t in = { src, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+        uaes_iovec_t out = { dst, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+
+        if(uAES_PROF_CHECK((NULL != src)                                &&
+                           (NULL != dst)                                &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)))
+        {
+                err = uaes_sg_xcrypt(ctx, &in, 1UL, &out, 1UL, NULL, uAES_STREAM_ECB_DEC);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining encryption from src into dst.
+ *        src is left untouched, dst may be the same buffer as src, otherwise they must not
+ *        overlap. Both hold size rounded up to 16 bytes, as with the in-place functions.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to input buffer.
+ * @param dst                   Pointer to output buffer.
+ * @param size                  Buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cbc_encryption_to(uaes_ctx_t *ctx, 
+                               uint8_t *src, 
+                               uint8_t *dst, 
+                               size_t size, 
+                               uint8_t *iv)
+{
+        int err = -1;
+        uaes_iovec_t in = { src, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+        uaes_iovec_t out = { dst, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+
+        if(uAES_PROF_CHECK((NULL != src)                                &&
+                           (NULL != dst)                                &&
+                           (NULL != iv)                                 &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)))
+        {
+                err = uaes_sg_xcrypt(ctx, &in, 1UL, &out, 1UL, iv, uAES_STREAM_CBC_ENC);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining decryption from src into dst.
+ *        src is left untouched, dst may be the same buffer as src, otherwise they must not
+ *        overlap. Both hold size rounded up to 16 bytes, as with the in-place functions.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to input buffer.
+ * @param dst                   Pointer to output buffer.
+ * @param size                  Buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cbc_decryption_to(uaes_ctx_t *ctx, 
+                               uint8_t *src, 
+                               uint8_t *dst, 
+                               size_t size, 
+                               uint8_t *iv)
+{
+        int err = -1;
+        uaes_iovec_t in = { src, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+        uaes_iovec_t out = { dst, uAES_ALIGN(size, uAES_BLOCK_ALIGN) };
+
+        if(uAES_PROF_CHECK((NULL != src)                                &&
+                           (NULL != dst)                                &&
+                           (NULL != iv)                                 &&
+                           (0 < size)                                   &&
+                           (uAES_MAX_INPUT_SIZE >= size)))
+        {
+                err = uaes_sg_xcrypt(ctx, &in, 1UL, &out, 1UL, iv, uAES_STREAM_CBC_DEC);
+        }
+
+        return err;
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES Electronic Code Book encryption from source into destination segments.
+ *        Blocks may straddle segment boundaries. The total source length must be a multiple
+ *        of 16 bytes and fit in the destination segments. Destination segments may be the
+ *        source segments, otherwise they must not overlap them.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to source segment array.
+ * @param src_cnt               Number of source segments.
+ * @param dst                   Pointer to destination segment array.
+ * @param dst_cnt               Number of destination segments.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ecb_encryption_iov(uaes_ctx_t *ctx, 
+                                const uaes_iovec_t *src, 
+                                size_t src_cnt, 
+                                const uaes_iovec_t *dst, 
+                                size_t dst_cnt)
+{
+        return uaes_sg_xcrypt(ctx, src, src_cnt, dst, dst_cnt, NULL, uAES_STREAM_ECB_ENC);
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES-ECB decryption from source into destination segments.
+ *        Blocks may straddle segment boundaries. The total source length must be a multiple
+ *        of 16 bytes and fit in the destination segments. Destination segments may be the
+ *        source segments, otherwise they must not overlap them.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to source segment array.
+ * @param src_cnt               Number of source segments.
+ * @param dst                   Pointer to destination segment array.
+ * @param dst_cnt               Number of destination segments.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_ecb_decryption_iov(uaes_ctx_t *ctx, 
+                                const uaes_iovec_t *src, 
+                                size_t src_cnt, 
+                                const uaes_iovec_t *dst, 
+                                size_t dst_cnt)
+{
+        return uaes_sg_xcrypt(ctx, src, src_cnt, dst, dst_cnt, NULL, uAES_STREAM_ECB_DEC);
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining encryption from source into destination segments.
+ *        Blocks may straddle segment boundaries. The total source length must be a multiple
+ *        of 16 bytes and fit in the destination segments. Destination segments may be the
+ *        source segments, otherwise they must not overlap them.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to source segment array.
+ * @param src_cnt               Number of source segments.
+ * @param dst                   Pointer to destination segment array.
+ * @param dst_cnt               Number of destination segments.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cbc_encryption_iov(uaes_ctx_t *ctx, 
+                                const uaes_iovec_t *src, 
+                                size_t src_cnt, 
+                                const uaes_iovec_t *dst, 
+                                size_t dst_cnt, 
+                                uint8_t *iv)
+{
+        return (NULL != iv) ? (uaes_sg_xcrypt(ctx, src, src_cnt, dst, dst_cnt, iv, uAES_STREAM_CBC_ENC)) : (-1);
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining decryption from source into destination segments.
+ *        Blocks may straddle segment boundaries. The total source length must be a multiple
+ *        of 16 bytes and fit in the destination segments. Destination segments may be the
+ *        source segments, otherwise they must not overlap them.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param src                   Pointer to source segment array.
+ * @param src_cnt               Number of source segments.
+ * @param dst                   Pointer to destination segment array.
+ * @param dst_cnt               Number of destination segments.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cbc_decryption_iov(uaes_ctx_t *ctx, 
+                                const uaes_iovec_t *src, 
+                                size_t src_cnt, 
+                                const uaes_iovec_t *dst, 
+                                size_t dst_cnt, 
+                                uint8_t *iv)
+{
+        return (NULL != iv) ? (uaes_sg_xcrypt(ctx, src, src_cnt, dst, dst_cnt, iv, uAES_STREAM_CBC_DEC)) : (-1);
+}
+
+/**
+ * @brief Performs AES Cipher Block Chaining encryption on independent messages at once. Each
+ *        message is serial, so messages are advanced in lock-step to keep the block engine
+ *        busy, and a lane is refilled as soon as its message ends. Messages may use different
+ *        contexts and key lengths. Fails without encrypting anything if any job is invalid.
+ * 
+ * @param jobs                  Pointer to messages.
+ * @param njobs                 Number of messages.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctx_cbc_encryption_mb(uaes_cbc_job_t *jobs, size_t njobs)
+{
+        int err = -1;
+        size_t idx = 0UL;
+
+        if(uAES_PROF_CHECK((NULL != jobs) && (0UL < njobs)))
+        {
+                for(idx = 0UL; idx < njobs; idx++)
+                {
+                        if(uAES_PROF_CHECK( (NULL == jobs[idx].ctx)                             ||
+                                            (NULL == jobs[idx].buf)                             ||
+                                            (NULL == jobs[idx].iv)                              ||
+                                            (0UL == jobs[idx].size)                             ||
+                                            (uAES_MAX_INPUT_SIZE < jobs[idx].size)              ||
+                                            (uAESRGE <= jobs[idx].ctx->aes_length) ))
+                        {
+                                break;
+                        }
+                }
+                if(njobs == idx)
+                {
+                        uaes_mb_cbc(jobs, njobs, 10UL);
+                        uaes_mb_cbc(jobs, njobs, 12UL);
+                        uaes_mb_cbc(jobs, njobs, 14UL);
+                        err = 0;
+                }
+        }
+        return err;
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Starts an incremental AES-ECB encryption, data is passed to uaes_stream_update().
+ * 
+ * @param stream                Pointer to stream state.
+ * @param ctx                   Pointer to cipher context.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ecb_encrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx)
+{
+        return uaes_stream_init(stream, ctx, NULL, uAES_STREAM_ECB_ENC);
+}
+
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Starts an incremental AES-ECB decryption, data is passed to uaes_stream_update().
+ * 
+ * @param stream                Pointer to stream state.
+ * @param ctx                   Pointer to cipher context.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ecb_decrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx)
+{
+        return uaes_stream_init(stream, ctx, NULL, uAES_STREAM_ECB_DEC);
+}
+
+/**
+ * @brief Starts an incremental AES Cipher Block Chaining encryption, data is passed to
+ *        uaes_stream_update().
+ * 
+ * @param stream                Pointer to stream state.
+ * @param ctx                   Pointer to cipher context.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cbc_encrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx, uint8_t *iv)
+{
+        return (uAES_PROF_CHECK(NULL != iv)) ? (uaes_stream_init(stream, ctx, iv, uAES_STREAM_CBC_ENC)) : (-1);
+}
+
+/**
+ * @brief Starts an incremental AES Cipher Block Chaining decryption, data is passed to
+ *        uaes_stream_update().
+ * 
+ * @param stream                Pointer to stream state.
+ * @param ctx                   Pointer to cipher context.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cbc_decrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx, uint8_t *iv)
+{
+        return (uAES_PROF_CHECK(NULL != iv)) ? (uaes_stream_init(stream, ctx, iv, uAES_STREAM_CBC_DEC)) : (-1);
+}
+
+/**
+ * @brief Processes the next part of a stream, of any length. Every completed block is written
+ *        to dst, the bytes left over are kept until the next call. src and dst may be the same
+ *        buffer while every part is a multiple of 16 bytes, otherwise they must not overlap.
+ * 
+ * @param stream                Pointer to stream state.
+ * @param src                   Pointer to input buffer.
+ * @param size                  Input buffer size.
+ * @param dst                   Pointer to output buffer, holding at least size + 15 bytes.
+ * @param dst_size              Receives the number of bytes written to dst.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_stream_update(uaes_stream_t *stream, uint8_t *src, size_t size, uint8_t *dst, size_t *dst_size)
+{
+        int err = -1;
+        size_t take = 0UL;
+        size_t nblocks = 0UL;
+        size_t out = 0UL;
+
+        if(uAES_PROF_CHECK((NULL != stream)                             &&
+                           (NULL != stream->ctx)                        &&
+                           ((NULL != src) || (0UL == size))             &&
+                           (NULL != dst)                                &&
+                           (NULL != dst_size)                           &&
+                           (uAES_STREAM_DONE > stream->mode)))
+        {
+                if(0UL != stream->used)
+                {
+                        take = uAES_BLOCK_SIZE - stream->used;
+                        take = (size < take) ? (size) : (take);
+                        memcpy((void *)&stream->part[stream->used], (void *)src, take);
+                        stream->used += take;
+                        src += take;
+                        size -= take;
+                        if(uAES_BLOCK_SIZE == stream->used)
+                        {
+                                memcpy((void *)dst, (void *)stream->part, uAES_BLOCK_SIZE);
+                                uaes_stream_blocks(stream, dst, 1UL);
+                                stream->used = 0UL;
+                                out = uAES_BLOCK_SIZE;
+                        }
+                }
+
+                nblocks = size >> 4UL;
+                memmove((void *)&dst[out], (void *)src, uAES_BLOCK_SIZE * nblocks);
+                uaes_stream_blocks(stream, &dst[out], nblocks);
+                out += uAES_BLOCK_SIZE * nblocks;
+                src += uAES_BLOCK_SIZE * nblocks;
+                size -= uAES_BLOCK_SIZE * nblocks;
+
+                memcpy((void *)&stream->part[stream->used], (void *)src, size);
+                stream->used += size;
+                *dst_size = out;
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Completes a stream. Encryption zero pads the bytes left over into a last block, as the
+ *        one-shot functions do, decryption fails if the ciphertext was not a multiple of 16
+ *        bytes. The stream state is cleared either way.
+ * 
+ * @param stream                Pointer to stream state.
+ * @param dst                   Pointer to output buffer, holding at least 16 bytes.
+ * @param dst_size              Receives the number of bytes written to dst, 0 or 16.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_stream_final(uaes_stream_t *stream, uint8_t *dst, size_t *dst_size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != stream)                             &&
+                           (NULL != stream->ctx)                        &&
+                           (NULL != dst)                                &&
+                           (NULL != dst_size)                           &&
+                           (uAES_STREAM_DONE > stream->mode)))
+        {
+                *dst_size = 0UL;
+                err = 0;
+                if(0UL != stream->used)
+                {
+                        if((uAES_STREAM_ECB_ENC == stream->mode) || (uAES_STREAM_CBC_ENC == stream->mode))
+                        {
+                                memset((void *)&stream->part[stream->used], 0, uAES_BLOCK_SIZE - stream->used);
+                                memcpy((void *)dst, (void *)stream->part, uAES_BLOCK_SIZE);
+                                uaes_stream_blocks(stream, dst, 1UL);
+                                *dst_size = uAES_BLOCK_SIZE;
+                        }
+                        else
+                        {
+                                err = -1;
+                        }
+                }
+                uaes_memzero(stream, sizeof(uaes_stream_t));
+                stream->mode = uAES_STREAM_DONE;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Keys a GCM state with an initialised cipher context, computing the hash subkey and
+ *        the GHASH tables once. The context must outlive the GCM state.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param ctx                   Pointer to cipher context.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_init(uaes_gcm_t *gcm, uaes_ctx_t *ctx)
+{
+        int err = -1;
+        uint8_t h[uAES_BLOCK_SIZE] = { 0U };
+
+        if(uAES_PROF_CHECK((NULL != gcm) && (NULL != ctx) && (uAESRGE > ctx->aes_length)))
+        {
+                gcm->ctx = ctx;
+                uaes_ecb_foward(ctx, h, 1UL);
+                ghash_init(&gcm->hkey, h);
+                uaes_memzero(h, sizeof(h));
+                gcm->phase = uAES_GCM_DONE;
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Clears the hash subkey and message state held by a GCM state.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ */
+void uaes_gcm_wipe(uaes_gcm_t *gcm)
+{
+        if(NULL != gcm)
+        {
+                uaes_memzero(gcm, sizeof(uaes_gcm_t));
+                gcm->phase = uAES_GCM_DONE;
+        }
+        return;
+}
+
+/**
+ * @brief Starts a new message. A 12-byte IV is used as the nonce directly, IVs of any other
+ *        length are hashed into the pre-counter block.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param iv                    Pointer to initialisation vector, never reuse it with the same key.
+ * @param iv_size               Initialisation vector size, 12 bytes recommended.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_start(uaes_gcm_t *gcm, uint8_t *iv, size_t iv_size)
+{
+        int err = -1;
+        size_t nblocks = iv_size >> 4UL;
+
+        if(uAES_PROF_CHECK((NULL != gcm) && (NULL != gcm->ctx) && (NULL != iv) && (0 < iv_size)))
+        {
+                memset((void *)gcm->j0, 0, uAES_BLOCK_SIZE);
+                if(12UL == iv_size)
+                {
+                        memcpy((void *)gcm->j0, (void *)iv, iv_size);
+                        gcm->j0[15] = 0x01U;
+                }
+                else
+                {
+                        ghash_blocks(gcm->j0, iv, nblocks, &gcm->hkey);
+                        memset((void *)gcm->part, 0, uAES_BLOCK_SIZE);
+                        memcpy((void *)gcm->part, (void *)&iv[uAES_BLOCK_SIZE * nblocks], iv_size & uAES_BLOCK_ALIGN_MASK);
+                        if(0UL != (iv_size & uAES_BLOCK_ALIGN_MASK))
+                        {
+                                ghash_blocks(gcm->j0, gcm->part, 1UL, &gcm->hkey);
+                        }
+                        memset((void *)gcm->part, 0, uAES_BLOCK_SIZE);
+                        uaes_store64(&gcm->part[8], (uint64_t)iv_size << 3UL);
+                        ghash_blocks(gcm->j0, gcm->part, 1UL, &gcm->hkey);
+                }
+
+                memcpy((void *)gcm->ctr, (void *)gcm->j0, uAES_BLOCK_SIZE);
+                uaes_ctr_increment(gcm->ctr, uAES_GCM_CTR_SIZE);
+                memset((void *)gcm->xi, 0, uAES_BLOCK_SIZE);
+                gcm->aad_size = 0ULL;
+                gcm->msg_size = 0ULL;
+                gcm->phase = uAES_GCM_AAD;
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Adds additional authenticated data to the current message. May be called several
+ *        times with any length, but only before the first data update.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param aad                   Pointer to AAD buffer.
+ * @param aad_size              AAD buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_aad(uaes_gcm_t *gcm, uint8_t *aad, size_t aad_size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != gcm)                                        &&
+                           ((NULL != aad) || (0 == aad_size))                   &&
+                           (uAES_GCM_AAD == gcm->phase)                         &&
+                           ((uAES_GCM_MAX_AAD_SIZE - gcm->aad_size) >= aad_size)))
+        {
+                uaes_gcm_absorb(gcm, aad, aad_size);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Encrypts the next part of the current message in place. Parts may have any length.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param buf                   Pointer to plaintext buffer.
+ * @param size                  Plaintext buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_encrypt_update(uaes_gcm_t *gcm, uint8_t *buf, size_t size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != gcm)                                        &&
+                           ((NULL != buf) || (0 == size))                       &&
+                           (uAES_GCM_DONE != gcm->phase)                        &&
+                           ((uAES_GCM_MAX_MSG_SIZE - gcm->msg_size) >= size)))
+        {
+                if(uAES_GCM_AAD == gcm->phase)
+                {
+                        uaes_gcm_flush(gcm, gcm->aad_size);
+                        gcm->phase = uAES_GCM_MSG;
+                }
+                uaes_gcm_stream(gcm, buf, size, 0);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Decrypts the next part of the current message in place. Parts may have any length.
+ *        Decrypted data must not be trusted before uaes_gcm_verify() succeeds.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param buf                   Pointer to ciphertext buffer.
+ * @param size                  Ciphertext buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_decrypt_update(uaes_gcm_t *gcm, uint8_t *buf, size_t size)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != gcm)                                        &&
+                           ((NULL != buf) || (0 == size))                       &&
+                           (uAES_GCM_DONE != gcm->phase)                        &&
+                           ((uAES_GCM_MAX_MSG_SIZE - gcm->msg_size) >= size)))
+        {
+                if(uAES_GCM_AAD == gcm->phase)
+                {
+                        uaes_gcm_flush(gcm, gcm->aad_size);
+                        gcm->phase = uAES_GCM_MSG;
+                }
+                uaes_gcm_stream(gcm, buf, size, 1);
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Completes the current message and outputs its authentication tag.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param tag                   Pointer to tag buffer.
+ * @param tag_size              Tag length in bytes [4, 16], truncated tags keep the leading bytes.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_finish(uaes_gcm_t *gcm, uint8_t *tag, size_t tag_size)
+{
+        int err = -1;
+        uint8_t full[uAES_BLOCK_SIZE];
+
+        if(uAES_PROF_CHECK((NULL != gcm)                                &&
+                           (NULL != tag)                                &&
+                           (uAES_GCM_MIN_TAG_SIZE <= tag_size)          &&
+                           (uAES_BLOCK_SIZE >= tag_size)                &&
+                           (uAES_GCM_DONE != gcm->phase)))
+        {
+                uaes_gcm_tag(gcm, full);
+                memcpy((void *)tag, (void *)full, tag_size);
+                uaes_memzero(full, sizeof(full));
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Completes the current message and checks its authentication tag, the comparison
+ *        takes the same time wherever the tags differ.
+ * 
+ * @param gcm                   Pointer to GCM state.
+ * @param tag                   Pointer to received tag.
+ * @param tag_size              Tag length in bytes [4, 16].
+ * @return int                  [0] if the tag matches, [-1] on failure or mismatch.
+ */
+int uaes_gcm_verify(uaes_gcm_t *gcm, uint8_t *tag, size_t tag_size)
+{
+        int err = -1;
+        uint8_t full[uAES_BLOCK_SIZE];
+        uint8_t diff = 0U;
+
+        if(uAES_PROF_CHECK((NULL != gcm)                                &&
+                           (NULL != tag)                                &&
+                           (uAES_GCM_MIN_TAG_SIZE <= tag_size)          &&
+                           (uAES_BLOCK_SIZE >= tag_size)                &&
+                           (uAES_GCM_DONE != gcm->phase)))
+        {
+                uaes_gcm_tag(gcm, full);
+                for(size_t idx = 0UL; idx < tag_size; idx++)
+                {
+                        diff |= full[idx] ^ tag[idx];
+                }
+                uaes_memzero(full, sizeof(full));
+                err = (0U == diff) ? (0) : (-1);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Galois/Counter Mode authenticated encryption on given plaintext.
+ * 
+ * @param gcm                   Pointer to GCM state keyed by uaes_gcm_init().
+ * @param iv                    Pointer to initialisation vector.
+ * @param iv_size               Initialisation vector size, 12 bytes recommended.
+ * @param aad                   Pointer to additional authenticated data, may be NULL if aad_size is 0.
+ * @param aad_size              AAD buffer size.
+ * @param buf                   Pointer to plaintext buffer, may be NULL if size is 0.
+ * @param size                  Plaintext buffer size.
+ * @param tag                   Pointer to tag buffer.
+ * @param tag_size              Tag length in bytes [4, 16].
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_gcm_encrypt(uaes_gcm_t *gcm, 
+                     uint8_t *iv, 
+                     size_t iv_size, 
+                     uint8_t *aad, 
+                     size_t aad_size, 
+                     uint8_t *buf, 
+                     size_t size, 
+                     uint8_t *tag, 
+                     size_t tag_size)
+{
+        int err = uaes_gcm_start(gcm, iv, iv_size);
+
+        if(0 == err)
+        {
+                err = uaes_gcm_aad(gcm, aad, aad_size);
+        }
+        if(0 == err)
+        {
+                err = uaes_gcm_encrypt_update(gcm, buf, size);
+        }
+        if(0 == err)
+        {
+                err = uaes_gcm_finish(gcm, tag, tag_size);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Galois/Counter Mode authenticated decryption on given ciphertext. The
+ *        buffer is cleared when the tag does not match.
+ * 
+ * @param gcm                   Pointer to GCM state keyed by uaes_gcm_init().
+ * @param iv                    Pointer to initialisation vector.
+ * @param iv_size               Initialisation vector size.
+ * @param aad                   Pointer to additional authenticated data, may be NULL if aad_size is 0.
+ * @param aad_size              AAD buffer size.
+ * @param buf                   Pointer to ciphertext buffer, may be NULL if size is 0.
+ * @param size                  Ciphertext buffer size.
+ * @param tag                   Pointer to received tag.
+ * @param tag_size              Tag length in bytes [4, 16].
+ * @return int                  [0] if sucessful, [-1] on failure or tag mismatch.
+ */
+int uaes_gcm_decrypt(uaes_gcm_t *gcm, 
+                     uint8_t *iv, 
+                     size_t iv_size, 
+                     uint8_t *aad, 
+                     size_t aad_size, 
+                     uint8_t *buf, 
+                     size_t size, 
+                     uint8_t *tag, 
+                     size_t tag_size)
+{
+        int err = uaes_gcm_start(gcm, iv, iv_size);
+
+        if(0 == err)
+        {
+                err = uaes_gcm_aad(gcm, aad, aad_size);
+        }
+        if(0 == err)
+        {
+                err = uaes_gcm_decrypt_update(gcm, buf, size);
+        }
+        if(0 == err)
+        {
+                err = uaes_gcm_verify(gcm, tag, tag_size);
+                if((0 != err) && (NULL != buf))
+                {
+                        uaes_memzero(buf, size);
+                }
+        }
+
+        return err;
+}
+
+/**
+ * @brief Keys a CMAC state with an initialised cipher context, the K1 and K2 subkeys are
+ *        derived once and kept for every message. The state is ready for a first message.
+ *        The context must outlive the CMAC state.
+ * 
+ * @param cmac                  Pointer to CMAC state.
+ * @param ctx                   Pointer to cipher context.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cmac_init(uaes_cmac_t *cmac, uaes_ctx_t *ctx)
+{
+        int err = -1;
+        uint8_t l[uAES_BLOCK_SIZE] = { 0U };
+
+        if(uAES_PROF_CHECK((NULL != cmac) && (NULL != ctx) && (uAESRGE > ctx->aes_length)))
+        {
+                cmac->ctx = ctx;
+                uaes_ecb_foward(ctx, l, 1UL);
+                uaes_cmac_double(cmac->k1, l);
+                uaes_cmac_double(cmac->k2, cmac->k1);
+                uaes_memzero(l, sizeof(l));
+                err = uaes_cmac_start(cmac);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Clears the subkeys and message state held by a CMAC state.
+ * 
+ * @param cmac                  Pointer to CMAC state.
+ */
+void uaes_cmac_wipe(uaes_cmac_t *cmac)
+{
+        if(NULL != cmac)
+        {
+                uaes_memzero(cmac, sizeof(uaes_cmac_t));
+                cmac->phase = uAES_CMAC_DONE;
+        }
+        return;
+}
+
+/**
+ * @brief Starts a new message, discarding any message in progress.
+ * 
+ * @param cmac                  Pointer to CMAC state.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cmac_start(uaes_cmac_t *cmac)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != cmac) && (NULL != cmac->ctx)))
+        {
+                memset((void *)cmac->x, 0, uAES_BLOCK_SIZE);
+                uaes_memzero(cmac->part, uAES_BLOCK_SIZE);
+                cmac->used = 0UL;
+                cmac->phase = uAES_CMAC_MSG;
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Adds the next part of the current message, of any length. The last block is held back
+ *        until uaes_cmac_finish() since it is masked with a subkey.
+ * 
+ * @param cmac                  Pointer to CMAC state.
+ * @param msg                   Pointer to message buffer, may be NULL if size is 0.
+ * @param size                  Message buffer size.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cmac_update(uaes_cmac_t *cmac, uint8_t *msg, size_t size)
+{
+        int err = -1;
+        size_t take = 0UL;
+        size_t nblocks = 0UL;
+
+        if(uAES_PROF_CHECK((NULL != cmac)                               &&
+                           (NULL != cmac->ctx)                          &&
+                           ((NULL != msg) || (0UL == size))             &&
+                           (uAES_CMAC_MSG == cmac->phase)))
+        {
+                if((uAES_BLOCK_SIZE - cmac->used) < size)
+                {
+                        take = uAES_BLOCK_SIZE - cmac->used;
+                        memcpy((void *)&cmac->part[cmac->used], (void *)msg, take);
+                        uaes_cmac_blocks(cmac->ctx, cmac->x, cmac->part, 1UL);
+                        msg += take;
+                        size -= take;
+
+                        nblocks = (size - 1UL) >> 4UL;
+                        uaes_cmac_blocks(cmac->ctx, cmac->x, msg, nblocks);
+                        msg += uAES_BLOCK_SIZE * nblocks;
+                        size -= uAES_BLOCK_SIZE * nblocks;
+                        cmac->used = 0UL;
+                }
+                if(0UL < size)
+                {
+                        memcpy((void *)&cmac->part[cmac->used], (void *)msg, size);
+                        cmac->used += size;
+                }
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Completes the current message and writes its tag, truncated to its first tag_size
+ *        bytes.
+ * 
+ * @param cmac                  Pointer to CMAC state.
+ * @param tag                   Pointer to tag buffer.
+ * @param tag_size              Tag length in bytes [8, 16].
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cmac_finish(uaes_cmac_t *cmac, uint8_t *tag, size_t tag_size)
+{
+        int err = -1;
+        uint8_t full[uAES_BLOCK_SIZE];
+
+        if(uAES_PROF_CHECK((NULL != cmac)                               &&
+                           (NULL != cmac->ctx)                          &&
+                           (NULL != tag)                                &&
+                           (uAES_CMAC_MIN_TAG_SIZE <= tag_size)         &&
+                           (uAES_BLOCK_SIZE >= tag_size)                &&
+                           (uAES_CMAC_MSG == cmac->phase)))
+        {
+                uaes_cmac_tag(cmac, full);
+                memcpy((void *)tag, (void *)full, tag_size);
+                uaes_memzero(full, sizeof(full));
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Completes the current message and checks its tag, the comparison takes the same time
+ *        wherever the tags differ.
+ * 
+ * @param cmac                  Pointer to CMAC state.
+ * @param tag                   Pointer to received tag.
+ * @param tag_size              Tag length in bytes [8, 16].
+ * @return int                  [0] if the tag matches, [-1] on failure or mismatch.
+ */
+int uaes_cmac_verify(uaes_cmac_t *cmac, uint8_t *tag, size_t tag_size)
+{
+        int err = -1;
+        uint8_t full[uAES_BLOCK_SIZE];
+        uint8_t diff = 0U;
+
+        if(uAES_PROF_CHECK((NULL != cmac)                               &&
+                           (NULL != cmac->ctx)                          &&
+                           (NULL != tag)                                &&
+                           (uAES_CMAC_MIN_TAG_SIZE <= tag_size)         &&
+                           (uAES_BLOCK_SIZE >= tag_size)                &&
+                           (uAES_CMAC_MSG == cmac->phase)))
+        {
+                uaes_cmac_tag(cmac, full);
+                for(size_t idx = 0UL; idx < tag_size; idx++)
+                {
+                        diff |= full[idx] ^ tag[idx];
+                }
+                uaes_memzero(full, sizeof(full));
+                err = (0U == diff) ? (0) : (-1);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Computes the AES-CMAC tag of a message.
+ * 
+ * @param cmac                  Pointer to CMAC state keyed by uaes_cmac_init().
+ * @param msg                   Pointer to message buffer, may be NULL if size is 0.
+ * @param size                  Message buffer size.
+ * @param tag                   Pointer to tag buffer.
+ * @param tag_size              Tag length in bytes [8, 16].
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cmac(uaes_cmac_t *cmac, uint8_t *msg, size_t size, uint8_t *tag, size_t tag_size)
+{
+        int err = uaes_cmac_start(cmac);
+
+        if(0 == err)
+        {
+                err = uaes_cmac_update(cmac, msg, size);
+        }
+        if(0 == err)
+        {
+                err = uaes_cmac_finish(cmac, tag, tag_size);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Checks the AES-CMAC tag of a received message.
+ * 
+ * @param cmac                  Pointer to CMAC state keyed by uaes_cmac_init().
+ * @param msg                   Pointer to message buffer, may be NULL if size is 0.
+ * @param size                  Message buffer size.
+ * @param tag                   Pointer to received tag.
+ * @param tag_size              Tag length in bytes [8, 16].
+ * @return int                  [0] if the tag matches, [-1] on failure or mismatch.
+ */
+int uaes_cmac_check(uaes_cmac_t *cmac, uint8_t *msg, size_t size, uint8_t *tag, size_t tag_size)
+{
+        int err = uaes_cmac_start(cmac);
+
+        if(0 == err)
+        {
+                err = uaes_cmac_update(cmac, msg, size);
+        }
+        if(0 == err)
+        {
+                err = uaes_cmac_verify(cmac, tag, tag_size);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Computes the AES-CMAC tags of independent messages at once. Each CMAC is serial, so
+ *        messages are advanced in lock-step to keep the block engine busy, and a lane is
+ *        refilled as soon as its message ends. Messages may use different keys and key lengths
+ *        and may share a CMAC state, whose current message is left untouched. Fails without
+ *        computing any tag if any job is invalid.
+ * 
+ * @param jobs                  Pointer to messages.
+ * @param njobs                 Number of messages.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cmac_mb(uaes_cmac_job_t *jobs, size_t njobs)
+{
+        int err = -1;
+        size_t idx = 0UL;
+
+        if(uAES_PROF_CHECK((NULL != jobs) && (0UL < njobs)))
+        {
+                for(idx = 0UL; idx < njobs; idx++)
+                {
+                        if(uAES_PROF_CHECK( (NULL == jobs[idx].cmac)                            ||
+                                            (NULL == jobs[idx].cmac->ctx)                       ||
+                                            ((NULL == jobs[idx].msg) && (0UL != jobs[idx].size))||
+                                            (uAES_MAX_INPUT_SIZE < jobs[idx].size)              ||
+                                            (NULL == jobs[idx].tag)                             ||
+                                            (uAES_CMAC_MIN_TAG_SIZE > jobs[idx].tag_size)       ||
+                                            (uAES_BLOCK_SIZE < jobs[idx].tag_size)              ||
+                                            (uAESRGE <= jobs[idx].cmac->ctx->aes_length) ))
+                        {
+                                break;
+                        }
+                }
+                if(njobs == idx)
+                {
+                        uaes_mb_cmac(jobs, njobs, 10UL);
+                        uaes_mb_cmac(jobs, njobs, 12UL);
+                        uaes_mb_cmac(jobs, njobs, 14UL);
+                        err = 0;
+                }
+        }
+        return err;
+}
+
+/**
+ * @brief Keys an XTS state with two initialised cipher contexts, the data key and the tweak
+ *        key. IEEE 1619 defines XTS-AES-128 and XTS-AES-256 only, both keys must have the same
+ *        length and should differ. The contexts must outlive the XTS state.
+ * 
+ * @param xts                   Pointer to XTS state.
+ * @param ctx                   Pointer to data key context.
+ * @param tctx                  Pointer to tweak key context.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_xts_init(uaes_xts_t *xts, uaes_ctx_t *ctx, uaes_ctx_t *tctx)
+{
+        int err = -1;
+
+        if(uAES_PROF_CHECK((NULL != xts)                                &&
+                           (NULL != ctx)                                &&
+                           (NULL != tctx)                               &&
+                           (ctx != tctx)                                &&
+                           ((uAES128 == ctx->aes_length) || (uAES256 == ctx->aes_length)) &&
+                           (ctx->aes_length == tctx->aes_length)))
+        {
+                xts->ctx = ctx;
+                xts->tctx = tctx;
+                err = 0;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs XTS-AES encryption on one data unit, a last partial block is handled with
+ *        ciphertext stealing.
+ * 
+ * @param xts                   Pointer to XTS state keyed by uaes_xts_init().
+ * @param tweak                 16-Byte tweak, the little-endian data unit number.
+ * @param buf                   Pointer to plaintext buffer.
+ * @param size                  Plaintext buffer size, 16 bytes to 16 MB.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_xts_encrypt(uaes_xts_t *xts, uint8_t *tweak, uint8_t *buf, size_t size)
+{
+        int err = uaes_xts_valid(xts, buf, size, 1UL);
+        uint8_t tw[uAES_BLOCK_SIZE];
+        uint64_t t[2];
+
+        if(uAES_PROF_CHECK((0 == err) && (NULL != tweak)))
+        {
+                memcpy((void *)tw, (void *)tweak, uAES_BLOCK_SIZE);
+                uaes_ecb_foward(xts->tctx, tw, 1UL);
+                uaes_xts_load(tw, t);
+                uaes_xts_unit(xts->ctx, buf, size, t, 0);
+                uaes_memzero(tw, sizeof(tw));
+                uaes_memzero(t, sizeof(t));
+        }
+        else
+        {
+                err = -1;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs XTS-AES decryption on one data unit.
+ * 
+ * @param xts                   Pointer to XTS state keyed by uaes_xts_init().
+ * @param tweak                 16-Byte tweak, the little-endian data unit number.
+ * @param buf                   Pointer to ciphertext buffer.
+ * @param size                  Ciphertext buffer size, 16 bytes to 16 MB.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_xts_decrypt(uaes_xts_t *xts, uint8_t *tweak, uint8_t *buf, size_t size)
+{
+        int err = uaes_xts_valid(xts, buf, size, 1UL);
+        uint8_t tw[uAES_BLOCK_SIZE];
+        uint64_t t[2];
+
+        if(uAES_PROF_CHECK((0 == err) && (NULL != tweak)))
+        {
+                memcpy((void *)tw, (void *)tweak, uAES_BLOCK_SIZE);
+                uaes_ecb_foward(xts->tctx, tw, 1UL);
+                uaes_xts_load(tw, t);
+                uaes_xts_unit(xts->ctx, buf, size, t, 1);
+                uaes_memzero(tw, sizeof(tw));
+                uaes_memzero(t, sizeof(t));
+        }
+        else
+        {
+                err = -1;
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs XTS-AES encryption on consecutive sectors, the sector at buf + i * sector_size
+ *        is the data unit numbered sector + i.
+ * 
+ * @param xts                   Pointer to XTS state keyed by uaes_xts_init().
+ * @param sector                Data unit number of the first sector.
+ * @param buf                   Pointer to first sector.
+ * @param sector_size           Sector size in bytes, 16 bytes to 16 MB.
+ * @param nsectors              Number of sectors.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_xts_encrypt_sectors(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors)
+{
+        int err = uaes_xts_valid(xts, buf, sector_size, nsectors);
+
+        if(0 == err)
+        {
+                uaes_xts_sectors(xts, sector, buf, sector_size, nsectors, 0);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs XTS-AES decryption on consecutive sectors.
+ * 
+ * @param xts                   Pointer to XTS state keyed by uaes_xts_init().
+ * @param sector                Data unit number of the first sector.
+ * @param buf                   Pointer to first sector.
+ * @param sector_size           Sector size in bytes, 16 bytes to 16 MB.
+ * @param nsectors              Number of sectors.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_xts_decrypt_sectors(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors)
+{
+        int err = uaes_xts_valid(xts, buf, sector_size, nsectors);
+
+        if(0 == err)
+        {
+                uaes_xts_sectors(xts, sector, buf, sector_size, nsectors, 1);
+        }
+
+        return err;
+}
+
+#ifdef __uAES_PTHREAD__
+/**
+ * @brief Starts the worker pool used by the uaes_ctx_*_mt functions. Must not be called while
+ *        a multi-threaded call is in progress.
+ * 
+ * @param nthreads              Threads working on a buffer, including the calling thread.
+ * @param threshold             Buffers smaller than this many bytes are processed on the
+ *                              calling thread, uAES_MT_THRESHOLD is a sensible default.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_pool_init(size_t nthreads, size_t threshold)
+{
+        int err = mthread_init(nthreads);
+
+        if(0 == err)
+        {
+                mt_threshold = threshold;
+        }
+
+        return err;
+}
 
-uint8_t uaes_set_trace_msk(unsigned char msk)
+/**
+ * @brief Stops the worker pool, uaes_ctx_*_mt calls fall back to the calling thread.
+ */
+void uaes_pool_destroy(void)
 {
-        return 0;
+        mthread_destroy();
+        return;
 }
-#endif /*__uAES_DEBUG__*/
 
-static size_t uaes_strnlen(char *str, size_t lim)
+/**
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
+ * 
+ * @brief Performs AES Electronic Code Book encryption on given plaintext across the worker pool.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Size of plaintext buffer.
+ * @return int                  [0] if sucessful, [-1] on failure. 
+ */
+int uaes_ctx_ecb_encryption_mt(uaes_ctx_t *ctx, 
+                               uint8_t *plaintext, 
+                               size_t plaintext_size)
 {
-        size_t s = 0UL;
-        if(NULL != str)
+        int err = -1;
+        size_t offset = plaintext_size;
+
+        if(0 != (plaintext_size & uAES_BLOCK_ALIGN_MASK))
+        {
+                offset = uAES_ALIGN(plaintext_size, uAES_BLOCK_ALIGN);
+        }
+
+        offset >>= 4UL;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                &&
+                           (NULL != plaintext)                          && 
+                           (0 < plaintext_size)                         && 
+                           (uAES_MAX_INPUT_SIZE >= plaintext_size)      && 
+                           (uAESRGE > ctx->aes_length)))
         {
-                for(; ((s < lim) && (str[s] != 0x00)); s++);
+                uaes_mt_run(ctx, plaintext, offset, uAES_MT_ECB_ENC, NULL);
+                err = 0;
         }
-        return s;
+
+        return err;
 }
 
 /**
- * @brief Performs XOR operation between initialisation vector and data block
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK.
  * 
- * @param block Pointer to data block.
- * @param iv    Pointer to initialisation vector.
+ * @brief Performs AES-ECB decryption on given ciphertext across the worker pool.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Size of ciphertext buffer.
+ * @return int                  [0] if sucessful, [-1] on failure.
  */
-static void uaes_xor_iv(void *block, void *iv)
+int uaes_ctx_ecb_decryption_mt(uaes_ctx_t *ctx, 
+                               uint8_t *ciphertext, 
+                               size_t ciphertext_size)
 {
-        uint32_t *p_blk = block;
-        uint32_t *p_iv = iv;
-        
-        p_blk[0] ^= p_iv[0];
-        p_blk[1] ^= p_iv[1];
-        p_blk[2] ^= p_iv[2];
-        p_blk[3] ^= p_iv[3];
+        int err = -1;
+        size_t offset = ciphertext_size;
+
+        if(0 != (ciphertext_size & uAES_BLOCK_ALIGN_MASK))
+        {
+                offset = uAES_ALIGN(ciphertext_size, uAES_BLOCK_ALIGN);
+        }
         
-        return;
+        offset >>= 4UL;
+
+        if(uAES_PROF_CHECK((NULL != ctx)                                && 
+                           (NULL != ciphertext)                         && 
+                           (0 < ciphertext_size)                        && 
+                           (uAES_MAX_INPUT_SIZE >= ciphertext_size)     && 
+                           (uAESRGE > ctx->aes_length)))
+        {
+                uaes_mt_run(ctx, ciphertext, offset, uAES_MT_ECB_DEC, NULL);
+                err = 0;
+        }
+
+        return err;
 }
 
 /**
- * @brief Computes foward cipher encryption on provided buffer.
- * @param data  Pointer to data buffer.
- * @param kschd Pointer to key schedule buffer generated by key expansion algorithm. 
- * @param Nk    Key length in 32-bit words.
- * @param Nb    Block length in 32-bit words.
- * @param Nr    Number of encryption rounds.
- * @return int If successful returns a 0, otherwise -1 will be returned.
+ * @brief Performs AES Cipher Block Chaining decryption on given ciphertext across the worker
+ *        pool. Every plaintext block only depends on two ciphertext blocks, so chunks are
+ *        independent once the ciphertext block preceding each of them is saved.
+ * 
+ * @param ctx                   Pointer to cipher context.
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @param iv                    16-Byte initialisation vector.
+ * @return int                  [0] if sucessful, [-1] on failure.
  */
-static void uaes_foward_cipher(uint8_t *buf, uint32_t *kschd, size_t Nk, size_t Nb, size_t Nr)
+int uaes_ctx_cbc_decryption_mt(uaes_ctx_t *ctx, 
+                               uint8_t *ciphertext, 
+                               size_t ciphertext_size, 
+                               uint8_t *iv)
 {
-        uint8_t block[ uAES_BLOCK_SIZE ] = {0U};
+        int err = -1;
+        size_t offset = ciphertext_size;
 
-        memcpy((void *)block, (void *)buf, uAES_BLOCK_SIZE);
+        if(0 != (ciphertext_size & uAES_BLOCK_ALIGN_MASK))
+        {
+                offset = uAES_ALIGN(ciphertext_size, uAES_BLOCK_ALIGN);
+        }
+        
+        offset >>= 4UL; 
 
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].block = ", block, 0UL);
-        add_round_key(block, kschd, 0, Nb);
-        for( size_t round = 1; round < Nr; round++ )
+        if(uAES_PROF_CHECK( (NULL != ctx)                               && 
+                            (NULL != ciphertext)                        &&
+                            (NULL != iv)                                && 
+                            (0 < ciphertext_size)                       && 
+                            (uAES_MAX_INPUT_SIZE >= ciphertext_size)    && 
+                            (uAESRGE > ctx->aes_length) ))
         {
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].start = ", block, round);
-                sub_block(block, Nb);
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].s_box = ", block, round);
-                shift_rows(block, Nb);
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].sh_row = ", block, round);
-                mix_columns(block, Nb);
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].m_col = ", block, round);
-                add_round_key(block, kschd, round, Nb);
+                uaes_mt_run(ctx, ciphertext, offset, uAES_MT_CBC_DEC, iv);
+                err = 0;
         }
-        sub_block(block, Nb);
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].s_box = ", block, Nr);
-        shift_rows(block, Nb);
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].sh_row = ", block, Nr);
-        add_round_key(block, kschd, Nr, Nb);
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].end = ", block, Nr);
-        memcpy((void *)buf, (void *)block, uAES_BLOCK_SIZE);
-        return;
+
+        return err;
 }
 
 /**
- * @brief       Computes inverse cipher decryption on provided buffer.
- * @param data  Pointer to ciphertext buffer.
- * @param kschd Pointer to key schedule buffer generated by key expansion algorithm. 
- * @param Nk    Number of 32-bit words in a key.
- * @param Nb    Number of 32-bit words in a block.
- * @param Nr    Number of rounds.
+ * @brief Performs XTS-AES encryption on consecutive sectors across the worker pool, sectors are
+ *        independent and are handed out in groups of about uAES_MT_CHUNK_SIZE bytes.
+ * 
+ * @param xts                   Pointer to XTS state keyed by uaes_xts_init().
+ * @param sector                Data unit number of the first sector.
+ * @param buf                   Pointer to first sector.
+ * @param sector_size           Sector size in bytes, 16 bytes to 16 MB.
+ * @param nsectors              Number of sectors.
+ * @return int                  [0] if sucessful, [-1] on failure.
  */
-static void uaes_inverse_cipher( uint8_t *buf, uint32_t *kschd, size_t Nk, size_t Nb, size_t Nr)
+int uaes_xts_encrypt_sectors_mt(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors)
 {
-        uint8_t block[uAES_BLOCK_SIZE] = {0U};
-
-        memcpy((void *) block, (void *) buf, uAES_BLOCK_SIZE);
+        int err = uaes_xts_valid(xts, buf, sector_size, nsectors);
 
-        uAES_TRACE_BLOCK( uAES_TRACE_MSK_INV, "round[%lu].block = ", block, Nr);
-        add_round_key(block, kschd, Nr, Nb);
-        for(size_t round = Nr - 1; round > 0; round--)
+        if(0 == err)
         {
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].start = ", block, round);
-                inv_shift_rows(block, Nb);
-                uAES_TRACE_BLOCK( uAES_TRACE_MSK_INV, "round[%lu].inv_sh_row = ", block, round);
-                inv_sub_block(block, Nb);
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].inv_s_box = ", block, round);
-                add_round_key(block, kschd, round, Nb);
-                uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].add_rkey = ", block, round);
-                inv_mix_columns(block, Nb);
+                uaes_mt_xts_run(xts, sector, buf, sector_size, nsectors, 0);
         }
-        inv_shift_rows(block, Nb );
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].inv_sh_row = ", block, 0UL);
-        inv_sub_block(block, Nb );
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_INV, "round[%lu].inv_s_box = ", block, 0UL);
-        add_round_key(block, kschd, 0, Nb );
-        uAES_TRACE_BLOCK(uAES_TRACE_MSK_FWD, "round[%lu].end = ", block, 0UL);
 
-        memcpy((void *)buf, (void *)block, uAES_BLOCK_SIZE);  
+        return err;
+}
 
-        return;
+/**
+ * @brief Performs XTS-AES decryption on consecutive sectors across the worker pool.
+ * 
+ * @param xts                   Pointer to XTS state keyed by uaes_xts_init().
+ * @param sector                Data unit number of the first sector.
+ * @param buf                   Pointer to first sector.
+ * @param sector_size           Sector size in bytes, 16 bytes to 16 MB.
+ * @param nsectors              Number of sectors.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_xts_decrypt_sectors_mt(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors)
+{
+        int err = uaes_xts_valid(xts, buf, sector_size, nsectors);
+
+        if(0 == err)
+        {
+                uaes_mt_xts_run(xts, sector, buf, sector_size, nsectors, 1);
+        }
+
+        return err;
 }
+#endif /*__uAES_PTHREAD__*/
 
 /**
  * @brief Performs AES Cipher Block Chaining encryption on given plaintext.
@@ -190,42 +3825,15 @@ int uaes_cbc_encryption(uint8_t *plaintext,
                         aes_length_t aes_length)
 {
         int err = -1;
-        uint32_t kschd[uAES_MAX_KSCHD_SIZE] = {0U};
-        size_t Nk, Nb, Nr, idx = 0UL, offset = plaintext_size;
+        uAES_SCRATCH_CTX(ctx);
 
-        if(0 != (plaintext_size & uAES_BLOCK_ALIGN_MASK))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
         {
-                offset = uAES_ALIGN(plaintext_size, uAES_BLOCK_ALIGN);
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_cbc_encryption(ctx, plaintext, plaintext_size, iv);
+                uaes_wipe(ctx);
         }
 
-        offset >>= 4UL; 
-        
-        Nb = 4UL;
-        Nk = Nb + (aes_length * 2UL);
-        Nr = Nb + (aes_length * 2UL);
-        
-        if( (NULL != key)                               && 
-            (NULL != plaintext)                         &&
-            (NULL != iv)                                && 
-            (0 < plaintext_size)                        && 
-            (uAES_MAX_INPUT_SIZE >= plaintext_size)     && 
-            (uAESRGE > aes_length) )
-        {
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                uaes_xor_iv(plaintext, iv);
-                uaes_foward_cipher(&plaintext[uAES_BLOCK_SIZE * idx], kschd, Nk, Nb, Nr);
-                idx++;
-
-                while(offset > idx)
-                {
-                        uaes_xor_iv(&plaintext[uAES_BLOCK_SIZE * idx], &plaintext[uAES_BLOCK_SIZE * (idx - 1)]);
-                        uaes_foward_cipher(&plaintext[ uAES_BLOCK_SIZE * idx ], kschd, Nk, Nb, Nr);
-                        idx++;
-                }
-
-                err = 0;
-        }
-        
         return err;
 }
 
@@ -246,39 +3854,189 @@ int uaes_cbc_decryption(uint8_t *ciphertext,
                         aes_length_t aes_length)
 {
         int err = -1;
-        uint32_t kschd[uAES_MAX_KSCHD_SIZE] = {0UL};
-        size_t Nk, Nb, Nr, idx = 0UL, offset = ciphertext_size;
+        uAES_SCRATCH_CTX(ctx);
 
-        if(0 != ( ciphertext_size & uAES_BLOCK_ALIGN_MASK))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
         {
-          offset = uAES_ALIGN(ciphertext_size, uAES_BLOCK_ALIGN);
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_DEC);
+                err = uaes_ctx_cbc_decryption(ctx, ciphertext, ciphertext_size, iv);
+                uaes_wipe(ctx);
         }
-        
-        offset >>= 4UL; 
-        
-        Nb = 4UL;
-        Nk = Nb + (aes_length * 2UL);
-        Nr = Nb + (aes_length * 2UL);
 
-        if( (NULL != key)                               && 
-            (NULL != ciphertext)                        &&
-            (NULL != iv)                                && 
-            (0 < ciphertext_size)                       && 
-            (uAES_MAX_INPUT_SIZE >= ciphertext_size)    && 
-            (uAESRGE > aes_length) )
+        return err;
+}
+
+/**
+ * @brief Performs AES Counter mode encryption or decryption on given buffer.
+ * 
+ * @param buf                   Pointer to plaintext/ciphertext buffer.
+ * @param size                  Buffer size.
+ * @param key                   Pointer to key buffer.
+ * @param ctr                   16-Byte counter block, nonce followed by a big-endian counter.
+ * @param ctr_size              Counter length in bytes [1, 16].
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ctr_xcrypt(uint8_t *buf, 
+                    size_t size, 
+                    uint8_t *key, 
+                    uint8_t *ctr, 
+                    size_t ctr_size, 
+                    aes_length_t aes_length)
+{
+        int err = -1;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
         {
-                idx = offset - 1UL;
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                while(idx > 0)
-                {
-                        uaes_inverse_cipher(&ciphertext[uAES_BLOCK_SIZE * idx], kschd, Nk, Nb, Nr);
-                        uaes_xor_iv(&ciphertext[uAES_BLOCK_SIZE * idx], &ciphertext[uAES_BLOCK_SIZE * (idx - 1)]);
-                        idx--;
-                }
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_ctr_xcrypt(ctx, buf, size, ctr, ctr_size);
+                uaes_wipe(ctx);
+        }
 
-                uaes_inverse_cipher(&ciphertext[uAES_BLOCK_SIZE * idx], kschd, Nk, Nb, Nr);
-                uaes_xor_iv(&ciphertext[uAES_BLOCK_SIZE * idx], iv);
-                err = 0;
+        return err;
+}
+
+/**
+ * @brief Performs AES Propagating Cipher Block Chaining encryption on given plaintext.
+ * 
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Plaintext buffer size.
+ * @param key                   Pointer to key buffer.
+ * @param iv                    16-Byte initialisation vector.
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_pcbc_encryption(uint8_t *plaintext, 
+                         size_t plaintext_size, 
+                         uint8_t *key, 
+                         uint8_t *iv, 
+                         aes_length_t aes_length)
+{
+        int err = -1;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
+        {
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_pcbc_encryption(ctx, plaintext, plaintext_size, iv);
+                uaes_wipe(ctx);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Propagating Cipher Block Chaining decryption on given ciphertext.
+ * 
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @param key                   Pointer to key buffer.
+ * @param iv                    16-Byte initialisation vector.
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_pcbc_decryption(uint8_t *ciphertext, 
+                         size_t ciphertext_size, 
+                         uint8_t *key, 
+                         uint8_t *iv, 
+                         aes_length_t aes_length)
+{
+        int err = -1;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
+        {
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_DEC);
+                err = uaes_ctx_pcbc_decryption(ctx, ciphertext, ciphertext_size, iv);
+                uaes_wipe(ctx);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES 128-bit Cipher Feedback encryption on given plaintext.
+ * 
+ * @param plaintext             Pointer to plaintext buffer.
+ * @param plaintext_size        Plaintext buffer size.
+ * @param key                   Pointer to key buffer.
+ * @param iv                    16-Byte initialisation vector, updated to the last ciphertext block.
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cfb_encryption(uint8_t *plaintext, 
+                        size_t plaintext_size, 
+                        uint8_t *key, 
+                        uint8_t *iv, 
+                        aes_length_t aes_length)
+{
+        int err = -1;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
+        {
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_cfb_encryption(ctx, plaintext, plaintext_size, iv);
+                uaes_wipe(ctx);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES 128-bit Cipher Feedback decryption on given ciphertext.
+ * 
+ * @param ciphertext            Pointer to ciphertext buffer.
+ * @param ciphertext_size       Ciphertext buffer size.
+ * @param key                   Pointer to key buffer.
+ * @param iv                    16-Byte initialisation vector, updated to the last ciphertext block.
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_cfb_decryption(uint8_t *ciphertext, 
+                        size_t ciphertext_size, 
+                        uint8_t *key, 
+                        uint8_t *iv, 
+                        aes_length_t aes_length)
+{
+        int err = -1;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
+        {
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_cfb_decryption(ctx, ciphertext, ciphertext_size, iv);
+                uaes_wipe(ctx);
+        }
+
+        return err;
+}
+
+/**
+ * @brief Performs AES Output Feedback encryption or decryption on given buffer.
+ * 
+ * @param buf                   Pointer to plaintext/ciphertext buffer.
+ * @param size                  Buffer size.
+ * @param key                   Pointer to key buffer.
+ * @param iv                    16-Byte initialisation vector, updated to the last keystream block.
+ * @param aes_length            Encryption/Decryption key length.
+ * @return int                  [0] if sucessful, [-1] on failure.
+ */
+int uaes_ofb_xcrypt(uint8_t *buf, 
+                    size_t size, 
+                    uint8_t *key, 
+                    uint8_t *iv, 
+                    aes_length_t aes_length)
+{
+        int err = -1;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
+        {
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_ofb_xcrypt(ctx, buf, size, iv);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -301,33 +4059,13 @@ int uaes_ecb_encryption(uint8_t *plaintext,
                         aes_length_t aes_length)
 {
         int err = -1;
-        uint32_t kschd[uAES_MAX_KSCHD_SIZE] = {0UL};
-        size_t Nk, Nb, Nr, idx = 0UL, offset = plaintext_size;
-
-        if(0 != (plaintext_size & uAES_BLOCK_ALIGN_MASK))
-        {
-                offset = uAES_ALIGN( plaintext_size, uAES_BLOCK_ALIGN );
-        }
-
-        offset >>= 4UL;
+        uAES_SCRATCH_CTX(ctx);
 
-        Nb = 4UL;
-        Nk = Nb + (aes_length * 2UL);
-        Nr = Nb + (aes_length * 2UL);
-
-        if((NULL != key)                                &&
-           (NULL != plaintext)                          && 
-           (0 < plaintext_size)                         && 
-           (uAES_MAX_INPUT_SIZE >= plaintext_size)      && 
-           (uAESRGE > aes_length))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
         {
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                while(offset > idx)
-                {
-                        uaes_foward_cipher(&plaintext[uAES_BLOCK_SIZE * idx], kschd, Nk, Nb, Nr);
-                        idx++;
-                }
-                err = 0;
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_ENC);
+                err = uaes_ctx_ecb_encryption(ctx, plaintext, plaintext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -350,33 +4088,13 @@ int uaes_ecb_decryption(uint8_t *ciphertext,
                         aes_length_t aes_length)
 {
         int err = -1;
-        uint32_t kschd[ uAES_MAX_KSCHD_SIZE ] = {0UL};
-        size_t Nk, Nb, Nr, idx = 0UL, offset = ciphertext_size;
-
-        if(0 != ( ciphertext_size & uAES_BLOCK_ALIGN_MASK ) )
-        {
-                offset = uAES_ALIGN( ciphertext_size, uAES_BLOCK_ALIGN );
-        }
-        
-        offset >>= 4UL;
-
-        Nb = 4UL;
-        Nk = Nb + (aes_length * 2UL);
-        Nr = Nb + (aes_length * 2UL);
+        uAES_SCRATCH_CTX(ctx);
 
-        if((NULL != key)                                && 
-           (NULL != ciphertext)                         && 
-           (0 < ciphertext_size)                        && 
-           (uAES_MAX_INPUT_SIZE >= ciphertext_size)     && 
-           (uAESRGE > aes_length))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key) && (uAESRGE > aes_length)))
         {
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                while(offset > idx)
-                {
-                        uaes_inverse_cipher(&ciphertext[uAES_BLOCK_SIZE * idx], kschd, Nk, Nb, Nr);
-                        idx++;
-                }
-                err = 0;
+                uaes_ctx_load(ctx, key, aes_length, uAES_CTX_DEC);
+                err = uaes_ctx_ecb_decryption(ctx, ciphertext, ciphertext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -393,14 +4111,13 @@ int uaes_ecb_decryption(uint8_t *ciphertext,
 int uaes128enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size)
 {
         int err = -1;
-        const size_t Nk = 4, Nb = 4, Nr = 10;
-        uint32_t kschd[uAES128_KSCHD_SIZE] = {0UL};
+        uAES_SCRATCH_CTX(ctx);
 
-        if((NULL != key) && (NULL != plaintext) && (0 < plaintext_size) && (uAES_BLOCK_SIZE >= plaintext_size))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key)))
         {
-                err = 0;
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                uaes_foward_cipher(plaintext, kschd, Nk, Nb, Nr);
+                uaes_ctx_load(ctx, key, uAES128, uAES_CTX_ENC);
+                err = uaes_ctx_block_encryption(ctx, plaintext, plaintext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -417,14 +4134,13 @@ int uaes128enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size)
 int uaes192enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size)
 {
         int err = -1;
-        const size_t Nk = 6, Nb = 4, Nr = 12;
-        uint32_t kschd[uAES192_KSCHD_SIZE] = {0UL};
+        uAES_SCRATCH_CTX(ctx);
 
-        if((NULL != key) && (NULL != plaintext) && (0 < plaintext_size) && (uAES_BLOCK_SIZE >= plaintext_size))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key)))
         {
-                err = 0;
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                uaes_foward_cipher(plaintext, kschd, Nk, Nb, Nr);
+                uaes_ctx_load(ctx, key, uAES192, uAES_CTX_ENC);
+                err = uaes_ctx_block_encryption(ctx, plaintext, plaintext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -441,14 +4157,13 @@ int uaes192enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size)
 int uaes256enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size)
 {
         int err = -1;
-        const size_t Nk = 8, Nb = 4, Nr = 14;
-        uint32_t kschd[uAES256_KSCHD_SIZE] = {0UL};
+        uAES_SCRATCH_CTX(ctx);
 
-        if((NULL != key) && (NULL != plaintext) && (0 < plaintext_size) && (uAES_BLOCK_SIZE >= plaintext_size))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key)))
         {
-                err = 0;
-                key_expansion( key, kschd, Nk, ( Nb * ( Nr + 1 ) ) );
-                uaes_foward_cipher( plaintext, kschd, Nk, Nb, Nr );
+                uaes_ctx_load(ctx, key, uAES256, uAES_CTX_ENC);
+                err = uaes_ctx_block_encryption(ctx, plaintext, plaintext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -465,14 +4180,13 @@ int uaes256enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size)
 extern int uaes128dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size)
 {
         int err = -1;
-        const size_t Nk = 4, Nb = 4, Nr = 10;
-        uint32_t kschd[uAES128_KSCHD_SIZE] = {0UL};
+        uAES_SCRATCH_CTX(ctx);
 
-        if((NULL != key) && (NULL != ciphertext) && (0 < ciphertext_size) && (uAES_BLOCK_SIZE >= ciphertext_size))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key)))
         {
-                err = 0;
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                uaes_inverse_cipher(ciphertext, kschd, Nk, Nb, Nr);
+                uaes_ctx_load(ctx, key, uAES128, uAES_CTX_DEC);
+                err = uaes_ctx_block_decryption(ctx, ciphertext, ciphertext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -489,14 +4203,13 @@ extern int uaes128dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size)
 extern int uaes192dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size)
 {
         int err = -1;
-        const size_t Nk = 6, Nb = 4, Nr = 12;
-        uint32_t kschd[uAES192_KSCHD_SIZE] = {0UL};
-        
-        if((NULL != key) && (NULL != ciphertext) && (0 < ciphertext_size) && (uAES_BLOCK_SIZE >= ciphertext_size))
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key)))
         {
-              err = 0;
-              key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-              uaes_inverse_cipher(ciphertext, kschd, Nk, Nb, Nr);
+                uaes_ctx_load(ctx, key, uAES192, uAES_CTX_DEC);
+                err = uaes_ctx_block_decryption(ctx, ciphertext, ciphertext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
@@ -513,16 +4226,97 @@ extern int uaes192dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size)
 extern int uaes256dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size)
 {
         int err = -1;
-        const size_t Nk = 8, Nb = 4, Nr = 14;
-        uint32_t kschd[uAES256_KSCHD_SIZE] = {0UL};
+        uAES_SCRATCH_CTX(ctx);
 
-        if((NULL != key) && (NULL != ciphertext) && (0 < ciphertext_size) && (uAES_BLOCK_SIZE >= ciphertext_size))
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != key)))
         {
-                err = 0;
-                key_expansion(key, kschd, Nk, (Nb * (Nr + 1)));
-                uaes_inverse_cipher(ciphertext, kschd, Nk, Nb, Nr);
+                uaes_ctx_load(ctx, key, uAES256, uAES_CTX_DEC);
+                err = uaes_ctx_block_decryption(ctx, ciphertext, ciphertext_size);
+                uaes_wipe(ctx);
         }
 
         return err;
 }
 
+/**
+ * @brief Processes a batch of independent messages, each with its own operation, key and IV,
+ *        with the cost of a single one-shot call spread over the batch. One context holds
+ *        the key schedules of the whole batch, a key is only expanded when it differs from
+ *        the previous job's, and the context is wiped once at the end. Every job is checked
+ *        on its own, an invalid job gets status [-1] and the others are still processed.
+ * 
+ * @param jobs                  Pointer to jobs, status is written to every job.
+ * @param njobs                 Number of jobs.
+ * @return int                  [0] if every job was processed, [-1] otherwise.
+ */
+int uaes_batch(uaes_job_t *jobs, size_t njobs)
+{
+        int err = -1;
+        uint8_t key[uAES_MAX_KEY_SIZE] = {0U};
+        aes_length_t key_length = uAESRGE;
+        unsigned int dirs = 0U, need = 0U;
+        size_t idx = 0UL, key_size = 0UL;
+        uaes_job_t *job = NULL;
+        uAES_SCRATCH_CTX(ctx);
+
+        if(uAES_PROF_CHECK((NULL != ctx) && (NULL != jobs)))
+        {
+                err = 0;
+                for(idx = 0UL; idx < njobs; idx++)
+                {
+                        job = &jobs[idx];
+                        job->status = -1;
+                        if(uAES_PROF_CHECK( (uAES_JOB_RGE <= job->op)                           ||
+                                            (uAESRGE <= job->aes_length)                        ||
+                                            (NULL == job->key)                                  ||
+                                            (NULL == job->buf)                                  ||
+                                            (0UL == job->size)                                  ||
+                                            (uAES_MAX_INPUT_SIZE < job->size)                   ||
+                                            ((NULL == job->iv) && (uAES_JOB_ECB_DEC < job->op)) ||
+                                            ((uAES_JOB_CTR == job->op) && ((0UL == job->ctr_size) || (uAES_BLOCK_SIZE < job->ctr_size))) ))
+                        {
+                                err = -1;
+                                continue;
+                        }
+
+                        need = ((uAES_JOB_ECB_DEC == job->op) || (uAES_JOB_CBC_DEC == job->op)) ? (uAES_CTX_ENC | uAES_CTX_DEC) : (uAES_CTX_ENC);
+                        key_size = 16UL + (8UL * job->aes_length);
+                        if( (key_length != job->aes_length)                     ||
+                            (need != (dirs & need))                             ||
+                            (0 == uaes_memeq(key, job->key, key_size)) )
+                        {
+                                uaes_ctx_load(ctx, job->key, job->aes_length, need);
+                                memcpy((void *)key, (void *)job->key, key_size);
+                                key_length = job->aes_length;
+                                dirs = need;
+                        }
+
+                        switch(job->op)
+                        {
+                                case uAES_JOB_ECB_ENC:
+                                        uaes_ecb_foward(ctx, job->buf, uAES_ALIGN(job->size, uAES_BLOCK_ALIGN) >> 4UL);
+                                        break;
+                                case uAES_JOB_ECB_DEC:
+                                        uaes_ecb_inverse(ctx, job->buf, uAES_ALIGN(job->size, uAES_BLOCK_ALIGN) >> 4UL);
+                                        break;
+                                case uAES_JOB_CBC_ENC:
+                                        uaes_cbc_foward(ctx, job->buf, uAES_ALIGN(job->size, uAES_BLOCK_ALIGN) >> 4UL, job->iv);
+                                        break;
+                                case uAES_JOB_CBC_DEC:
+                                        uaes_cbc_inverse(ctx, job->buf, uAES_ALIGN(job->size, uAES_BLOCK_ALIGN) >> 4UL, job->iv);
+                                        break;
+                                default:
+                                        uaes_ctr_stream(ctx, job->buf, job->size, job->iv, job->ctr_size);
+                                        break;
+                        }
+                        job->status = 0;
+                }
+                if(uAESRGE != key_length)
+                {
+                        uaes_wipe(ctx);
+                }
+                uaes_memzero(key, sizeof(key));
+        }
+
+        return err;
+}
@@ -26,7 +26,14 @@
 #ifndef UAES_H
 #define UAES_H
 
+#include <stdint.h>
+#include <stddef.h>
+
+#include "uaes_config.h"
 #include "udbg.h"
+#include "uprof.h"
+#include "bslice.h"
+#include "ghash.h"
 
 /**
  * @brief The macros below aid on aligning memory sizes in accordance with 
@@ -39,12 +46,14 @@
 #define uAES_GET_ALIGN_MASK(x, mask)   (((x) + (mask) ) & ~(mask))
 #define uAES_ALIGN(x, a) uAES_GET_ALIGN_MASK(x, (typeof(x))(a) - 1)
 
-#define KB  (1024UL)
-#define MB  (KB*KB)
-#define uAES_MAX_INPUT_SIZE   (64UL*MB)
 #define uAES_MAX_KEY_SIZE     (32UL)
 #define uAES_BLOCK_SIZE       (16UL)
 
+#define uAES128_KSCHD_SIZE    ( 44UL )
+#define uAES192_KSCHD_SIZE    ( 52UL )
+#define uAES256_KSCHD_SIZE    ( 60UL )
+#define uAES_MAX_KSCHD_SIZE   ( uAES256_KSCHD_SIZE )
+
 /**
  * @brief Data type definitions
  */
@@ -66,8 +75,274 @@ typedef enum aes_length
   uAESRGE = 3   // Range of length options
 }aes_length_t;
 
+/**
+ * @brief Cipher context, holds the key schedules expanded once by uaes_init().
+ */
+typedef struct uaes_ctx
+{
+  uint32_t      ekschd[uAES_MAX_KSCHD_SIZE];    // Encryption key schedule.
+  uint32_t      dkschd[uAES_MAX_KSCHD_SIZE];    // Decryption key schedule.
+#ifdef __uAES_BSLICE__
+  bslice_t      bkschd[uAES_BSLICE_KSCHD_SIZE]; // Transposed key schedule.
+#endif /*__uAES_BSLICE__*/
+  aes_length_t  aes_length;                     // Key length.
+  size_t        Nk;                             // Key length in 32-bit words.
+  size_t        Nb;                             // Block length in 32-bit words.
+  size_t        Nr;                             // Number of rounds.
+}uaes_ctx_t;
+
+/**
+ * @brief Scatter-gather segment, same layout as the POSIX struct iovec.
+ */
+typedef struct uaes_iovec
+{
+  void          *iov_base;                      // Segment start.
+  size_t        iov_len;                        // Segment length in bytes.
+}uaes_iovec_t;
+
+/**
+ * @brief Operations of a batch job.
+ */
+typedef enum uaes_job_op
+{
+  uAES_JOB_ECB_ENC = 0, // ECB encryption.
+  uAES_JOB_ECB_DEC = 1, // ECB decryption.
+  uAES_JOB_CBC_ENC = 2, // CBC encryption.
+  uAES_JOB_CBC_DEC = 3, // CBC decryption.
+  uAES_JOB_CTR     = 4, // CTR encryption/decryption.
+  uAES_JOB_RGE     = 5  // Range of operations.
+}uaes_job_op_t;
+
+/**
+ * @brief Message of a batch call, with its own key.
+ */
+typedef struct uaes_job
+{
+  uaes_job_op_t op;                             // Operation.
+  aes_length_t  aes_length;                     // Key length.
+  uint8_t       *key;                           // Key.
+  uint8_t       *iv;                            // 16-Byte IV (CBC) or counter block (CTR).
+  size_t        ctr_size;                       // Counter length in bytes, CTR only.
+  uint8_t       *buf;                           // Message, processed in place.
+  size_t        size;                           // Message size, aligned up to 16 bytes but for CTR.
+  int           status;                         // Set to [0] if processed, [-1] if invalid.
+}uaes_job_t;
+
+/**
+ * @brief Independent CBC message of a multi-buffer call.
+ */
+typedef struct uaes_cbc_job
+{
+  uaes_ctx_t    *ctx;                           // Cipher context of the message.
+  uint8_t       *buf;                           // Message, encrypted in place.
+  size_t        size;                           // Message size, aligned up to 16 bytes.
+  uint8_t       *iv;                            // 16-Byte initialisation vector.
+}uaes_cbc_job_t;
+
+/**
+ * @brief Incremental ECB/CBC state, partial blocks are buffered between updates and the
+ *        chaining value is carried forward.
+ */
+typedef struct uaes_stream
+{
+  uaes_ctx_t    *ctx;                           // Cipher context, owned by the caller.
+  uint8_t       iv[uAES_BLOCK_SIZE];            // Chaining value, last ciphertext block.
+  uint8_t       part[uAES_BLOCK_SIZE];          // Buffered partial block.
+  size_t        used;                           // Bytes held in part.
+  unsigned int  mode;                           // Mode and direction.
+}uaes_stream_t;
+
+/**
+ * @brief AES-GCM state, keyed once by uaes_gcm_init() and restarted for every message with
+ *        uaes_gcm_start().
+ */
+typedef struct uaes_gcm
+{
+  uaes_ctx_t    *ctx;                           // Cipher context, owned by the caller.
+  ghash_key_t   hkey;                           // GHASH key derived from the cipher key.
+  uint8_t       j0[uAES_BLOCK_SIZE];            // Pre-counter block, encrypts the tag.
+  uint8_t       ctr[uAES_BLOCK_SIZE];           // Next counter block.
+  uint8_t       xi[uAES_BLOCK_SIZE];            // GHASH state.
+  uint8_t       stream[uAES_BLOCK_SIZE];        // Keystream of the partial data block.
+  uint8_t       part[uAES_BLOCK_SIZE];          // Partial AAD or ciphertext block.
+  uint64_t      aad_size;                       // AAD bytes hashed so far.
+  uint64_t      msg_size;                       // Data bytes processed so far.
+  unsigned int  phase;                          // AAD, data or finished.
+}uaes_gcm_t;
+
+/**
+ * @brief AES-CMAC state, keyed once by uaes_cmac_init() with the subkeys derived from the
+ *        cipher key and restarted for every message with uaes_cmac_start().
+ */
+typedef struct uaes_cmac
+{
+  uaes_ctx_t    *ctx;                           // Cipher context, owned by the caller.
+  uint8_t       k1[uAES_BLOCK_SIZE];            // Subkey of a complete last block.
+  uint8_t       k2[uAES_BLOCK_SIZE];            // Subkey of a padded last block.
+  uint8_t       x[uAES_BLOCK_SIZE];             // CBC-MAC chaining value.
+  uint8_t       part[uAES_BLOCK_SIZE];          // Last block, held back until it is known to be the last.
+  size_t        used;                           // Bytes held in part.
+  unsigned int  phase;                          // Message or finished.
+}uaes_cmac_t;
+
+/**
+ * @brief Independent message of a multi-buffer CMAC call.
+ */
+typedef struct uaes_cmac_job
+{
+  uaes_cmac_t   *cmac;                          // Keyed CMAC state, only its context and subkeys are used.
+  uint8_t       *msg;                           // Message, may be NULL if size is 0.
+  size_t        size;                           // Message size, any length.
+  uint8_t       *tag;                           // Receives the tag.
+  size_t        tag_size;                       // Tag length in bytes [8, 16].
+}uaes_cmac_job_t;
+
+/**
+ * @brief XTS-AES state for storage encryption, keyed once by uaes_xts_init() with the data
+ *        key and tweak key contexts.
+ */
+typedef struct uaes_xts
+{
+  uaes_ctx_t    *ctx;                           // Data key context, owned by the caller.
+  uaes_ctx_t    *tctx;                          // Tweak key context, owned by the caller.
+}uaes_xts_t;
+
+/* Tables */
+
+/**
+ * NOTE: Only required on builds with __uAES_RUNTIME_TABLES__ defined whose start-up
+ *       code does not run constructors, otherwise it has no effect.
+ */
+extern void uaes_tables_init(void);
+
+#if (uAES_SCRATCH == uAES_SCRATCH_CALLER)
+/* Scratch */
+extern int uaes_set_scratch(uaes_ctx_t *scratch);
+#endif /*uAES_SCRATCH_CALLER*/
+
+#ifdef __uAES_KEY_CACHE__
+/* Key schedule cache */
+extern int  uaes_key_cache_seed(uint8_t *seed);
+extern int  uaes_key_cache_stats(uint64_t *hits, uint64_t *misses);
+extern void uaes_key_cache_wipe(void);
+#endif /*__uAES_KEY_CACHE__*/
+
 /* Debug */
 extern uint8_t   uaes_set_trace_msk(uint8_t msk);
+#if defined(__uAES_DEBUG__) && defined(__uAES_TRACE_RING__)
+extern int  uaes_trace_save(const char *path);
+extern void uaes_trace_reset(void);
+#endif /*__uAES_DEBUG__ && __uAES_TRACE_RING__*/
+
+#ifdef __uAES_PROFILE__
+/* Profiling */
+extern int  uaes_prof_read(uaes_prof_t *prof);
+extern void uaes_prof_reset(void);
+extern void uaes_prof_dump(void);
+#endif /*__uAES_PROFILE__*/
+
+/* Context API */
+extern int  uaes_init(uaes_ctx_t *ctx, uint8_t *key, aes_length_t aes_length);
+extern void uaes_wipe(uaes_ctx_t *ctx);
+
+/** 
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK. 
+ */
+extern int uaes_ctx_ecb_encryption(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size);
+extern int uaes_ctx_ecb_decryption(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size);
+/* ******************************************************************** */
+
+extern int uaes_ctx_cbc_encryption(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size, uint8_t *iv);
+extern int uaes_ctx_cbc_decryption(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size, uint8_t *iv);
+extern int uaes_ctx_ctr_xcrypt(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *ctr, size_t ctr_size);
+extern int uaes_ctx_pcbc_encryption(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size, uint8_t *iv);
+extern int uaes_ctx_pcbc_decryption(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size, uint8_t *iv);
+extern int uaes_ctx_cfb_encryption(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size, uint8_t *iv);
+extern int uaes_ctx_cfb_decryption(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size, uint8_t *iv);
+extern int uaes_ctx_ofb_xcrypt(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv);
+extern int uaes_ctx_ofb_keystream(uaes_ctx_t *ctx, uint8_t *stream, size_t size, uint8_t *iv);
+extern int uaes_ctx_block_encryption(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size);
+extern int uaes_ctx_block_decryption(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size);
+
+/* Out-of-place and scatter-gather API */
+
+/** 
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK. 
+ */
+extern int uaes_ctx_ecb_encryption_to(uaes_ctx_t *ctx, uint8_t *src, uint8_t *dst, size_t size);
+extern int uaes_ctx_ecb_decryption_to(uaes_ctx_t *ctx, uint8_t *src, uint8_t *dst, size_t size);
+extern int uaes_ctx_ecb_encryption_iov(uaes_ctx_t *ctx, const uaes_iovec_t *src, size_t src_cnt, const uaes_iovec_t *dst, size_t dst_cnt);
+extern int uaes_ctx_ecb_decryption_iov(uaes_ctx_t *ctx, const uaes_iovec_t *src, size_t src_cnt, const uaes_iovec_t *dst, size_t dst_cnt);
+/* ******************************************************************** */
+
+extern int uaes_ctx_cbc_encryption_to(uaes_ctx_t *ctx, uint8_t *src, uint8_t *dst, size_t size, uint8_t *iv);
+extern int uaes_ctx_cbc_decryption_to(uaes_ctx_t *ctx, uint8_t *src, uint8_t *dst, size_t size, uint8_t *iv);
+extern int uaes_ctx_cbc_encryption_iov(uaes_ctx_t *ctx, const uaes_iovec_t *src, size_t src_cnt, const uaes_iovec_t *dst, size_t dst_cnt, uint8_t *iv);
+extern int uaes_ctx_cbc_decryption_iov(uaes_ctx_t *ctx, const uaes_iovec_t *src, size_t src_cnt, const uaes_iovec_t *dst, size_t dst_cnt, uint8_t *iv);
+
+/* Multi-buffer API */
+extern int uaes_ctx_cbc_encryption_mb(uaes_cbc_job_t *jobs, size_t njobs);
+
+/* Streaming API */
+
+/** 
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK. 
+ */
+extern int uaes_ecb_encrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx);
+extern int uaes_ecb_decrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx);
+/* ******************************************************************** */
+
+extern int uaes_cbc_encrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx, uint8_t *iv);
+extern int uaes_cbc_decrypt_init(uaes_stream_t *stream, uaes_ctx_t *ctx, uint8_t *iv);
+extern int uaes_stream_update(uaes_stream_t *stream, uint8_t *src, size_t size, uint8_t *dst, size_t *dst_size);
+extern int uaes_stream_final(uaes_stream_t *stream, uint8_t *dst, size_t *dst_size);
+
+/* Authenticated encryption API */
+extern int  uaes_gcm_init(uaes_gcm_t *gcm, uaes_ctx_t *ctx);
+extern void uaes_gcm_wipe(uaes_gcm_t *gcm);
+extern int  uaes_gcm_start(uaes_gcm_t *gcm, uint8_t *iv, size_t iv_size);
+extern int  uaes_gcm_aad(uaes_gcm_t *gcm, uint8_t *aad, size_t aad_size);
+extern int  uaes_gcm_encrypt_update(uaes_gcm_t *gcm, uint8_t *buf, size_t size);
+extern int  uaes_gcm_decrypt_update(uaes_gcm_t *gcm, uint8_t *buf, size_t size);
+extern int  uaes_gcm_finish(uaes_gcm_t *gcm, uint8_t *tag, size_t tag_size);
+extern int  uaes_gcm_verify(uaes_gcm_t *gcm, uint8_t *tag, size_t tag_size);
+extern int  uaes_gcm_encrypt(uaes_gcm_t *gcm, uint8_t *iv, size_t iv_size, uint8_t *aad, size_t aad_size, uint8_t *buf, size_t size, uint8_t *tag, size_t tag_size);
+extern int  uaes_gcm_decrypt(uaes_gcm_t *gcm, uint8_t *iv, size_t iv_size, uint8_t *aad, size_t aad_size, uint8_t *buf, size_t size, uint8_t *tag, size_t tag_size);
+
+/* Message authentication API */
+extern int  uaes_cmac_init(uaes_cmac_t *cmac, uaes_ctx_t *ctx);
+extern void uaes_cmac_wipe(uaes_cmac_t *cmac);
+extern int  uaes_cmac_start(uaes_cmac_t *cmac);
+extern int  uaes_cmac_update(uaes_cmac_t *cmac, uint8_t *msg, size_t size);
+extern int  uaes_cmac_finish(uaes_cmac_t *cmac, uint8_t *tag, size_t tag_size);
+extern int  uaes_cmac_verify(uaes_cmac_t *cmac, uint8_t *tag, size_t tag_size);
+extern int  uaes_cmac(uaes_cmac_t *cmac, uint8_t *msg, size_t size, uint8_t *tag, size_t tag_size);
+extern int  uaes_cmac_check(uaes_cmac_t *cmac, uint8_t *msg, size_t size, uint8_t *tag, size_t tag_size);
+extern int  uaes_cmac_mb(uaes_cmac_job_t *jobs, size_t njobs);
+
+/* Storage encryption API */
+extern int  uaes_xts_init(uaes_xts_t *xts, uaes_ctx_t *ctx, uaes_ctx_t *tctx);
+extern int  uaes_xts_encrypt(uaes_xts_t *xts, uint8_t *tweak, uint8_t *buf, size_t size);
+extern int  uaes_xts_decrypt(uaes_xts_t *xts, uint8_t *tweak, uint8_t *buf, size_t size);
+extern int  uaes_xts_encrypt_sectors(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors);
+extern int  uaes_xts_decrypt_sectors(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors);
+
+#ifdef __uAES_PTHREAD__
+/* Multi-threaded API */
+extern int  uaes_pool_init(size_t nthreads, size_t threshold);
+extern void uaes_pool_destroy(void);
+
+/** 
+ * NOTE: AES-ECB IS NO LONGER CONSIDERED SAFE, USE IT AT YOUR OWN RISK. 
+ */
+extern int uaes_ctx_ecb_encryption_mt(uaes_ctx_t *ctx, uint8_t *plaintext, size_t plaintext_size);
+extern int uaes_ctx_ecb_decryption_mt(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size);
+/* ******************************************************************** */
+
+extern int uaes_ctx_cbc_decryption_mt(uaes_ctx_t *ctx, uint8_t *ciphertext, size_t ciphertext_size, uint8_t *iv);
+extern int uaes_xts_encrypt_sectors_mt(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors);
+extern int uaes_xts_decrypt_sectors_mt(uaes_xts_t *xts, uint64_t sector, uint8_t *buf, size_t sector_size, size_t nsectors);
+#endif /*__uAES_PTHREAD__*/
 
 /* Encryption API*/
 
@@ -86,6 +361,33 @@ extern int uaes_cbc_encryption( uint8_t   *plaintext,
                                 uint8_t   *init_vec,
                                 aes_length_t  aes_mode );
 
+/* Counter mode encrypts and decrypts with the same call. */
+extern int uaes_ctr_xcrypt( uint8_t   *buf, 
+                            size_t    size, 
+                            uint8_t   *key, 
+                            uint8_t   *ctr, 
+                            size_t    ctr_size, 
+                            aes_length_t  aes_mode );
+
+extern int uaes_pcbc_encryption( uint8_t   *plaintext, 
+                                 size_t    plaintext_size, 
+                                 uint8_t   *key, 
+                                 uint8_t   *init_vec,
+                                 aes_length_t  aes_mode );
+
+extern int uaes_cfb_encryption( uint8_t   *plaintext, 
+                                size_t    plaintext_size, 
+                                uint8_t   *key, 
+                                uint8_t   *init_vec,
+                                aes_length_t  aes_mode );
+
+/* Output feedback mode encrypts and decrypts with the same call. */
+extern int uaes_ofb_xcrypt( uint8_t   *buf, 
+                            size_t    size, 
+                            uint8_t   *key, 
+                            uint8_t   *init_vec, 
+                            aes_length_t  aes_mode );
+
 extern int uaes128enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size);
 extern int uaes192enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size);
 extern int uaes256enc(uint8_t *plaintext, uint8_t *key, size_t plaintext_size);
@@ -107,9 +409,23 @@ extern int uaes_cbc_decryption( uint8_t   *plaintext,
                                 uint8_t   *init_vec,
                                 aes_length_t  aes_mode );
 
+extern int uaes_pcbc_decryption( uint8_t   *ciphertext, 
+                                 size_t    ciphertext_size, 
+                                 uint8_t   *key, 
+                                 uint8_t   *init_vec,
+                                 aes_length_t  aes_mode );
+
+extern int uaes_cfb_decryption( uint8_t   *ciphertext, 
+                                size_t    ciphertext_size, 
+                                uint8_t   *key, 
+                                uint8_t   *init_vec,
+                                aes_length_t  aes_mode );
 
 extern int uaes128dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size);
 extern int uaes192dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size);
 extern int uaes256dec(uint8_t *ciphertext, uint8_t *key, size_t ciphertext_size);
 
+/* Batch API */
+extern int uaes_batch(uaes_job_t *jobs, size_t njobs);
+
 #endif /*UAES_H*/
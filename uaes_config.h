@@ -0,0 +1,140 @@
+/**
+ * @file      uaes_config.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     uAES build-time configuration.
+ * @version   0.0
+ * @date      2026-10-16 YYYY-MM-DD
+ * @note      tab = 2 spaces! 
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef UAES_CONFIG_H
+#define UAES_CONFIG_H
+
+/**
+ * NOTE: Every value below can be overridden from the compiler command line, e.g.
+ *       make test UAES_DEFS="-DuAES_MAX_INPUT_SIZE=(4UL*KB) -D__uAES_TTABLE_COMPACT__"
+ *       or by editing this file. "make footprint" reports the static RAM and flash used by
+ *       the library for a set of configurations.
+ *
+ *  Engines and tables:
+ *  __uAES_RUNTIME_TABLES__   S-box (and T-table) tables are generated on start-up into RAM
+ *                            instead of being stored in flash.
+ *  __uAES_TTABLE__           T-table engine, 8 KB of tables in flash.
+ *  __uAES_TTABLE_COMPACT__   T-table engine keeps one table per direction and rotates its
+ *                            entries, 2 KB of tables in flash.
+ *  __uAES_BSLICE__           Bitsliced constant-time engine, no tables.
+ *  __uAES_GHASH_TABLE8__     8-bit GHASH tables, 4 KB per GCM state instead of 256 bytes.
+ *  __uAES_NO_AESNI__         Leaves the AES-NI and PCLMULQDQ engines out of x86 builds.
+ *  __uAES_PTHREAD__          Multi-threaded modes.
+ *  __uAES_KEY_CACHE__        One-shot functions reuse the key schedules of recently seen keys.
+ *  __uAES_PROFILE__          Per-thread cycle and call counts of every cipher phase, see uprof.h.
+ *  __uAES_TRACE_RING__       With __uAES_DEBUG__, traces are stored as binary records in
+ *                            per-thread rings instead of being printed, see udbg.h.
+ */
+
+#define KB  (1024UL)
+#define MB  (KB*KB)
+
+/**
+ * @brief Largest buffer accepted by the one-shot ECB, CBC and CTR functions. The streaming
+ *        and GCM functions are not limited by it.
+ */
+#ifndef uAES_MAX_INPUT_SIZE
+#define uAES_MAX_INPUT_SIZE   (64UL*MB)
+#endif
+
+/**
+ * @brief Multi-threaded modes, available with __uAES_PTHREAD__. Buffers are split into chunks
+ *        of uAES_MT_CHUNK_SIZE bytes, sized to stay in a core's L2 cache. Buffers smaller than
+ *        the threshold given to uaes_pool_init() take the single-thread path. A call keeps one
+ *        16-byte IV per chunk of uAES_MAX_INPUT_SIZE on its stack.
+ */
+#ifndef uAES_MT_CHUNK_SIZE
+#define uAES_MT_CHUNK_SIZE    (64UL*KB)
+#endif
+#ifndef uAES_MT_THRESHOLD
+#define uAES_MT_THRESHOLD     (256UL*KB)
+#endif
+
+/**
+ * @brief Key schedule cache, available with __uAES_KEY_CACHE__. uAES_KEY_CACHE_SIZE keys are
+ *        kept in sets of uAES_KEY_CACHE_WAYS, each entry holds a uaes_ctx_t.
+ */
+#ifndef uAES_KEY_CACHE_SIZE
+#define uAES_KEY_CACHE_SIZE   ( 8UL )
+#endif
+#ifndef uAES_KEY_CACHE_WAYS
+#define uAES_KEY_CACHE_WAYS   ( 2UL )
+#endif
+
+/**
+ * @brief Profiling, available with __uAES_PROFILE__ on hosts with thread-local storage. Every
+ *        thread that runs uAES code takes one of uAES_PROF_MAX_THREADS counter slots. When
+ *        uAES_PROF_DUMP_AT_EXIT is non-zero the counters of every thread are printed to stderr
+ *        at exit. uAES_PROF_CLOCK() may be defined to read another clock than the default one.
+ */
+#ifndef uAES_PROF_MAX_THREADS
+#define uAES_PROF_MAX_THREADS ( 64UL )
+#endif
+#ifndef uAES_PROF_DUMP_AT_EXIT
+#define uAES_PROF_DUMP_AT_EXIT  1
+#endif
+
+/**
+ * @brief Trace rings, available with __uAES_DEBUG__ and __uAES_TRACE_RING__. Every thread that
+ *        traces takes one of uAES_TRACE_THREADS rings of uAES_TRACE_RING_SIZE 32-byte records,
+ *        a power of two, and overwrites its oldest records once it is full, the last
+ *        uAES_TRACE_RING_SIZE - 1 records of every thread are saved. uAES_TRACE_SITES
+ *        trace points are registered at most. When uAES_TRACE_SAVE_AT_EXIT is non-zero the
+ *        rings are saved to uAES_TRACE_FILE at exit. uAES_TRACE_CLOCK() may be defined to read
+ *        another clock than the default one.
+ */
+#ifndef uAES_TRACE_RING_SIZE
+#define uAES_TRACE_RING_SIZE  ( 1024UL )
+#endif
+#ifndef uAES_TRACE_THREADS
+#define uAES_TRACE_THREADS    ( 8UL )
+#endif
+#ifndef uAES_TRACE_SITES
+#define uAES_TRACE_SITES      ( 256UL )
+#endif
+#ifndef uAES_TRACE_SAVE_AT_EXIT
+#define uAES_TRACE_SAVE_AT_EXIT 1
+#endif
+#ifndef uAES_TRACE_FILE
+#define uAES_TRACE_FILE       "uaes.trace"
+#endif
+
+/**
+ * @brief Where the one-shot functions (uaes_cbc_encryption(), uaes128enc(), ...) keep the key
+ *        schedules they expand, a uaes_ctx_t of 500 bytes to 4 KB depending on the engine.
+ *        uAES_SCRATCH_STACK:   on the stack of the calling thread.
+ *        uAES_SCRATCH_STATIC:  in a single static context, the functions are not reentrant.
+ *        uAES_SCRATCH_CALLER:  in a context handed over with uaes_set_scratch(), the functions
+ *                              fail until one is set and are not reentrant.
+ */
+#define uAES_SCRATCH_STACK    0
+#define uAES_SCRATCH_STATIC   1
+#define uAES_SCRATCH_CALLER   2
+
+#ifndef uAES_SCRATCH
+#define uAES_SCRATCH          uAES_SCRATCH_STACK
+#endif
+
+#endif /*UAES_CONFIG_H*/
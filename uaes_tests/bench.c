@@ -0,0 +1,339 @@
+/**
+ * @file    bench.c
+ * @author  Antonio Vitor Grossi Bassi
+ * @brief   Throughput benchmark for the uAES ECB and CBC context functions.
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ *  Copyright (C) 2023, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ */
+
+#define _GNU_SOURCE
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdint.h"
+#include "string.h"
+#include "time.h"
+#ifdef __linux__
+#include "sched.h"
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include "x86intrin.h"
+#define BENCH_TSC
+#endif
+#include "../uaes.h"
+#include "../aesni.h"
+
+#define MAX_REPS              (101UL)
+#define MIN_SIZE              (16UL)
+#define MIN_RUN_BYTES         (1UL*MB)
+#define MAX_RESULTS           (4UL * 3UL * 24UL)
+
+/**
+ * @brief Benchmarked operation, ECB ignores the IV.
+ */
+typedef struct bench_op
+{
+  const char  *name;
+  int         (*run)(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv);
+}bench_op_t;
+
+/**
+ * @brief Median of one operation, key length and message size.
+ */
+typedef struct bench_res
+{
+  const char  *op;
+  unsigned    key_bits;
+  size_t      size;
+  double      cpb;
+  double      mbps;
+}bench_res_t;
+
+static int ecb_enc(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv)
+{
+  (void)iv;
+  return uaes_ctx_ecb_encryption(ctx, buf, size);
+}
+
+static int ecb_dec(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv)
+{
+  (void)iv;
+  return uaes_ctx_ecb_decryption(ctx, buf, size);
+}
+
+static int cbc_enc(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv)
+{
+  return uaes_ctx_cbc_encryption(ctx, buf, size, iv);
+}
+
+static int cbc_dec(uaes_ctx_t *ctx, uint8_t *buf, size_t size, uint8_t *iv)
+{
+  return uaes_ctx_cbc_decryption(ctx, buf, size, iv);
+}
+
+static const bench_op_t ops[] =
+{
+  { "ecb-enc", ecb_enc },
+  { "ecb-dec", ecb_dec },
+  { "cbc-enc", cbc_enc },
+  { "cbc-dec", cbc_dec },
+};
+
+static const struct
+{
+  aes_length_t  len;
+  unsigned      bits;
+}keys[] =
+{
+  { uAES128, 128U },
+  { uAES192, 192U },
+  { uAES256, 256U },
+};
+
+static uint64_t bench_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_cycles(void)
+{
+#ifdef BENCH_TSC
+  return __rdtsc();
+#else
+  return 0ULL;
+#endif
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double median(double *v, size_t n)
+{
+  qsort(v, n, sizeof(double), cmp_double);
+  return (0UL != (n & 1UL)) ? (v[n >> 1UL]) : (0.5 * (v[(n >> 1UL) - 1UL] + v[n >> 1UL]));
+}
+
+static void pin_cpu(int cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  if(0 <= cpu)
+  {
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if(0 != sched_setaffinity(0, sizeof(set), &set))
+    {
+      fprintf(stderr, "bench: could not pin to cpu %d, running unpinned\n", cpu);
+    }
+  }
+#else
+  (void)cpu;
+#endif
+}
+
+static const char *engine(void)
+{
+#ifdef __uAES_AESNI__
+  if(0 != aesni_available())
+  {
+    return "aes-ni";
+  }
+#endif
+#if defined(__uAES_BSLICE__)
+  return "bitsliced";
+#elif defined(__uAES_TTABLE__) && defined(__uAES_TTABLE_COMPACT__)
+  return "ttable-compact";
+#elif defined(__uAES_TTABLE__)
+  return "ttable";
+#else
+  return "portable";
+#endif
+}
+
+/**
+ * @brief Times one operation. Every repetition runs the call enough times to process at least
+ *        MIN_RUN_BYTES, after one untimed warm-up repetition.
+ */
+static void bench_one(const bench_op_t *op, uaes_ctx_t *ctx, uint8_t *buf, size_t size, size_t reps, bench_res_t *res)
+{
+  double cpb[MAX_REPS], nspb[MAX_REPS];
+  uint8_t iv[uAES_BLOCK_SIZE] = {0};
+  size_t iters = (MIN_RUN_BYTES > size) ? (MIN_RUN_BYTES / size) : (1UL);
+  size_t r = 0, i = 0;
+  uint64_t t0 = 0, t1 = 0, c0 = 0, c1 = 0;
+
+  for(i = 0; i < iters; i++)
+  {
+    op->run(ctx, buf, size, iv);
+  }
+  for(r = 0; r < reps; r++)
+  {
+    t0 = bench_ns();
+    c0 = bench_cycles();
+    for(i = 0; i < iters; i++)
+    {
+      op->run(ctx, buf, size, iv);
+    }
+    c1 = bench_cycles();
+    t1 = bench_ns();
+    cpb[r]  = (double)(c1 - c0) / (double)(iters * size);
+    nspb[r] = (double)(t1 - t0) / (double)(iters * size);
+  }
+  res->cpb  = median(cpb, reps);
+  res->mbps = 1000.0 / median(nspb, reps);
+}
+
+static void write_csv(FILE *f, bench_res_t *res, size_t n)
+{
+  size_t i = 0;
+  fprintf(f, "engine,op,key_bits,size,cycles_per_byte,mb_per_s\n");
+  for(i = 0; i < n; i++)
+  {
+    fprintf(f, "%s,%s,%u,%zu,%.3f,%.1f\n", engine(), res[i].op, res[i].key_bits, res[i].size, res[i].cpb, res[i].mbps);
+  }
+}
+
+static void write_json(FILE *f, bench_res_t *res, size_t n)
+{
+  size_t i = 0;
+  fprintf(f, "{\n  \"engine\": \"%s\",\n  \"results\": [\n", engine());
+  for(i = 0; i < n; i++)
+  {
+    fprintf(f, "    { \"op\": \"%s\", \"key_bits\": %u, \"size\": %zu, \"cycles_per_byte\": %.3f, \"mb_per_s\": %.1f }%s\n",
+            res[i].op, res[i].key_bits, res[i].size, res[i].cpb, res[i].mbps, ((i + 1UL) < n) ? (",") : (""));
+  }
+  fprintf(f, "  ]\n}\n");
+}
+
+static int write_file(const char *path, void (*writer)(FILE *, bench_res_t *, size_t), bench_res_t *res, size_t n)
+{
+  FILE *f = fopen(path, "w");
+  if(NULL == f)
+  {
+    fprintf(stderr, "bench: cannot open %s\n", path);
+    return -1;
+  }
+  writer(f, res, n);
+  fclose(f);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  static bench_res_t res[MAX_RESULTS];
+  const char *csv = NULL, *json = NULL;
+  size_t reps = 11UL, max_size = uAES_MAX_INPUT_SIZE, size = 0, nres = 0, i = 0;
+  size_t o = 0, k = 0;
+  int cpu = 0, arg = 1, err = 0;
+  uint8_t key[32];
+  uint8_t *buf = NULL;
+  uaes_ctx_t ctx;
+
+  while(argc > arg)
+  {
+    if((0 == strcmp(argv[arg], "-n")) && (argc > (arg + 1)))
+    {
+      reps = strtoul(argv[++arg], NULL, 0);
+      reps = (0UL == reps) ? (1UL) : ((MAX_REPS < reps) ? (MAX_REPS) : (reps));
+    }
+    else if((0 == strcmp(argv[arg], "-s")) && (argc > (arg + 1)))
+    {
+      max_size = strtoul(argv[++arg], NULL, 0);
+      max_size = (uAES_MAX_INPUT_SIZE < max_size) ? (uAES_MAX_INPUT_SIZE) : (max_size);
+    }
+    else if((0 == strcmp(argv[arg], "-p")) && (argc > (arg + 1)))
+    {
+      cpu = atoi(argv[++arg]);
+    }
+    else if((0 == strcmp(argv[arg], "-csv")) && (argc > (arg + 1)))
+    {
+      csv = argv[++arg];
+    }
+    else if((0 == strcmp(argv[arg], "-json")) && (argc > (arg + 1)))
+    {
+      json = argv[++arg];
+    }
+    else
+    {
+      printf("bench: Throughput of the uAES ECB and CBC context functions.\n");
+      printf("usage: bench [-n REPS] [-s MAX SIZE] [-p CPU] [-csv FILE] [-json FILE]\n");
+      printf("\"-n\", repetitions per measurement, the median is reported (default 11).\n");
+      printf("\"-s\", largest message size in bytes, sizes go from 16 bytes up in powers of 4 (default %lu).\n", (unsigned long)uAES_MAX_INPUT_SIZE);
+      printf("\"-p\", CPU to pin the benchmark to, -1 leaves it unpinned (default 0).\n");
+      printf("\"-csv\", \"-json\", also write the results to FILE.\n");
+      printf("Cycles are TSC reference cycles, fix the core clock for comparable runs.\n\n");
+      exit(EXIT_SUCCESS);
+    }
+    arg++;
+  }
+
+  pin_cpu(cpu);
+  buf = (uint8_t *)aligned_alloc(64UL, uAES_ALIGN(max_size, 64UL));
+  if(NULL == buf)
+  {
+    fprintf(stderr, "bench: out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  srand(1);
+  for(i = 0; i < max_size; i++)
+  {
+    buf[i] = (uint8_t)rand();
+  }
+  for(i = 0; i < sizeof(key); i++)
+  {
+    key[i] = (uint8_t)rand();
+  }
+
+  printf("engine: %s, %zu repetitions, cpu %d\n", engine(), reps, cpu);
+  printf("%-8s %4s %10s %10s %10s\n", "op", "key", "size", "cyc/B", "MB/s");
+  for(o = 0; o < (sizeof(ops) / sizeof(ops[0])); o++)
+  {
+    for(k = 0; k < (sizeof(keys) / sizeof(keys[0])); k++)
+    {
+      uaes_init(&ctx, key, keys[k].len);
+      for(size = MIN_SIZE; (size <= max_size) && (MAX_RESULTS > nres); size <<= 2UL)
+      {
+        res[nres].op = ops[o].name;
+        res[nres].key_bits = keys[k].bits;
+        res[nres].size = size;
+        bench_one(&ops[o], &ctx, buf, size, reps, &res[nres]);
+        printf("%-8s %4u %10zu %10.2f %10.1f\n", res[nres].op, res[nres].key_bits, size, res[nres].cpb, res[nres].mbps);
+        fflush(stdout);
+        nres++;
+      }
+      uaes_wipe(&ctx);
+    }
+  }
+
+  if(NULL != csv)
+  {
+    err |= write_file(csv, write_csv, res, nres);
+  }
+  if(NULL != json)
+  {
+    err |= write_file(json, write_json, res, nres);
+  }
+  free(buf);
+  return (0 != err) ? (EXIT_FAILURE) : (EXIT_SUCCESS);
+}
@@ -0,0 +1,198 @@
+/**
+ * @file    fcrypt.c
+ * @author  Antonio Vitor Grossi Bassi
+ * @brief   Memory-mapped file encryption tool built on ufile.
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ *  Copyright (C) 2023, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdint.h"
+#include "string.h"
+#include "../uaes.h"
+#include "../ufile.h"
+
+#define MAX_KEYSIZE           (32UL)
+#define MAX_IVSIZE            (16UL)
+#define LSB                   (0b00000001)
+#define ARG_MSK_FILE          (LSB << 0UL)
+#define ARG_MSK_KEY           (LSB << 1UL)
+#define ARG_MSK_IV            (LSB << 2UL)
+#define ARG_MSK_CIPHERTYPE    (LSB << 3UL)
+#define ARG_MSK_OUTFNAME      (LSB << 4UL)
+#define ARG_MSK_MODE          (LSB << 5UL)
+
+int rd_argmsk(uint32_t *argmsk, uint32_t msk)
+{
+  return (*argmsk & msk) ? (0UL) : (1UL);
+}
+
+/**
+ * @brief Parses a hexadecimal string.
+ * @param str   Hex string, two digits per byte.
+ * @param buf   Output buffer.
+ * @param limit Output buffer size.
+ * @return size_t Number of bytes parsed, [0] on malformed input.
+ */
+static size_t hex_parse(const char *str, uint8_t *buf, size_t limit)
+{
+  size_t len = strlen(str);
+  size_t i = 0;
+  unsigned int byte = 0;
+
+  if((0UL != (len & 1UL)) || ((len >> 1UL) > limit))
+  {
+    return 0UL;
+  }
+  for(i = 0; i < (len >> 1UL); i++)
+  {
+    if(1 != sscanf(&str[i << 1UL], "%2x", &byte))
+    {
+      return 0UL;
+    }
+    buf[i] = (uint8_t)byte;
+  }
+  return (len >> 1UL);
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = NULL;
+  const char *outf = NULL;
+  ufile_mode_t cipher_mode = uFILE_ECB;
+  aes_length_t encryption_type = uAES128;
+  int decrypt = 0;
+  int err = -1;
+  int arg = 1;
+  uint32_t argmsk = 0;
+  size_t key_size = 0;
+  size_t iv_size = 0;
+  uint8_t key[MAX_KEYSIZE] = {0};
+  uint8_t iv[MAX_IVSIZE] = {0};
+  uaes_ctx_t ctx;
+
+  while(argc > arg)
+  {
+    if((0 == strcmp(argv[arg], "-f")) && (rd_argmsk(&argmsk, ARG_MSK_FILE)) && (argc > (arg + 1)))
+    {
+      argmsk |= ARG_MSK_FILE;
+      path = argv[++arg];
+    }
+    else if((0 == strcmp(argv[arg], "-o")) && (rd_argmsk(&argmsk, ARG_MSK_OUTFNAME)) && (argc > (arg + 1)))
+    {
+      argmsk |= ARG_MSK_OUTFNAME;
+      outf = argv[++arg];
+    }
+    else if((0 == strcmp(argv[arg], "-k")) && (rd_argmsk(&argmsk, ARG_MSK_KEY)) && (argc > (arg + 1)))
+    {
+      argmsk |= ARG_MSK_KEY;
+      key_size = hex_parse(argv[++arg], key, MAX_KEYSIZE);
+    }
+    else if((0 == strcmp(argv[arg], "-i")) && (rd_argmsk(&argmsk, ARG_MSK_IV)) && (argc > (arg + 1)))
+    {
+      argmsk |= ARG_MSK_IV;
+      iv_size = hex_parse(argv[++arg], iv, MAX_IVSIZE);
+    }
+    else if((0 == strcmp(argv[arg], "-c")) && (rd_argmsk(&argmsk, ARG_MSK_CIPHERTYPE)) && (argc > (arg + 1)))
+    {
+      argmsk |= ARG_MSK_CIPHERTYPE;
+      arg++;
+      if(0 == strcmp(argv[arg], "ECB"))
+      {
+        cipher_mode = uFILE_ECB;
+      }
+      else if(0 == strcmp(argv[arg], "CBC"))
+      {
+        cipher_mode = uFILE_CBC;
+      }
+      else if(0 == strcmp(argv[arg], "CTR"))
+      {
+        cipher_mode = uFILE_CTR;
+      }
+      else if(0 == strcmp(argv[arg], "GCM"))
+      {
+        cipher_mode = uFILE_GCM;
+      }
+      else
+      {
+        cipher_mode = uFILE_RGE;
+      }
+    }
+    else if((0 == strcmp(argv[arg], "-d")) && (rd_argmsk(&argmsk, ARG_MSK_MODE)))
+    {
+      argmsk |= ARG_MSK_MODE;
+      decrypt = 1;
+    }
+    else if(0 == strcmp(argv[arg], "-h"))
+    {
+      printf("fcrypt: Encrypts files of any size through memory mappings.\n");
+      printf("usage: fcrypt -f [FILENAME] -o [OUTPUT FILE] -k [HEX KEY] [PARAMETERS]\n");
+      printf("Takes following arguments:\n\"-f\", input file.\n\"-o\", output file, created or truncated.\n");
+      printf("\"-k\", AES key in hex, 32, 48 or 64 digits select AES-128, AES-192 or AES-256.\n");
+      printf("\"-c\", Cipher mode, can be ECB, CBC, CTR or GCM.\n");
+      printf("\"-i\", IV in hex, 32 digits for CBC and CTR, 24 digits for GCM.\n");
+      printf("\"-d\", Specifies decryption operation. If nothing is specified, encryption is performed.\n");
+      printf("example: fcrypt -f disk.img -o disk.enc -k 000102030405060708090a0b0c0d0e0f -c GCM -i cafebabefacedbaddecaf888\n\n");
+      exit(EXIT_SUCCESS);
+    }
+    else
+    {
+      fprintf(stderr, "fcrypt: bad argument \"%s\", see fcrypt -h\n", argv[arg]);
+      exit(EXIT_FAILURE);
+    }
+    arg++;
+  }
+
+  switch(key_size)
+  {
+    case 16UL:
+      encryption_type = uAES128;
+      break;
+    case 24UL:
+      encryption_type = uAES192;
+      break;
+    case 32UL:
+      encryption_type = uAES256;
+      break;
+    default:
+      fprintf(stderr, "fcrypt: key must be 16, 24 or 32 bytes\n");
+      exit(EXIT_FAILURE);
+  }
+
+  if((NULL == path) || (NULL == outf) || (uFILE_RGE == cipher_mode) ||
+     ((uFILE_ECB != cipher_mode) && (((uFILE_GCM == cipher_mode) ? (12UL) : (16UL)) != iv_size)))
+  {
+    fprintf(stderr, "fcrypt: missing or malformed arguments, see fcrypt -h\n");
+    exit(EXIT_FAILURE);
+  }
+
+  err = uaes_init(&ctx, key, encryption_type);
+  if(0 == err)
+  {
+    err = (0 != decrypt) ? (ufile_decrypt(&ctx, cipher_mode, iv, path, outf)) : (ufile_encrypt(&ctx, cipher_mode, iv, path, outf));
+    uaes_wipe(&ctx);
+  }
+  if(0 != err)
+  {
+    fprintf(stderr, "fcrypt: %s failed\n", (0 != decrypt) ? ("decryption") : ("encryption"));
+  }
+  memset((void *)key, 0, sizeof(key));
+  return (0 != err) ? (EXIT_FAILURE) : (EXIT_SUCCESS);
+}
@@ -0,0 +1,476 @@
+/**
+ * @file    kat.c
+ * @author  Antonio Vitor Grossi Bassi
+ * @brief   Known-answer tests of the uAES block modes, GCM, CMAC and XTS.
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ *  Copyright (C) 2023, Antonio Vitor Grossi Bassi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdint.h"
+#include "string.h"
+#include "../uaes.h"
+
+#define MAX_VECTOR_SIZE       (64UL)
+#define BLOCK_SIZE            (16UL)
+
+typedef enum kat_mode
+{
+  KAT_ECB = 0,
+  KAT_CBC = 1,
+  KAT_CFB = 2,
+  KAT_OFB = 3,
+  KAT_CTR = 4,
+}kat_mode_t;
+
+typedef struct mode_vector
+{
+  const char    *name;
+  kat_mode_t    mode;
+  aes_length_t  aes_length;
+  const char    *ct;
+}mode_vector_t;
+
+typedef struct gcm_vector
+{
+  const char    *name;
+  const char    *key;
+  const char    *iv;
+  const char    *aad;
+  const char    *pt;
+  const char    *ct;
+  const char    *tag;
+}gcm_vector_t;
+
+typedef struct xts_vector
+{
+  const char    *name;
+  const char    *key1;
+  const char    *key2;
+  uint64_t      sector;
+  const char    *pt;
+  const char    *ct;
+}xts_vector_t;
+
+/* NIST SP 800-38A, appendix F. Every vector enciphers the same four plaintext blocks. */
+static const char *sp800_38a_pt =
+  "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+  "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static const char *sp800_38a_iv = "000102030405060708090a0b0c0d0e0f";
+static const char *sp800_38a_ctr = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+static const char *sp800_38a_key128 = "2b7e151628aed2a6abf7158809cf4f3c";
+static const char *sp800_38a_key192 = "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b";
+static const char *sp800_38a_key256 = "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4";
+
+static const mode_vector_t mode_vectors[] =
+{
+  {"SP 800-38A F.1.1 ECB-AES128", KAT_ECB, uAES128,
+   "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf"
+   "43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4"},
+  {"SP 800-38A F.1.3 ECB-AES192", KAT_ECB, uAES192,
+   "bd334f1d6e45f25ff712a214571fa5cc974104846d0ad3ad7734ecb3ecee4eef"
+   "ef7afd2270e2e60adce0ba2face6444e9a4b41ba738d6c72fb16691603c18e0e"},
+  {"SP 800-38A F.1.5 ECB-AES256", KAT_ECB, uAES256,
+   "f3eed1bdb5d2a03c064b5a7e3db181f8591ccb10d410ed26dc5ba74a31362870"
+   "b6ed21b99ca6f4f9f153e7b1beafed1d23304b7a39f9f3ff067d8d8f9e24ecc7"},
+  {"SP 800-38A F.2.1 CBC-AES128", KAT_CBC, uAES128,
+   "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+   "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7"},
+  {"SP 800-38A F.2.3 CBC-AES192", KAT_CBC, uAES192,
+   "4f021db243bc633d7178183a9fa071e8b4d9ada9ad7dedf4e5e738763f69145a"
+   "571b242012fb7ae07fa9baac3df102e008b0e27988598881d920a9e64f5615cd"},
+  {"SP 800-38A F.2.5 CBC-AES256", KAT_CBC, uAES256,
+   "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d"
+   "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b"},
+  {"SP 800-38A F.3.13 CFB128-AES128", KAT_CFB, uAES128,
+   "3b3fd92eb72dad20333449f8e83cfb4ac8a64537a0b3a93fcde3cdad9f1ce58b"
+   "26751f67a3cbb140b1808cf187a4f4dfc04b05357c5d1c0eeac4c66f9ff7f2e6"},
+  {"SP 800-38A F.3.15 CFB128-AES192", KAT_CFB, uAES192,
+   "cdc80d6fddf18cab34c25909c99a417467ce7f7f81173621961a2b70171d3d7a"
+   "2e1e8a1dd59b88b1c8e60fed1efac4c9c05f9f9ca9834fa042ae8fba584b09ff"},
+  {"SP 800-38A F.3.17 CFB128-AES256", KAT_CFB, uAES256,
+   "dc7e84bfda79164b7ecd8486985d386039ffed143b28b1c832113c6331e5407b"
+   "df10132415e54b92a13ed0a8267ae2f975a385741ab9cef82031623d55b1e471"},
+  {"SP 800-38A F.4.1 OFB-AES128", KAT_OFB, uAES128,
+   "3b3fd92eb72dad20333449f8e83cfb4a7789508d16918f03f53c52dac54ed825"
+   "9740051e9c5fecf64344f7a82260edcc304c6528f659c77866a510d9c1d6ae5e"},
+  {"SP 800-38A F.4.3 OFB-AES192", KAT_OFB, uAES192,
+   "cdc80d6fddf18cab34c25909c99a4174fcc28b8d4c63837c09e81700c1100401"
+   "8d9a9aeac0f6596f559c6d4daf59a5f26d9f200857ca6c3e9cac524bd9acc92a"},
+  {"SP 800-38A F.4.5 OFB-AES256", KAT_OFB, uAES256,
+   "dc7e84bfda79164b7ecd8486985d38604febdc6740d20b3ac88f6ad82a4fb08d"
+   "71ab47a086e86eedf39d1c5bba97c4080126141d67f37be8538f5a8be740e484"},
+  {"SP 800-38A F.5.1 CTR-AES128", KAT_CTR, uAES128,
+   "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+   "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"},
+  {"SP 800-38A F.5.3 CTR-AES192", KAT_CTR, uAES192,
+   "1abc932417521ca24f2b0459fe7e6e0b090339ec0aa6faefd5ccc2c6f4ce8e94"
+   "1e36b26bd1ebc670d1bd1d665620abf74f78a7f6d29809585a97daec58c6b050"},
+  {"SP 800-38A F.5.5 CTR-AES256", KAT_CTR, uAES256,
+   "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+   "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"},
+};
+
+/* The GCM specification test cases 1 to 4, also listed by NIST SP 800-38D validation. */
+static const gcm_vector_t gcm_vectors[] =
+{
+  {"GCM test case 1", "00000000000000000000000000000000", "000000000000000000000000", "", "", "",
+   "58e2fccefa7e3061367f1d57a4e7455a"},
+  {"GCM test case 2", "00000000000000000000000000000000", "000000000000000000000000", "",
+   "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78",
+   "ab6e47d42cec13bdf53a67b21257bddf"},
+  {"GCM test case 3", "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", "",
+   "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+   "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255",
+   "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+   "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+   "4d5c2af327cd64a62cf35abd2ba6fab4"},
+  {"GCM test case 4", "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+   "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+   "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+   "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+   "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+   "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+   "5bc94fbc3221a5db94fae95ae7121a47"},
+};
+
+/* RFC 4493 section 4, the messages are prefixes of the SP 800-38A plaintext. */
+static const size_t cmac_sizes[] = {0UL, 16UL, 40UL, 64UL};
+static const char *cmac_tags[] =
+{
+  "bb1d6929e95937287fa37d129b756746",
+  "070a16b46b4d4144f79bdd9dd04a287c",
+  "dfa66747de9ae63030ca32611497c827",
+  "51f0bebf7e3b9d92fc49741779363cfe",
+};
+
+/* IEEE 1619-2007 appendix B, vector 15 ends with a partial block. The standard prints the data
+ * unit sequence number as its little-endian tweak bytes, 9a78563412 is sector 0x123456789a. */
+static const xts_vector_t xts_vectors[] =
+{
+  {"IEEE 1619 XTS-AES-128 vector 1", "00000000000000000000000000000000", "00000000000000000000000000000000",
+   0x00ULL,
+   "0000000000000000000000000000000000000000000000000000000000000000",
+   "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e"},
+  {"IEEE 1619 XTS-AES-128 vector 2", "11111111111111111111111111111111", "22222222222222222222222222222222",
+   0x3333333333ULL,
+   "4444444444444444444444444444444444444444444444444444444444444444",
+   "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0"},
+  {"IEEE 1619 XTS-AES-128 vector 15", "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0",
+   0x123456789aULL,
+   "000102030405060708090a0b0c0d0e0f10",
+   "6c1625db4671522d3d7599601de7ca09ed"},
+};
+
+static unsigned int passed = 0;
+static unsigned int failed = 0;
+
+/**
+ * @brief Decodes a hex string.
+ * @param hex   Hex string.
+ * @param out   Output buffer, MAX_VECTOR_SIZE bytes.
+ * @return size_t Decoded size.
+ */
+static size_t unhex(const char *hex, uint8_t *out)
+{
+  size_t size = strlen(hex) / 2UL;
+  unsigned int byte = 0;
+
+  if(MAX_VECTOR_SIZE < size)
+  {
+    fprintf(stderr, "kat: vector longer than %lu bytes\n", MAX_VECTOR_SIZE);
+    exit(EXIT_FAILURE);
+  }
+  for(size_t idx = 0; idx < size; idx++)
+  {
+    sscanf(&hex[2UL * idx], "%2x", &byte);
+    out[idx] = (uint8_t)(byte);
+  }
+  return size;
+}
+
+/**
+ * @brief Records and prints the outcome of one check.
+ * @param name  Vector name.
+ * @param what  Checked operation.
+ * @param ok    Non-zero if the check passed.
+ */
+static void report(const char *name, const char *what, int ok)
+{
+  if(0 != ok)
+  {
+    passed++;
+  }
+  else
+  {
+    failed++;
+  }
+  printf("%s  %s, %s\n", (0 != ok) ? ("pass") : ("FAIL"), name, what);
+  return;
+}
+
+/**
+ * @brief Runs one mode of operation over buf.
+ * @param ctx     Pointer to cipher context.
+ * @param mode    Mode of operation.
+ * @param buf     Pointer to buffer.
+ * @param size    Buffer size.
+ * @param iv      Initialisation vector or counter block, updated by the mode.
+ * @param decrypt Non-zero to decrypt.
+ * @return int    [0] if sucessful, [-1] on failure.
+ */
+static int run_mode(uaes_ctx_t *ctx, kat_mode_t mode, uint8_t *buf, size_t size, uint8_t *iv, int decrypt)
+{
+  int err = -1;
+
+  switch(mode)
+  {
+    case KAT_ECB:
+      err = (0 != decrypt) ? (uaes_ctx_ecb_decryption(ctx, buf, size)) : (uaes_ctx_ecb_encryption(ctx, buf, size));
+      break;
+    case KAT_CBC:
+      err = (0 != decrypt) ? (uaes_ctx_cbc_decryption(ctx, buf, size, iv)) : (uaes_ctx_cbc_encryption(ctx, buf, size, iv));
+      break;
+    case KAT_CFB:
+      err = (0 != decrypt) ? (uaes_ctx_cfb_decryption(ctx, buf, size, iv)) : (uaes_ctx_cfb_encryption(ctx, buf, size, iv));
+      break;
+    case KAT_OFB:
+      err = uaes_ctx_ofb_xcrypt(ctx, buf, size, iv);
+      break;
+    case KAT_CTR:
+      err = uaes_ctx_ctr_xcrypt(ctx, buf, size, iv, BLOCK_SIZE);
+      break;
+  }
+  return err;
+}
+
+static void kat_modes(void)
+{
+  uaes_ctx_t ctx;
+  uint8_t key[MAX_VECTOR_SIZE];
+  uint8_t pt[MAX_VECTOR_SIZE];
+  uint8_t ct[MAX_VECTOR_SIZE];
+  uint8_t buf[MAX_VECTOR_SIZE];
+  uint8_t iv[BLOCK_SIZE];
+  size_t size = 0;
+
+  for(size_t idx = 0; idx < (sizeof(mode_vectors) / sizeof(mode_vectors[0])); idx++)
+  {
+    const mode_vector_t *vec = &mode_vectors[idx];
+    const char *key_hex = (uAES128 == vec->aes_length) ? (sp800_38a_key128) :
+                          (uAES192 == vec->aes_length) ? (sp800_38a_key192) : (sp800_38a_key256);
+    const char *iv_hex = (KAT_CTR == vec->mode) ? (sp800_38a_ctr) : (sp800_38a_iv);
+
+    unhex(key_hex, key);
+    size = unhex(sp800_38a_pt, pt);
+    unhex(vec->ct, ct);
+    uaes_init(&ctx, key, vec->aes_length);
+
+    memcpy(buf, pt, size);
+    unhex(iv_hex, iv);
+    report(vec->name, "encrypt", (0 == run_mode(&ctx, vec->mode, buf, size, iv, 0)) && (0 == memcmp(buf, ct, size)));
+
+    unhex(iv_hex, iv);
+    report(vec->name, "decrypt", (0 == run_mode(&ctx, vec->mode, buf, size, iv, 1)) && (0 == memcmp(buf, pt, size)));
+  }
+  return;
+}
+
+/**
+ * @brief PCBC has no published vectors, the mode is checked against its definition
+ *        C[i] = E(P[i] ^ P[i-1] ^ C[i-1]), with P[0] ^ C[0] = IV, built from the block cipher.
+ */
+static void kat_pcbc(void)
+{
+  uaes_ctx_t ctx;
+  uint8_t key[MAX_VECTOR_SIZE];
+  uint8_t pt[MAX_VECTOR_SIZE];
+  uint8_t ct[MAX_VECTOR_SIZE];
+  uint8_t buf[MAX_VECTOR_SIZE];
+  uint8_t iv[BLOCK_SIZE];
+  uint8_t chain[BLOCK_SIZE];
+  size_t size = 0;
+
+  unhex(sp800_38a_key128, key);
+  size = unhex(sp800_38a_pt, pt);
+  uaes_init(&ctx, key, uAES128);
+
+  unhex(sp800_38a_iv, chain);
+  for(size_t off = 0; off < size; off += BLOCK_SIZE)
+  {
+    for(size_t byte = 0; byte < BLOCK_SIZE; byte++)
+    {
+      ct[off + byte] = pt[off + byte] ^ chain[byte];
+    }
+    uaes_ctx_block_encryption(&ctx, &ct[off], BLOCK_SIZE);
+    for(size_t byte = 0; byte < BLOCK_SIZE; byte++)
+    {
+      chain[byte] = pt[off + byte] ^ ct[off + byte];
+    }
+  }
+
+  memcpy(buf, pt, size);
+  unhex(sp800_38a_iv, iv);
+  report("PCBC-AES128 from the block cipher", "encrypt",
+         (0 == uaes_ctx_pcbc_encryption(&ctx, buf, size, iv)) && (0 == memcmp(buf, ct, size)));
+
+  unhex(sp800_38a_iv, iv);
+  report("PCBC-AES128 from the block cipher", "decrypt",
+         (0 == uaes_ctx_pcbc_decryption(&ctx, buf, size, iv)) && (0 == memcmp(buf, pt, size)));
+  return;
+}
+
+static void kat_gcm(void)
+{
+  uaes_ctx_t ctx;
+  uaes_gcm_t gcm;
+  uint8_t key[MAX_VECTOR_SIZE];
+  uint8_t iv[MAX_VECTOR_SIZE];
+  uint8_t aad[MAX_VECTOR_SIZE];
+  uint8_t pt[MAX_VECTOR_SIZE];
+  uint8_t ct[MAX_VECTOR_SIZE];
+  uint8_t buf[MAX_VECTOR_SIZE];
+  uint8_t tag[MAX_VECTOR_SIZE];
+  uint8_t out[BLOCK_SIZE];
+  size_t iv_size = 0;
+  size_t aad_size = 0;
+  size_t size = 0;
+
+  for(size_t idx = 0; idx < (sizeof(gcm_vectors) / sizeof(gcm_vectors[0])); idx++)
+  {
+    const gcm_vector_t *vec = &gcm_vectors[idx];
+
+    unhex(vec->key, key);
+    iv_size = unhex(vec->iv, iv);
+    aad_size = unhex(vec->aad, aad);
+    size = unhex(vec->pt, pt);
+    unhex(vec->ct, ct);
+    unhex(vec->tag, tag);
+    uaes_init(&ctx, key, uAES128);
+    uaes_gcm_init(&gcm, &ctx);
+
+    memcpy(buf, pt, size);
+    report(vec->name, "encrypt",
+           (0 == uaes_gcm_encrypt(&gcm, iv, iv_size, aad, aad_size, buf, size, out, BLOCK_SIZE)) &&
+           (0 == memcmp(buf, ct, size)) && (0 == memcmp(out, tag, BLOCK_SIZE)));
+
+    report(vec->name, "decrypt",
+           (0 == uaes_gcm_decrypt(&gcm, iv, iv_size, aad, aad_size, buf, size, tag, BLOCK_SIZE)) &&
+           (0 == memcmp(buf, pt, size)));
+
+    memcpy(buf, ct, size);
+    tag[BLOCK_SIZE - 1UL] ^= 0x01U;
+    report(vec->name, "tampered tag rejected",
+           (0 != uaes_gcm_decrypt(&gcm, iv, iv_size, aad, aad_size, buf, size, tag, BLOCK_SIZE)));
+  }
+  return;
+}
+
+static void kat_cmac(void)
+{
+  uaes_ctx_t ctx;
+  uaes_cmac_t cmac;
+  uint8_t key[MAX_VECTOR_SIZE];
+  uint8_t msg[MAX_VECTOR_SIZE];
+  uint8_t tag[BLOCK_SIZE];
+  uint8_t out[BLOCK_SIZE];
+  char name[32];
+
+  unhex(sp800_38a_key128, key);
+  unhex(sp800_38a_pt, msg);
+  uaes_init(&ctx, key, uAES128);
+  uaes_cmac_init(&cmac, &ctx);
+
+  for(size_t idx = 0; idx < (sizeof(cmac_sizes) / sizeof(cmac_sizes[0])); idx++)
+  {
+    snprintf(name, sizeof(name), "RFC 4493 example %lu", (unsigned long)(idx + 1UL));
+    unhex(cmac_tags[idx], tag);
+    report(name, "tag",
+           (0 == uaes_cmac(&cmac, msg, cmac_sizes[idx], out, BLOCK_SIZE)) && (0 == memcmp(out, tag, BLOCK_SIZE)));
+    report(name, "check", (0 == uaes_cmac_check(&cmac, msg, cmac_sizes[idx], tag, BLOCK_SIZE)));
+  }
+  return;
+}
+
+static void kat_xts(void)
+{
+  uaes_ctx_t ctx;
+  uaes_ctx_t tctx;
+  uaes_xts_t xts;
+  uint8_t key[MAX_VECTOR_SIZE];
+  uint8_t tkey[MAX_VECTOR_SIZE];
+  uint8_t pt[MAX_VECTOR_SIZE];
+  uint8_t ct[MAX_VECTOR_SIZE];
+  uint8_t buf[MAX_VECTOR_SIZE];
+  uint8_t tweak[BLOCK_SIZE];
+  size_t size = 0;
+
+  for(size_t idx = 0; idx < (sizeof(xts_vectors) / sizeof(xts_vectors[0])); idx++)
+  {
+    const xts_vector_t *vec = &xts_vectors[idx];
+
+    unhex(vec->key1, key);
+    unhex(vec->key2, tkey);
+    size = unhex(vec->pt, pt);
+    unhex(vec->ct, ct);
+    uaes_init(&ctx, key, uAES128);
+    uaes_init(&tctx, tkey, uAES128);
+    uaes_xts_init(&xts, &ctx, &tctx);
+
+    /* The tweak is the little-endian data unit number. */
+    memset(tweak, 0, sizeof(tweak));
+    for(size_t byte = 0; byte < sizeof(vec->sector); byte++)
+    {
+      tweak[byte] = (uint8_t)(vec->sector >> (8UL * byte));
+    }
+
+    memcpy(buf, pt, size);
+    report(vec->name, "encrypt", (0 == uaes_xts_encrypt(&xts, tweak, buf, size)) && (0 == memcmp(buf, ct, size)));
+    report(vec->name, "decrypt", (0 == uaes_xts_decrypt(&xts, tweak, buf, size)) && (0 == memcmp(buf, pt, size)));
+
+    report(vec->name, "encrypt sectors",
+           (0 == uaes_xts_encrypt_sectors(&xts, vec->sector, buf, size, 1UL)) && (0 == memcmp(buf, ct, size)));
+    report(vec->name, "decrypt sectors",
+           (0 == uaes_xts_decrypt_sectors(&xts, vec->sector, buf, size, 1UL)) && (0 == memcmp(buf, pt, size)));
+  }
+  return;
+}
+
+int main(int argc, char **argv)
+{
+  if((1 < argc) && (0 == strcmp(argv[1], "-h")))
+  {
+    printf("kat: Checks uAES against published known-answer vectors, NIST SP 800-38A for ECB, CBC,\n");
+    printf("CFB, OFB and CTR, the GCM specification test cases, RFC 4493 for CMAC and IEEE 1619 for\n");
+    printf("XTS. PCBC is checked against its definition built from the block cipher.\n");
+    printf("usage: kat\n");
+    printf("Exits with a failure status if any check fails.\n\n");
+    exit(EXIT_SUCCESS);
+  }
+
+  kat_modes();
+  kat_pcbc();
+  kat_gcm();
+  kat_cmac();
+  kat_xts();
+
+  printf("\n%u passed, %u failed\n", passed, failed);
+  return (0U != failed) ? (EXIT_FAILURE) : (EXIT_SUCCESS);
+}
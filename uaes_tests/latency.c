@@ -0,0 +1,363 @@
+/**
+ * @file    latency.c
+ * @author  Antonio Vitor Grossi Bassi
+ * @brief   Per-call latency benchmark for key setup, single blocks and short CBC messages.
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ *  Copyright (C) 2023, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ */
+
+#define _GNU_SOURCE
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdint.h"
+#include "string.h"
+#include "time.h"
+#ifdef __linux__
+#include "sched.h"
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include "x86intrin.h"
+#define LAT_TSC
+#endif
+#include "../uaes.h"
+
+#define MAX_SAMPLES           (1000000UL)
+#define MAX_MSG_SIZE          (256UL)
+#define EVICT_SIZE            (32UL*MB)
+
+/**
+ * @brief Arguments of a timed call. The context is expanded before timing starts, except for
+ *        the key expansion itself.
+ */
+typedef struct lat_arg
+{
+  uaes_ctx_t    *ctx;
+  uint8_t       *key;
+  aes_length_t  len;
+  uint8_t       *buf;
+  size_t        size;
+  uint8_t       *iv;
+}lat_arg_t;
+
+typedef struct lat_op
+{
+  const char  *name;
+  size_t      size;
+  int         (*run)(lat_arg_t *arg);
+}lat_op_t;
+
+static int key_expansion(lat_arg_t *arg)
+{
+  return uaes_init(arg->ctx, arg->key, arg->len);
+}
+
+static int block_enc(lat_arg_t *arg)
+{
+  return uaes_ctx_block_encryption(arg->ctx, arg->buf, arg->size);
+}
+
+static int block_dec(lat_arg_t *arg)
+{
+  return uaes_ctx_block_decryption(arg->ctx, arg->buf, arg->size);
+}
+
+static int oneshot_enc(lat_arg_t *arg)
+{
+  return (uAES128 == arg->len) ? (uaes128enc(arg->buf, arg->key, arg->size)) :
+         ((uAES192 == arg->len) ? (uaes192enc(arg->buf, arg->key, arg->size)) : (uaes256enc(arg->buf, arg->key, arg->size)));
+}
+
+static int oneshot_dec(lat_arg_t *arg)
+{
+  return (uAES128 == arg->len) ? (uaes128dec(arg->buf, arg->key, arg->size)) :
+         ((uAES192 == arg->len) ? (uaes192dec(arg->buf, arg->key, arg->size)) : (uaes256dec(arg->buf, arg->key, arg->size)));
+}
+
+static int cbc_enc(lat_arg_t *arg)
+{
+  return uaes_cbc_encryption(arg->buf, arg->size, arg->key, arg->iv, arg->len);
+}
+
+static int cbc_dec(lat_arg_t *arg)
+{
+  return uaes_cbc_decryption(arg->buf, arg->size, arg->key, arg->iv, arg->len);
+}
+
+static int ctx_cbc_enc(lat_arg_t *arg)
+{
+  return uaes_ctx_cbc_encryption(arg->ctx, arg->buf, arg->size, arg->iv);
+}
+
+static int ctx_cbc_dec(lat_arg_t *arg)
+{
+  return uaes_ctx_cbc_decryption(arg->ctx, arg->buf, arg->size, arg->iv);
+}
+
+static const lat_op_t ops[] =
+{
+  { "key-expansion",  0UL,   key_expansion },
+  { "block-enc",      16UL,  block_enc },
+  { "block-dec",      16UL,  block_dec },
+  { "oneshot-enc",    16UL,  oneshot_enc },
+  { "oneshot-dec",    16UL,  oneshot_dec },
+  { "cbc-enc",        16UL,  cbc_enc },
+  { "cbc-enc",        64UL,  cbc_enc },
+  { "cbc-enc",        256UL, cbc_enc },
+  { "cbc-dec",        16UL,  cbc_dec },
+  { "cbc-dec",        64UL,  cbc_dec },
+  { "cbc-dec",        256UL, cbc_dec },
+  { "ctx-cbc-enc",    64UL,  ctx_cbc_enc },
+  { "ctx-cbc-dec",    64UL,  ctx_cbc_dec },
+};
+
+static const struct
+{
+  aes_length_t  len;
+  unsigned      bits;
+}keys[] =
+{
+  { uAES128, 128U },
+  { uAES192, 192U },
+  { uAES256, 256U },
+};
+
+/**
+ * @brief Serialised timestamp, TSC reference cycles on x86 and nanoseconds elsewhere.
+ */
+static inline uint64_t lat_start(void)
+{
+#ifdef LAT_TSC
+  uint64_t t;
+  _mm_lfence();
+  t = __rdtsc();
+  _mm_lfence();
+  return t;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline uint64_t lat_stop(void)
+{
+#ifdef LAT_TSC
+  unsigned int aux;
+  uint64_t t = __rdtscp(&aux);
+  _mm_lfence();
+  return t;
+#else
+  return lat_start();
+#endif
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples.
+ */
+static uint64_t percentile(const uint64_t *v, size_t n, double p)
+{
+  size_t rank = (size_t)((p / 100.0) * (double)n + 0.999999);
+  rank = (0UL == rank) ? (1UL) : ((n < rank) ? (n) : (rank));
+  return v[rank - 1UL];
+}
+
+/**
+ * @brief Pushes the library tables, the context and the message out of the data caches by
+ *        walking a buffer larger than the last level cache.
+ */
+static void evict(volatile uint8_t *junk, size_t size)
+{
+  size_t i = 0;
+  for(i = 0; i < size; i += 64UL)
+  {
+    junk[i]++;
+  }
+}
+
+static void pin_cpu(int cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+  if(0 <= cpu)
+  {
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if(0 != sched_setaffinity(0, sizeof(set), &set))
+    {
+      fprintf(stderr, "latency: could not pin to cpu %d, running unpinned\n", cpu);
+    }
+  }
+#else
+  (void)cpu;
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  const char *csv = NULL;
+  FILE *f = NULL;
+  size_t samples = 0UL, evict_size = EVICT_SIZE, o = 0, k = 0, i = 0;
+  int cpu = 0, cold = 0, arg = 1;
+  uint64_t t0 = 0, t1 = 0, overhead = 0;
+  uint64_t *lat = NULL;
+  uint8_t *junk = NULL;
+  uint8_t key[32], iv[uAES_BLOCK_SIZE], buf[MAX_MSG_SIZE];
+  uaes_ctx_t ctx;
+  lat_arg_t a = { &ctx, key, uAES128, buf, 0UL, iv };
+#ifdef LAT_TSC
+  const char *unit = "cycles";
+#else
+  const char *unit = "ns";
+#endif
+
+  while(argc > arg)
+  {
+    if((0 == strcmp(argv[arg], "-n")) && (argc > (arg + 1)))
+    {
+      samples = strtoul(argv[++arg], NULL, 0);
+      samples = (MAX_SAMPLES < samples) ? (MAX_SAMPLES) : (samples);
+    }
+    else if(0 == strcmp(argv[arg], "-cold"))
+    {
+      cold = 1;
+    }
+    else if((0 == strcmp(argv[arg], "-e")) && (argc > (arg + 1)))
+    {
+      evict_size = strtoul(argv[++arg], NULL, 0);
+    }
+    else if((0 == strcmp(argv[arg], "-p")) && (argc > (arg + 1)))
+    {
+      cpu = atoi(argv[++arg]);
+    }
+    else if((0 == strcmp(argv[arg], "-csv")) && (argc > (arg + 1)))
+    {
+      csv = argv[++arg];
+    }
+    else
+    {
+      printf("latency: Per-call latency of uAES key setup, single blocks and short CBC messages.\n");
+      printf("usage: latency [-n SAMPLES] [-cold] [-e EVICT SIZE] [-p CPU] [-csv FILE]\n");
+      printf("\"-n\", calls timed per operation (default 100000 warm, 2000 cold).\n");
+      printf("\"-cold\", evicts the data caches before every call instead of repeating it back to back.\n");
+      printf("\"-e\", bytes walked to evict the caches, at least the last level cache size (default %lu).\n", (unsigned long)EVICT_SIZE);
+      printf("\"-p\", CPU to pin the benchmark to, -1 leaves it unpinned (default 0).\n");
+      printf("\"-csv\", also write the percentiles to FILE.\n");
+      printf("oneshot-* and cbc-* expand the key on every call, block-* and ctx-* use an expanded context.\n\n");
+      exit(EXIT_SUCCESS);
+    }
+    arg++;
+  }
+
+  samples = (0UL != samples) ? (samples) : ((0 != cold) ? (2000UL) : (100000UL));
+  lat = (uint64_t *)malloc(samples * sizeof(uint64_t));
+  junk = (0 != cold) ? ((uint8_t *)calloc(1UL, evict_size)) : (NULL);
+  if((NULL == lat) || ((0 != cold) && (NULL == junk)))
+  {
+    fprintf(stderr, "latency: out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  if(NULL != csv)
+  {
+    f = fopen(csv, "w");
+    if(NULL == f)
+    {
+      fprintf(stderr, "latency: cannot open %s\n", csv);
+      exit(EXIT_FAILURE);
+    }
+    fprintf(f, "op,key_bits,size,caches,unit,p50,p90,p99,p99.9,max\n");
+  }
+
+  pin_cpu(cpu);
+  srand(1);
+  for(i = 0; i < sizeof(key); i++)
+  {
+    key[i] = (uint8_t)rand();
+  }
+  for(i = 0; i < sizeof(buf); i++)
+  {
+    buf[i] = (uint8_t)rand();
+  }
+  memset((void *)iv, 0xA5, sizeof(iv));
+
+  for(i = 0; i < samples; i++)
+  {
+    t0 = lat_start();
+    t1 = lat_stop();
+    lat[i] = t1 - t0;
+  }
+  qsort(lat, samples, sizeof(uint64_t), cmp_u64);
+  overhead = percentile(lat, samples, 50.0);
+
+  printf("%s caches, %zu samples, cpu %d, %s, timer overhead %llu (not subtracted)\n",
+         (0 != cold) ? ("cold") : ("warm"), samples, cpu, unit, (unsigned long long)overhead);
+  printf("%-14s %4s %5s %8s %8s %8s %8s %10s\n", "op", "key", "size", "p50", "p90", "p99", "p99.9", "max");
+  for(o = 0; o < (sizeof(ops) / sizeof(ops[0])); o++)
+  {
+    for(k = 0; k < (sizeof(keys) / sizeof(keys[0])); k++)
+    {
+      a.len = keys[k].len;
+      a.size = ops[o].size;
+      uaes_init(&ctx, key, a.len);
+      for(i = 0; i < 64UL; i++)
+      {
+        ops[o].run(&a);
+      }
+      for(i = 0; i < samples; i++)
+      {
+        if(0 != cold)
+        {
+          evict(junk, evict_size);
+        }
+        t0 = lat_start();
+        ops[o].run(&a);
+        t1 = lat_stop();
+        lat[i] = t1 - t0;
+      }
+      qsort(lat, samples, sizeof(uint64_t), cmp_u64);
+      printf("%-14s %4u %5zu %8llu %8llu %8llu %8llu %10llu\n", ops[o].name, keys[k].bits, ops[o].size,
+             (unsigned long long)percentile(lat, samples, 50.0), (unsigned long long)percentile(lat, samples, 90.0),
+             (unsigned long long)percentile(lat, samples, 99.0), (unsigned long long)percentile(lat, samples, 99.9),
+             (unsigned long long)lat[samples - 1UL]);
+      if(NULL != f)
+      {
+        fprintf(f, "%s,%u,%zu,%s,%s,%llu,%llu,%llu,%llu,%llu\n", ops[o].name, keys[k].bits, ops[o].size,
+                (0 != cold) ? ("cold") : ("warm"), unit,
+                (unsigned long long)percentile(lat, samples, 50.0), (unsigned long long)percentile(lat, samples, 90.0),
+                (unsigned long long)percentile(lat, samples, 99.0), (unsigned long long)percentile(lat, samples, 99.9),
+                (unsigned long long)lat[samples - 1UL]);
+      }
+    }
+  }
+  uaes_wipe(&ctx);
+
+  if(NULL != f)
+  {
+    fclose(f);
+  }
+  free(junk);
+  free(lat);
+  return EXIT_SUCCESS;
+}
@@ -36,7 +36,8 @@ typedef enum
   uAES_ECB  = 0,
   uAES_CBC  = 1,
   uAES_PCBC = 2,
-  uAES_CFB  = 3
+  uAES_CFB  = 3,
+  uAES_OFB  = 4
 }cipher_t;
 
 typedef enum
@@ -148,6 +149,18 @@ int main(int argc, char **argv)
         {
           cipher_mode = uAES_CBC;
         }
+        else if(0 == strcmp(argv[arg], "PCBC"))
+        {
+          cipher_mode = uAES_PCBC;
+        }
+        else if(0 == strcmp(argv[arg], "CFB"))
+        {
+          cipher_mode = uAES_CFB;
+        }
+        else if(0 == strcmp(argv[arg], "OFB"))
+        {
+          cipher_mode = uAES_OFB;
+        }
       }
       else if((0 == strcmp(argv[arg], "-d"))  && (rd_argmsk(&argmsk, ARG_MSK_MODE)))
       {
@@ -161,7 +174,7 @@ int main(int argc, char **argv)
         printf("Takes following arguments:\n\"-f\", file name with extension.\n\"-o\", output file name with extension.\n");
         printf("\"-k\", AES key value, if lenght is less than the specified in argument \"-t\" padding is applied.\n");
         printf("\"-t\", Cryptography mode, can be 128, 192 or 256.\n");
-        printf("\"-c\", Cipher mode, can be EBC or CBC.\n");
+        printf("\"-c\", Cipher mode, can be ECB, CBC, PCBC, CFB or OFB.\n");
         printf("\"-d\", Specifies decryption operation. If nothing is specified, encryption is performed.\n");
         printf("example: scrypt -f \"yourpic.bmp\" -o \"res.bmp\" -k \"youarebeautiful!\" -t 128 -c ECB\n\n");
         exit(EXIT_SUCCESS);
@@ -278,6 +291,104 @@ int main(int argc, char **argv)
           }
           break;
         }
+        case uAES_PCBC:
+        {
+          switch(encryption_type)
+          {
+            case uAES128:
+              iv = input_aes128;
+              break;
+            case uAES192:
+              iv = input_aes192;
+              break;
+            case uAES256:
+              iv = input_aes256;
+              break;
+          }
+          if( uAES_ENCRYPT == operation_mode )
+          {
+            err = uaes_pcbc_encryption(r, pxLayer_size, key, iv, encryption_type);
+            err = uaes_pcbc_encryption(g, pxLayer_size, key, iv, encryption_type);
+            err = uaes_pcbc_encryption(b, pxLayer_size, key, iv, encryption_type);
+          }
+          else if(uAES_DECRYPT == operation_mode)
+          { 
+            err = uaes_pcbc_decryption(r, pxLayer_size, key, iv, encryption_type);
+            err = uaes_pcbc_decryption(g, pxLayer_size, key, iv, encryption_type);
+            err = uaes_pcbc_decryption(b, pxLayer_size, key, iv, encryption_type);
+          }
+          for(int x = 0; x < w; x++)
+          {
+            for(int y = 0; y < h; y++)
+            {
+              set_pixel_rgb(img, x, y, r[(y*img->width) + x], g[(y*img->width) + x], b[(y*img->width) + x]);
+            }
+          }
+          break;
+        }
+        case uAES_CFB:
+        {
+          switch(encryption_type)
+          {
+            case uAES128:
+              iv = input_aes128;
+              break;
+            case uAES192:
+              iv = input_aes192;
+              break;
+            case uAES256:
+              iv = input_aes256;
+              break;
+          }
+          /* The IV carries the feedback from one layer into the next. */
+          if( uAES_ENCRYPT == operation_mode )
+          {
+            err = uaes_cfb_encryption(r, pxLayer_size, key, iv, encryption_type);
+            err = uaes_cfb_encryption(g, pxLayer_size, key, iv, encryption_type);
+            err = uaes_cfb_encryption(b, pxLayer_size, key, iv, encryption_type);
+          }
+          else if(uAES_DECRYPT == operation_mode)
+          { 
+            err = uaes_cfb_decryption(r, pxLayer_size, key, iv, encryption_type);
+            err = uaes_cfb_decryption(g, pxLayer_size, key, iv, encryption_type);
+            err = uaes_cfb_decryption(b, pxLayer_size, key, iv, encryption_type);
+          }
+          for(int x = 0; x < w; x++)
+          {
+            for(int y = 0; y < h; y++)
+            {
+              set_pixel_rgb(img, x, y, r[(y*img->width) + x], g[(y*img->width) + x], b[(y*img->width) + x]);
+            }
+          }
+          break;
+        }
+        case uAES_OFB:
+        {
+          switch(encryption_type)
+          {
+            case uAES128:
+              iv = input_aes128;
+              break;
+            case uAES192:
+              iv = input_aes192;
+              break;
+            case uAES256:
+              iv = input_aes256;
+              break;
+          }
+          /* The IV carries the feedback from one layer into the next. */
+          err = uaes_ofb_xcrypt(r, pxLayer_size, key, iv, encryption_type);
+          err = uaes_ofb_xcrypt(g, pxLayer_size, key, iv, encryption_type);
+          err = uaes_ofb_xcrypt(b, pxLayer_size, key, iv, encryption_type);
+          for(int x = 0; x < w; x++)
+          {
+            for(int y = 0; y < h; y++)
+            {
+              set_pixel_rgb(img, x, y, r[(y*img->width) + x], g[(y*img->width) + x], b[(y*img->width) + x]);
+            }
+          }
+          break;
+        }
       }
       bwrite(img, outf);
       bclose(img);
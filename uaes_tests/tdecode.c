@@ -0,0 +1,269 @@
+/**
+ * @file    tdecode.c
+ * @author  Antonio Vitor Grossi Bassi
+ * @brief   Renders uAES trace files in the text format of the printf tracing backend.
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ *  Copyright (C) 2023, Antonio Vitor Grossi Bassi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdint.h"
+#include "string.h"
+#include "../uaes.h"
+
+#define MAX_SPEC_SIZE         (32UL)
+
+typedef struct site
+{
+  uint8_t kind;
+  char    *fmt;
+}site_t;
+
+/**
+ * @brief Prints one conversion of a trace format. Arguments were recorded as 64-bit values, so
+ *        conversions without a length modifier are narrowed back to int first. Conversions
+ *        that cannot come from an integer print "?".
+ * @param spec  Conversion, from '%' to its conversion character.
+ * @param len   Length of the conversion.
+ * @param arg   Argument.
+ */
+static void render_spec(const char *spec, size_t len, uint64_t arg)
+{
+  char fmt[MAX_SPEC_SIZE + 3UL];
+  char conv = spec[len - 1UL];
+  size_t body = len - 1UL;
+  int wide = 0;
+
+  /* Drops the length modifier, the value is printed through long long. */
+  while(( 1UL < body ) && ( NULL != strchr("hljztL", spec[body - 1UL]) ))
+  {
+    wide |= ( 'h' != spec[body - 1UL] ) ? ( 1 ) : ( 0 );
+    body--;
+  }
+  if(( MAX_SPEC_SIZE < body ) || ( NULL == strchr("diouxXc", conv) ))
+  {
+    printf("?");
+    return;
+  }
+  memcpy(fmt, spec, body);
+  if('c' == conv)
+  {
+    fmt[body] = 'c';
+    fmt[body + 1UL] = '\0';
+    printf(fmt, ( int )( arg ));
+    return;
+  }
+  fmt[body] = 'l';
+  fmt[body + 1UL] = 'l';
+  fmt[body + 2UL] = conv;
+  fmt[body + 3UL] = '\0';
+  if(( 'd' == conv ) || ( 'i' == conv ))
+  {
+    printf(fmt, ( 0 != wide ) ? ( ( long long )( arg ) ) : ( ( long long )( ( int32_t )( arg ) ) ));
+  }
+  else
+  {
+    printf(fmt, ( 0 != wide ) ? ( ( unsigned long long )( arg ) ) : ( ( unsigned long long )( ( uint32_t )( arg ) ) ));
+  }
+  return;
+}
+
+/**
+ * @brief Prints a trace format with its recorded arguments, missing arguments print as 0.
+ * @param fmt   Trace format.
+ * @param args  Arguments.
+ * @param nargs Number of arguments.
+ */
+static void render(const char *fmt, const uint64_t *args, size_t nargs)
+{
+  size_t next = 0;
+  size_t len = 0;
+
+  while('\0' != *fmt)
+  {
+    if('%' != *fmt)
+    {
+      putchar(*fmt++);
+      continue;
+    }
+    if('%' == fmt[1])
+    {
+      putchar('%');
+      fmt += 2;
+      continue;
+    }
+    len = 1UL + strspn(&fmt[1], "-+ #0123456789.hljztL");
+    if('\0' == fmt[len])
+    {
+      fputs(fmt, stdout);
+      return;
+    }
+    len++;
+    render_spec(fmt, len, ( next < nargs ) ? ( args[next] ) : ( 0U ));
+    next++;
+    fmt += len;
+  }
+  return;
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = NULL;
+  unsigned long filter = 0xFFUL;
+  int timestamps = 0;
+  int arg = 1;
+  int err = 0;
+  FILE *fp = NULL;
+  uaes_trace_hdr_t hdr;
+  uaes_trace_ring_hdr_t ring;
+  uaes_trace_rec_t rec;
+  site_t *sites = NULL;
+  uint16_t len = 0;
+
+  while(argc > arg)
+  {
+    if((0 == strcmp(argv[arg], "-m")) && (argc > (arg + 1)))
+    {
+      filter = strtoul(argv[++arg], NULL, 0);
+    }
+    else if(0 == strcmp(argv[arg], "-ts"))
+    {
+      timestamps = 1;
+    }
+    else if(0 == strcmp(argv[arg], "-h"))
+    {
+      printf("tdecode: Renders a uAES trace file as the dbg[] lines of the printf tracing backend.\n");
+      printf("usage: tdecode [PARAMETERS] [TRACE FILE]\n");
+      printf("Takes following arguments:\n\"-m\", trace mask, only records of its bits are printed.\n");
+      printf("\"-ts\", starts every line with the clock ticks of its record.\n");
+      printf("The records of every thread are printed in order, one thread after the other. Thread,\n");
+      printf("overwritten and lost record counts go to stderr.\n");
+      printf("example: tdecode -m 0x01 uaes.trace\n\n");
+      exit(EXIT_SUCCESS);
+    }
+    else if((NULL == path) && ('-' != argv[arg][0]))
+    {
+      path = argv[arg];
+    }
+    else
+    {
+      fprintf(stderr, "tdecode: bad argument \"%s\", see tdecode -h\n", argv[arg]);
+      exit(EXIT_FAILURE);
+    }
+    arg++;
+  }
+
+  fp = fopen((NULL != path) ? (path) : (uAES_TRACE_FILE), "rb");
+  if(NULL == fp)
+  {
+    fprintf(stderr, "tdecode: cannot open %s\n", (NULL != path) ? (path) : (uAES_TRACE_FILE));
+    exit(EXIT_FAILURE);
+  }
+  if((1UL != fread(&hdr, sizeof(hdr), 1UL, fp)) || (0 != memcmp(hdr.magic, uAES_TRACE_MAGIC, sizeof(uAES_TRACE_MAGIC))))
+  {
+    fprintf(stderr, "tdecode: not a uAES trace file\n");
+    exit(EXIT_FAILURE);
+  }
+  if((uAES_TRACE_BOM != hdr.bom) || (sizeof(uaes_trace_rec_t) != hdr.rec_size))
+  {
+    fprintf(stderr, "tdecode: trace recorded with another byte order or record layout\n");
+    exit(EXIT_FAILURE);
+  }
+
+  sites = calloc((0U != hdr.nsites) ? (hdr.nsites) : (1U), sizeof(site_t));
+  for(uint32_t idx = 0; (0 == err) && (idx < hdr.nsites); idx++)
+  {
+    if((1UL != fread(&sites[idx].kind, sizeof(uint8_t), 1UL, fp)) || (1UL != fread(&len, sizeof(len), 1UL, fp)) ||
+       (NULL == (sites[idx].fmt = calloc(len + 1UL, 1UL))) || ((0U != len) && (1UL != fread(sites[idx].fmt, len, 1UL, fp))))
+    {
+      err = -1;
+    }
+  }
+
+  for(uint32_t idx = 0; (0 == err) && (idx < hdr.nrings); idx++)
+  {
+    size_t skipped = 0;
+
+    if(1UL != fread(&ring, sizeof(ring), 1UL, fp))
+    {
+      err = -1;
+      break;
+    }
+    fprintf(stderr, "tdecode: thread %u, %u records, %u overwritten\n", idx, ring.nrec, ring.overwritten);
+    for(uint32_t pos = 0; (0 == err) && (pos < ring.nrec); pos++)
+    {
+      if(1UL != fread(&rec, sizeof(rec), 1UL, fp))
+      {
+        err = -1;
+        break;
+      }
+      /* Site 0 marks records overwritten during the save or traced with a full site table. */
+      if((0U == rec.site) || (hdr.nsites < rec.site) || ('\0' == sites[rec.site - 1U].fmt[0]))
+      {
+        skipped++;
+        continue;
+      }
+      if(0UL == (rec.msk & filter))
+      {
+        continue;
+      }
+      if(0 != timestamps)
+      {
+        printf("[%llu] ", (unsigned long long)(rec.ts));
+      }
+      printf("dbg[%u]:", rec.line);
+      if(uAES_TRACE_SITE_BLOCK == sites[rec.site - 1U].kind)
+      {
+        uint64_t round = rec.round;
+
+        render(sites[rec.site - 1U].fmt, &round, 1UL);
+        for(size_t byte = 0; byte < sizeof(rec.data.state); byte++)
+        {
+          printf("%.2x", rec.data.state[byte]);
+        }
+      }
+      else
+      {
+        render(sites[rec.site - 1U].fmt, rec.data.args, uAES_TRACE_MAX_ARGS);
+      }
+      printf("\n");
+    }
+    if(0UL != skipped)
+    {
+      fprintf(stderr, "tdecode: thread %u, %lu unreadable records skipped\n", idx, (unsigned long)(skipped));
+    }
+  }
+  if(0U != hdr.lost)
+  {
+    fprintf(stderr, "tdecode: %llu records lost by threads without a ring\n", (unsigned long long)(hdr.lost));
+  }
+  if(0 != err)
+  {
+    fprintf(stderr, "tdecode: truncated trace file\n");
+  }
+
+  for(uint32_t idx = 0; idx < hdr.nsites; idx++)
+  {
+    free(sites[idx].fmt);
+  }
+  free(sites);
+  fclose(fp);
+  return (0 != err) ? (EXIT_FAILURE) : (EXIT_SUCCESS);
+}
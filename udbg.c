@@ -0,0 +1,334 @@
+/**
+ * @file      udbg.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Per-thread binary trace rings of uAES.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "uaes.h"
+
+#if defined(__uAES_DEBUG__) && defined(__uAES_TRACE_RING__)
+
+#if !defined(uAES_TRACE_CLOCK) && ( defined(__x86_64__) || defined(__i386__) )
+#include <x86intrin.h>
+#elif !defined(uAES_TRACE_CLOCK) && !defined(__aarch64__)
+#include <time.h>
+#endif
+
+#if ( 0UL != ( uAES_TRACE_RING_SIZE & ( uAES_TRACE_RING_SIZE - 1UL ) ) )
+#error "uAES_TRACE_RING_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief Trace ring of one thread. Only its thread writes records and head, head is published
+ *        after every record so that rings can be saved while their threads keep tracing.
+ */
+typedef struct udbg_ring
+{
+  uint32_t          head;                         // Records written since the last reset.
+  uaes_trace_rec_t  rec[uAES_TRACE_RING_SIZE];
+}udbg_ring_t;
+
+typedef struct udbg_site
+{
+  const char        *fmt;
+  uint8_t           kind;
+}udbg_site_t;
+
+/**
+ * @brief Rings and trace points. A thread takes the next free ring on its first record and keeps
+ *        it after it exits so that its records can still be saved. Records of threads past the
+ *        last ring are counted as lost, rings are never shared.
+ */
+static udbg_ring_t  rings[uAES_TRACE_THREADS];
+static uint32_t     nrings = 0U;
+static udbg_site_t  sites[uAES_TRACE_SITES];
+static uint32_t     nsites = 0U;
+static uint32_t     lost = 0U;
+
+_Thread_local uint32_t udbg_line = 0U;
+static _Thread_local udbg_ring_t *udbg_self = NULL;
+static _Thread_local int udbg_ringless = 0;
+
+static inline uint64_t udbg_clock(void);
+static udbg_ring_t *udbg_claim(void);
+static uaes_trace_rec_t *udbg_next(udbg_ring_t **ring);
+static inline void udbg_publish(udbg_ring_t *ring);
+
+/**
+ * @brief           Reads the trace clock, the time-stamp counter on x86, the virtual counter on
+ *                  AArch64 and a monotonic clock in nanoseconds elsewhere. Defining
+ *                  uAES_TRACE_CLOCK() selects another clock.
+ * @return uint64_t Clock ticks.
+ */
+static inline uint64_t udbg_clock(void)
+{
+#if defined(uAES_TRACE_CLOCK)
+  return ( uint64_t )( uAES_TRACE_CLOCK() );
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( ( uint64_t )( ts.tv_sec ) * 1000000000ULL ) + ( uint64_t )( ts.tv_nsec );
+#endif
+}
+
+/**
+ * @brief               Hands the calling thread its ring.
+ * @return udbg_ring_t* Ring, NULL when every ring is taken.
+ */
+static udbg_ring_t *udbg_claim(void)
+{
+  uint32_t ring = __atomic_load_n(&nrings, __ATOMIC_RELAXED);
+
+  do
+  {
+    if(uAES_TRACE_THREADS <= ring)
+    {
+      udbg_ringless = 1;
+      return NULL;
+    }
+  }while(!__atomic_compare_exchange_n(&nrings, &ring, ring + 1U, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  udbg_self = &rings[ring];
+  return udbg_self;
+}
+
+/**
+ * @brief                     Takes the slot of the next record of the calling thread, the
+ *                            oldest record is overwritten once the ring is full.
+ * @param ring                Receives the ring of the thread.
+ * @return uaes_trace_rec_t*  Record slot, NULL when the thread has no ring.
+ */
+static uaes_trace_rec_t *udbg_next(udbg_ring_t **ring)
+{
+  udbg_ring_t *self = udbg_self;
+
+  if(( NULL == self ) && ( 0 == udbg_ringless ))
+  {
+    self = udbg_claim();
+  }
+  if(NULL == self)
+  {
+    __atomic_fetch_add(&lost, 1U, __ATOMIC_RELAXED);
+    return NULL;
+  }
+  /* Keeps the new record from being seen before the head that reserves its slot. */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  *ring = self;
+  return &self->rec[self->head & ( uAES_TRACE_RING_SIZE - 1UL )];
+}
+
+/**
+ * @brief       Publishes the record written last.
+ * @param ring  Ring of the calling thread.
+ */
+static inline void udbg_publish(udbg_ring_t *ring)
+{
+  __atomic_store_n(&ring->head, ring->head + 1U, __ATOMIC_RELEASE);
+  return;
+}
+
+/**
+ * @brief             Registers a trace point.
+ * @param fmt         Format of the trace point.
+ * @param kind        uAES_TRACE_SITE_MSG or uAES_TRACE_SITE_BLOCK.
+ * @return uint16_t   Site number, [0] when the site table is full.
+ */
+uint16_t udbg_site(const char *fmt, uint8_t kind)
+{
+  uint32_t site = __atomic_load_n(&nsites, __ATOMIC_RELAXED);
+
+  do
+  {
+    if(uAES_TRACE_SITES <= site)
+    {
+      return 0U;
+    }
+  }while(!__atomic_compare_exchange_n(&nsites, &site, site + 1U, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  sites[site].kind = kind;
+  __atomic_store_n(&sites[site].fmt, fmt, __ATOMIC_RELEASE);
+  return ( uint16_t )( site + 1U );
+}
+
+/**
+ * @brief       Records a message.
+ * @param msk   Trace mask bit.
+ * @param site  Site number.
+ * @param line  Trace point count of the thread.
+ * @param nargs Number of arguments.
+ * @param args  Arguments.
+ */
+void udbg_msg(uint8_t msk, uint16_t site, uint32_t line, size_t nargs, const uint64_t *args)
+{
+  udbg_ring_t *ring = NULL;
+  uaes_trace_rec_t *rec = udbg_next(&ring);
+
+  if(NULL != rec)
+  {
+    rec->ts = udbg_clock();
+    rec->line = line;
+    rec->site = site;
+    rec->msk = msk;
+    rec->round = 0U;
+    rec->data.args[0] = ( 0UL < nargs ) ? ( args[0] ) : ( 0U );
+    rec->data.args[1] = ( 1UL < nargs ) ? ( args[1] ) : ( 0U );
+    udbg_publish(ring);
+  }
+  return;
+}
+
+/**
+ * @brief       Records a block.
+ * @param msk   Trace mask bit.
+ * @param site  Site number.
+ * @param line  Trace point count of the thread.
+ * @param block Block or cipher state.
+ * @param round Round number.
+ */
+void udbg_block(uint8_t msk, uint16_t site, uint32_t line, const uint8_t *block, size_t round)
+{
+  udbg_ring_t *ring = NULL;
+  uaes_trace_rec_t *rec = udbg_next(&ring);
+
+  if(NULL != rec)
+  {
+    rec->ts = udbg_clock();
+    rec->line = line;
+    rec->site = site;
+    rec->msk = msk;
+    rec->round = ( uint8_t )( round );
+    memcpy((void *)rec->data.state, (const void *)block, sizeof(rec->data.state));
+    udbg_publish(ring);
+  }
+  return;
+}
+
+/**
+ * @brief Drops the records of the calling thread and restarts its trace point count.
+ */
+void udbg_reset(void)
+{
+  udbg_line = 0U;
+  if(NULL != udbg_self)
+  {
+    __atomic_store_n(&udbg_self->head, 0U, __ATOMIC_RELEASE);
+  }
+  return;
+}
+
+/**
+ * @brief       Writes the site table and the records of every ring to a file, see udbg.h for
+ *              its layout. Records overwritten while they are copied are written with site 0.
+ * @param path  File path.
+ * @return int  [0] if sucessful, [-1] on failure.
+ */
+int udbg_save(const char *path)
+{
+  uaes_trace_hdr_t hdr;
+  uaes_trace_ring_hdr_t ring_hdr;
+  uaes_trace_rec_t rec;
+  FILE *fp = fopen(path, "wb");
+  int err = -1;
+
+  if(NULL != fp)
+  {
+    memset((void *)&hdr, 0, sizeof(hdr));
+    memcpy((void *)hdr.magic, uAES_TRACE_MAGIC, sizeof(uAES_TRACE_MAGIC));
+    hdr.bom = uAES_TRACE_BOM;
+    hdr.rec_size = sizeof(uaes_trace_rec_t);
+    hdr.nsites = __atomic_load_n(&nsites, __ATOMIC_RELAXED);
+    hdr.nsites = ( uAES_TRACE_SITES < hdr.nsites ) ? ( uAES_TRACE_SITES ) : ( hdr.nsites );
+    hdr.nrings = __atomic_load_n(&nrings, __ATOMIC_RELAXED);
+    hdr.lost = __atomic_load_n(&lost, __ATOMIC_RELAXED);
+    err = ( 1UL == fwrite(&hdr, sizeof(hdr), 1UL, fp) ) ? ( 0 ) : ( -1 );
+    for(uint32_t site = 0U; ( 0 == err ) && ( site < hdr.nsites ); site++)
+    {
+      /* A site still being registered is written empty. */
+      const char *fmt = __atomic_load_n(&sites[site].fmt, __ATOMIC_ACQUIRE);
+      uint16_t len = ( NULL != fmt ) ? ( ( uint16_t )( strlen(fmt) ) ) : ( 0U );
+      uint8_t kind = sites[site].kind;
+
+      if(( 1UL != fwrite(&kind, sizeof(kind), 1UL, fp) ) || ( 1UL != fwrite(&len, sizeof(len), 1UL, fp) ) ||
+         ( ( 0U != len ) && ( 1UL != fwrite(fmt, len, 1UL, fp) ) ))
+      {
+        err = -1;
+      }
+    }
+    for(uint32_t idx = 0U; ( 0 == err ) && ( idx < hdr.nrings ); idx++)
+    {
+      udbg_ring_t *ring = &rings[idx];
+      uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+      /* The oldest slot of a full ring is the next one written, it is left out. */
+      ring_hdr.nrec = ( ( uAES_TRACE_RING_SIZE - 1UL ) < head ) ? ( uAES_TRACE_RING_SIZE - 1UL ) : ( head );
+      ring_hdr.overwritten = head - ring_hdr.nrec;
+      err = ( 1UL == fwrite(&ring_hdr, sizeof(ring_hdr), 1UL, fp) ) ? ( 0 ) : ( -1 );
+      for(uint32_t pos = head - ring_hdr.nrec; ( 0 == err ) && ( pos != head ); pos++)
+      {
+        memcpy((void *)&rec, (void *)&ring->rec[pos & ( uAES_TRACE_RING_SIZE - 1UL )], sizeof(rec));
+        /* The writer may have reached this slot again while it was copied. */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(uAES_TRACE_RING_SIZE <= ( __atomic_load_n(&ring->head, __ATOMIC_RELAXED) - pos ))
+        {
+          rec.site = 0U;
+        }
+        err = ( 1UL == fwrite(&rec, sizeof(rec), 1UL, fp) ) ? ( 0 ) : ( -1 );
+      }
+    }
+    err = ( 0 == fclose(fp) ) ? ( err ) : ( -1 );
+  }
+
+  return err;
+}
+
+#if (0 != uAES_TRACE_SAVE_AT_EXIT)
+/**
+ * @brief Saves the rings to uAES_TRACE_FILE at exit.
+ */
+static void udbg_save_at_exit(void)
+{
+  if(0 != udbg_save(uAES_TRACE_FILE))
+  {
+    fprintf(stderr, "trace: could not save %s\n", uAES_TRACE_FILE);
+  }
+  return;
+}
+
+__attribute__((constructor)) static void udbg_init(void)
+{
+  atexit(udbg_save_at_exit);
+  return;
+}
+#endif /*uAES_TRACE_SAVE_AT_EXIT*/
+
+#endif /*__uAES_DEBUG__ && __uAES_TRACE_RING__*/
@@ -41,6 +41,8 @@
  * b1 - Traces inverse cipher algorithm.
  * b0 - Traces foward cipher algorithm.
  * 
+ * Trace points are printed as they are reached, or recorded into per-thread rings when
+ * __uAES_TRACE_RING__ is also defined. Either way trace_msk selects the trace points kept.
  */
 
 extern uint8_t trace_msk;
@@ -54,7 +56,104 @@ extern int debug_line;
 #define uAES_TRACE_MSK_MEM    0x20
 #define uAES_TRACE_MSK_EVERY  0x3F
 
+/**
+ * @brief Binary trace records of the ring-buffer backend, selected with __uAES_TRACE_RING__ in
+ *        debug builds. Every trace point that passes trace_msk is stored as one fixed-size
+ *        record in a ring of the calling thread instead of being printed, the rings are saved
+ *        to a file with uaes_trace_save() and rendered offline in the text format above by
+ *        uaes_tests/tdecode.c. Formats are kept once per trace point in a site table, records
+ *        only hold their site number.
+ */
+#define uAES_TRACE_SITE_MSG   0x00  // uAES_TRACE(), data holds up to uAES_TRACE_MAX_ARGS arguments.
+#define uAES_TRACE_SITE_BLOCK 0x01  // uAES_TRACE_BLOCK(), data holds the state.
+#define uAES_TRACE_MAX_ARGS   2
+
+typedef struct uaes_trace_rec
+{
+  uint64_t      ts;                             // Clock ticks when the trace point was reached.
+  uint32_t      line;                           // Trace point count of the thread, dbg[line].
+  uint16_t      site;                           // Trace point, 0 if the site table was full.
+  uint8_t       msk;                            // Trace mask bit of the trace point.
+  uint8_t       round;                          // Round number of a block.
+  union
+  {
+    uint8_t     state[16];                      // Block or cipher state.
+    uint64_t    args[uAES_TRACE_MAX_ARGS];      // Message arguments.
+  }data;
+}uaes_trace_rec_t;
+
+/**
+ * @brief Trace file layout, in host byte order: a uaes_trace_hdr_t, nsites sites of one kind
+ *        byte, a 16-bit length and the format without its terminator, then nrings rings of a
+ *        uaes_trace_ring_hdr_t followed by nrec records, oldest first.
+ */
+#define uAES_TRACE_MAGIC      "uAESTRC"
+#define uAES_TRACE_BOM        0x01020304UL
+
+typedef struct uaes_trace_hdr
+{
+  char          magic[8];                       // uAES_TRACE_MAGIC.
+  uint32_t      bom;                            // uAES_TRACE_BOM, detects a byte order mismatch.
+  uint32_t      rec_size;                       // sizeof(uaes_trace_rec_t).
+  uint32_t      nsites;                         // Registered trace points.
+  uint32_t      nrings;                         // Threads that traced.
+  uint64_t      lost;                           // Records of threads left without a ring.
+}uaes_trace_hdr_t;
+
+typedef struct uaes_trace_ring_hdr
+{
+  uint32_t      nrec;                           // Records that follow.
+  uint32_t      overwritten;                    // Older records overwritten before the save.
+}uaes_trace_ring_hdr_t;
+
 #ifdef __uAES_DEBUG__
+#ifdef __uAES_TRACE_RING__
+extern _Thread_local uint32_t udbg_line;
+extern uint16_t udbg_site(const char *fmt, uint8_t kind);
+extern void udbg_msg(uint8_t msk, uint16_t site, uint32_t line, size_t nargs, const uint64_t *args);
+extern void udbg_block(uint8_t msk, uint16_t site, uint32_t line, const uint8_t *block, size_t round);
+extern int  udbg_save(const char *path);
+extern void udbg_reset(void);
+
+/**
+ * @brief Counts the arguments following a format, up to uAES_TRACE_MAX_ARGS.
+ */
+#define uAES_TRACE_NARGS(...)         uAES_TRACE_NARGS_(0, ##__VA_ARGS__, 2, 1, 0)
+#define uAES_TRACE_NARGS_(_0, _1, _2, n, ...) n
+
+/**
+ * @brief Site number of the enclosing trace point, registered the first time it is recorded.
+ */
+#define uAES_TRACE_SITE_ID(fmt, kind) __extension__ ({                \
+  static uint16_t udbg_id = 0U;                                       \
+  uint16_t udbg_site_id = __atomic_load_n(&udbg_id, __ATOMIC_RELAXED);\
+  if(0U == udbg_site_id)                                              \
+  {                                                                   \
+    udbg_site_id = udbg_site(fmt, kind);                              \
+    __atomic_store_n(&udbg_id, udbg_site_id, __ATOMIC_RELAXED);       \
+  }                                                                   \
+  udbg_site_id;                                                       \
+})
+
+#define uAES_TRACE( msk, fmt, ... )do {                                 \
+  const uint32_t udbg_at = udbg_line++;                                 \
+  if( trace_msk & msk )                                                 \
+  {                                                                     \
+    const uint64_t udbg_args[] = { 0U, ##__VA_ARGS__ };                 \
+    udbg_msg(msk, uAES_TRACE_SITE_ID(fmt, uAES_TRACE_SITE_MSG), udbg_at,\
+             uAES_TRACE_NARGS(__VA_ARGS__), &udbg_args[1]);             \
+  }                                                                     \
+} while(0)
+#define uAES_TRACE_BLOCK( msk, fmt, block, ... ) do {                   \
+  const uint32_t udbg_at = udbg_line++;                                 \
+  if( trace_msk & msk )                                                 \
+  {                                                                     \
+    const uint64_t udbg_args[] = { 0U, ##__VA_ARGS__ };                 \
+    udbg_block(msk, uAES_TRACE_SITE_ID(fmt, uAES_TRACE_SITE_BLOCK),     \
+               udbg_at, block, udbg_args[uAES_TRACE_NARGS(__VA_ARGS__)]);\
+  }                                                                     \
+} while(0)
+#else
 #define uAES_TRACE( msk, fmt, ... )do {                         \
   if( trace_msk & msk )                                         \
     printf("dbg[%d]:" fmt "\n", debug_line, ##__VA_ARGS__ );  \
@@ -70,6 +169,7 @@ extern int debug_line;
   debug_line++;                                                 \
   printf("\n");                                                 \
 }while (0)                                                                    
+#endif /*__uAES_TRACE_RING__*/
 #else
 #define uAES_TRACE( msk, fmt, ... )do {} while (0)
 #define uAES_TRACE_BLOCK( msk, fmt, block, ... )do {} while(0)
@@ -0,0 +1,381 @@
+/**
+ * @file      ufile.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Memory-mapped file encryption. ECB and CBC read the input straight from its mapping
+ *            and write the result straight into the mapping of the output file.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "uaes.h"
+#include "ufile.h"
+
+#ifdef __uAES_FILE__
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define uFILE_CTR_SIZE        ( 8UL )
+#define uFILE_GCM_IV_SIZE     ( 12UL )
+#define uFILE_TAG_SIZE        ( 16UL )
+
+/**
+ * @brief Mode state carried from one batch to the next.
+ */
+typedef struct ufile_job
+{
+  uaes_ctx_t      *ctx;
+  ufile_mode_t    mode;
+  int             decrypt;
+  uaes_stream_t   stream;
+  uaes_gcm_t      gcm;
+  uint8_t         ctr[uAES_BLOCK_SIZE];
+}ufile_job_t;
+
+static int    ufile_start(ufile_job_t *job, uint8_t *iv);
+static int    ufile_batch(ufile_job_t *job, uint8_t *src, uint8_t *dst, size_t size);
+static int    ufile_finish(ufile_job_t *job, uint8_t *tail, uint8_t *tag);
+static void   ufile_advise(void *addr, size_t size);
+static void   ufile_release(int src_fd, uint8_t *src, uint8_t *dst, size_t off, size_t size);
+static int    ufile_run(uaes_ctx_t *ctx, ufile_mode_t mode, uint8_t *iv, const char *src_path, const char *dst_path, int decrypt);
+
+/**
+ * @brief Starts the mode on a job.
+ * @param job   Pointer to job.
+ * @param iv    Initialisation vector, counter block or GCM IV.
+ * @return int  [0] if sucessful, [-1] on failure.
+ */
+static int ufile_start(ufile_job_t *job, uint8_t *iv)
+{
+  int err = -1;
+
+  switch(job->mode)
+  {
+    case uFILE_ECB:
+      err = (0 != job->decrypt) ? (uaes_ecb_decrypt_init(&job->stream, job->ctx)) : (uaes_ecb_encrypt_init(&job->stream, job->ctx));
+      break;
+    case uFILE_CBC:
+      err = (0 != job->decrypt) ? (uaes_cbc_decrypt_init(&job->stream, job->ctx, iv)) : (uaes_cbc_encrypt_init(&job->stream, job->ctx, iv));
+      break;
+    case uFILE_CTR:
+      memcpy((void *)job->ctr, (void *)iv, uAES_BLOCK_SIZE);
+      err = 0;
+      break;
+    case uFILE_GCM:
+      err = uaes_gcm_init(&job->gcm, job->ctx);
+      if(0 == err)
+      {
+        err = uaes_gcm_start(&job->gcm, iv, uFILE_GCM_IV_SIZE);
+      }
+      break;
+    default:
+      break;
+  }
+  return err;
+}
+
+/**
+ * @brief Runs the mode on a batch. ECB and CBC go from the input mapping straight to the output
+ *        mapping, CTR and GCM have no out-of-place functions and run in place on a copy of the
+ *        batch made in the output mapping. Every batch but the last is a multiple of 16 bytes,
+ *        the bytes of a last partial ECB/CBC block are kept by the stream until ufile_finish().
+ * @param job   Pointer to job.
+ * @param src   Pointer to batch in the input mapping.
+ * @param dst   Pointer to batch in the output mapping.
+ * @param size  Batch size.
+ * @return int  [0] if sucessful, [-1] on failure.
+ */
+static int ufile_batch(ufile_job_t *job, uint8_t *src, uint8_t *dst, size_t size)
+{
+  int err = -1;
+  size_t written = 0UL;
+
+  switch(job->mode)
+  {
+    case uFILE_ECB:
+    case uFILE_CBC:
+      err = uaes_stream_update(&job->stream, src, size, dst, &written);
+      break;
+    case uFILE_CTR:
+      memcpy((void *)dst, (void *)src, size);
+      err = uaes_ctx_ctr_xcrypt(job->ctx, dst, size, job->ctr, uFILE_CTR_SIZE);
+      break;
+    case uFILE_GCM:
+      memcpy((void *)dst, (void *)src, size);
+      err = (0 != job->decrypt) ? (uaes_gcm_decrypt_update(&job->gcm, dst, size)) : (uaes_gcm_encrypt_update(&job->gcm, dst, size));
+      break;
+    default:
+      break;
+  }
+  return err;
+}
+
+/**
+ * @brief Completes the mode, writing the zero padded ECB/CBC block or checking/writing the GCM tag.
+ * @param job   Pointer to job.
+ * @param tail  Output position of the last partial block.
+ * @param tag   Output position of the GCM tag when encrypting, input position when decrypting.
+ * @return int  [0] if sucessful, [-1] on failure or GCM tag mismatch.
+ */
+static int ufile_finish(ufile_job_t *job, uint8_t *tail, uint8_t *tag)
+{
+  int err = 0;
+  size_t written = 0UL;
+
+  switch(job->mode)
+  {
+    case uFILE_ECB:
+    case uFILE_CBC:
+      err = uaes_stream_final(&job->stream, tail, &written);
+      break;
+    case uFILE_GCM:
+      err = (0 != job->decrypt) ? (uaes_gcm_verify(&job->gcm, tag, uFILE_TAG_SIZE)) : (uaes_gcm_finish(&job->gcm, tag, uFILE_TAG_SIZE));
+      uaes_gcm_wipe(&job->gcm);
+      break;
+    default:
+      break;
+  }
+  return err;
+}
+
+/**
+ * @brief Tells the kernel a mapping is read once front to back, and backs it with huge pages
+ *        where the kernel supports it for file mappings. Failures are ignored, both are hints.
+ * @param addr  Mapping start.
+ * @param size  Mapping size.
+ */
+static void ufile_advise(void *addr, size_t size)
+{
+#ifdef MADV_SEQUENTIAL
+  (void)madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_HUGEPAGE
+  (void)madvise(addr, size, MADV_HUGEPAGE);
+#endif
+  return;
+}
+
+/**
+ * @brief Drops processed input pages from the mapping and the page cache, and starts writeback
+ *        of processed output pages, so that the page cache does not fill up with either.
+ * @param src_fd  Input file descriptor.
+ * @param src     Input mapping, NULL if the input is empty.
+ * @param dst     Output mapping.
+ * @param off     Offset of processed range.
+ * @param size    Size of processed range.
+ */
+static void ufile_release(int src_fd, uint8_t *src, uint8_t *dst, size_t off, size_t size)
+{
+  if(NULL != src)
+  {
+    (void)madvise(&src[off], size, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+    (void)posix_fadvise(src_fd, (off_t)off, (off_t)size, POSIX_FADV_DONTNEED);
+#endif
+  }
+  (void)msync(&dst[off], size, MS_ASYNC);
+  return;
+}
+
+/**
+ * @brief Encrypts or decrypts a file into another through memory mappings.
+ * @param ctx       Pointer to cipher context.
+ * @param mode      File mode.
+ * @param iv        Initialisation vector, counter block or GCM IV, unused by ECB.
+ * @param src_path  Input file path.
+ * @param dst_path  Output file path, created or truncated.
+ * @param decrypt   [0] to encrypt, [1] to decrypt.
+ * @return int      [0] if sucessful, [-1] on failure.
+ */
+static int ufile_run(uaes_ctx_t *ctx, ufile_mode_t mode, uint8_t *iv, const char *src_path, const char *dst_path, int decrypt)
+{
+  int err = -1;
+  int src_fd = -1, dst_fd = -1;
+  uint8_t *src = NULL, *dst = NULL;
+  uint8_t pad[uAES_BLOCK_SIZE];
+  size_t in_size = 0UL, body = 0UL, out_size = 0UL;
+  size_t off = 0UL, len = 0UL;
+  struct stat st;
+  ufile_job_t job;
+
+  memset((void *)&job, 0, sizeof(job));
+  job.ctx = ctx;
+  job.mode = mode;
+  job.decrypt = decrypt;
+
+  src_fd = open(src_path, O_RDONLY);
+  if((0 > src_fd) || (0 != fstat(src_fd, &st)))
+  {
+    goto out;
+  }
+  in_size = (size_t)st.st_size;
+  body = ((uFILE_GCM == mode) && (0 != decrypt)) ? (in_size - uFILE_TAG_SIZE) : (in_size);
+
+  switch(mode)
+  {
+    case uFILE_ECB:
+    case uFILE_CBC:
+      out_size = uAES_ALIGN(in_size, uAES_BLOCK_ALIGN);
+      if((0 != decrypt) && (in_size != out_size))
+      {
+        goto out;
+      }
+      break;
+    case uFILE_CTR:
+      out_size = in_size;
+      break;
+    case uFILE_GCM:
+      if((0 != decrypt) && (uFILE_TAG_SIZE > in_size))
+      {
+        goto out;
+      }
+      out_size = (0 != decrypt) ? (body) : (in_size + uFILE_TAG_SIZE);
+      break;
+    default:
+      goto out;
+  }
+
+  if(0 != ufile_start(&job, iv))
+  {
+    goto out;
+  }
+
+  dst_fd = open(dst_path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if((0 > dst_fd) || (0 != ftruncate(dst_fd, (off_t)out_size)))
+  {
+    goto out;
+  }
+
+  if(0UL < in_size)
+  {
+    src = mmap(NULL, in_size, PROT_READ, MAP_PRIVATE, src_fd, 0);
+    if(MAP_FAILED == src)
+    {
+      src = NULL;
+      goto out;
+    }
+    ufile_advise(src, in_size);
+  }
+  if(0UL < out_size)
+  {
+    dst = mmap(NULL, out_size, PROT_READ | PROT_WRITE, MAP_SHARED, dst_fd, 0);
+    if(MAP_FAILED == dst)
+    {
+      dst = NULL;
+      goto out;
+    }
+    ufile_advise(dst, out_size);
+  }
+
+  for(off = 0UL; off < body; off += len)
+  {
+    len = ((body - off) < uFILE_BATCH_SIZE) ? (body - off) : (uFILE_BATCH_SIZE);
+    if(0 != ufile_batch(&job, &src[off], &dst[off], len))
+    {
+      goto out;
+    }
+    if(0UL == ((off + len) % uFILE_CHUNK_SIZE))
+    {
+      ufile_release(src_fd, src, dst, off + len - uFILE_CHUNK_SIZE, uFILE_CHUNK_SIZE);
+    }
+  }
+
+  /* an empty input leaves no output to pad into */
+  err = ufile_finish(&job, (NULL != dst) ? (&dst[body & ~(uAES_BLOCK_SIZE - 1UL)]) : (pad), (0 != decrypt) ? (&src[body]) : (&dst[body]));
+
+out:
+  if(NULL != dst)
+  {
+    (void)munmap(dst, out_size);
+  }
+  if(NULL != src)
+  {
+    (void)munmap(src, in_size);
+  }
+  if(0 <= dst_fd)
+  {
+    if(0 != err)
+    {
+      (void)ftruncate(dst_fd, 0);
+      (void)unlink(dst_path);
+    }
+    (void)close(dst_fd);
+  }
+  if(0 <= src_fd)
+  {
+    (void)close(src_fd);
+  }
+  uaes_gcm_wipe(&job.gcm);
+  memset((void *)&job.stream, 0, sizeof(job.stream));
+  return err;
+}
+
+/**
+ * @brief Encrypts a file into another. The output is mapped and written directly, no copy of
+ *        the file is kept in user memory.
+ * @param ctx       Pointer to cipher context.
+ * @param mode      uFILE_ECB, uFILE_CBC, uFILE_CTR or uFILE_GCM.
+ * @param iv        16-Byte IV (CBC) or counter block (CTR), 12-byte IV (GCM), NULL for ECB.
+ * @param src_path  Plaintext file path.
+ * @param dst_path  Ciphertext file path, created or truncated.
+ * @return int      [0] if sucessful, [-1] on failure, the output file is removed.
+ */
+int ufile_encrypt(uaes_ctx_t *ctx, ufile_mode_t mode, uint8_t *iv, const char *src_path, const char *dst_path)
+{
+  int err = -1;
+
+  if((NULL != ctx) && (NULL != src_path) && (NULL != dst_path) && (uFILE_RGE > mode) && ((NULL != iv) || (uFILE_ECB == mode)))
+  {
+    err = ufile_run(ctx, mode, iv, src_path, dst_path, 0);
+  }
+  return err;
+}
+
+/**
+ * @brief Decrypts a file into another. With GCM the tag is checked at the end of the file and
+ *        the output is removed if it does not match.
+ * @param ctx       Pointer to cipher context.
+ * @param mode      uFILE_ECB, uFILE_CBC, uFILE_CTR or uFILE_GCM.
+ * @param iv        16-Byte IV (CBC) or counter block (CTR), 12-byte IV (GCM), NULL for ECB.
+ * @param src_path  Ciphertext file path.
+ * @param dst_path  Plaintext file path, created or truncated.
+ * @return int      [0] if sucessful, [-1] on failure, the output file is removed.
+ */
+int ufile_decrypt(uaes_ctx_t *ctx, ufile_mode_t mode, uint8_t *iv, const char *src_path, const char *dst_path)
+{
+  int err = -1;
+
+  if((NULL != ctx) && (NULL != src_path) && (NULL != dst_path) && (uFILE_RGE > mode) && ((NULL != iv) || (uFILE_ECB == mode)))
+  {
+    err = ufile_run(ctx, mode, iv, src_path, dst_path, 1);
+  }
+  return err;
+}
+
+#endif /*__uAES_FILE__*/
@@ -0,0 +1,74 @@
+/**
+ * @file      ufile.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     References for memory-mapped file encryption.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *  
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#ifndef UFILE_H
+#define UFILE_H
+
+#include "uaes.h"
+
+/**
+ * NOTE: File encryption is only built on POSIX hosts, it is left out of micro-controller builds.
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define __uAES_FILE__
+#endif
+
+#ifdef __uAES_FILE__
+
+/**
+ * @brief Input and output are mapped whole and processed uFILE_BATCH_SIZE bytes at a time,
+ *        ECB and CBC straight from one mapping into the other, CTR and GCM in place on a copy in
+ *        the output mapping while it is still in cache. Every uFILE_CHUNK_SIZE bytes the pages
+ *        already processed are released. uFILE_CHUNK_SIZE must be a multiple of
+ *        uFILE_BATCH_SIZE and of the page size, uFILE_BATCH_SIZE a multiple of 16.
+ */
+#ifndef uFILE_CHUNK_SIZE
+#define uFILE_CHUNK_SIZE      (64UL*MB)
+#endif
+#ifndef uFILE_BATCH_SIZE
+#define uFILE_BATCH_SIZE      (64UL*KB)
+#endif
+
+/**
+ * @brief File modes. ECB/CBC zero pad the last block. CTR takes a 16-byte counter block with a
+ *        64-bit big-endian counter in its last 8 bytes. GCM takes a 12-byte IV and appends the
+ *        16-byte tag to the encrypted file.
+ */
+typedef enum ufile_mode
+{
+  uFILE_ECB = 0,
+  uFILE_CBC = 1,
+  uFILE_CTR = 2,
+  uFILE_GCM = 3,
+  uFILE_RGE = 4
+}ufile_mode_t;
+
+extern int ufile_encrypt(uaes_ctx_t *ctx, ufile_mode_t mode, uint8_t *iv, const char *src_path, const char *dst_path);
+extern int ufile_decrypt(uaes_ctx_t *ctx, ufile_mode_t mode, uint8_t *iv, const char *src_path, const char *dst_path);
+
+#endif /*__uAES_FILE__*/
+
+#endif /*UFILE_H*/
@@ -0,0 +1,182 @@
+/**
+ * @file      uprof.c
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Per-thread profiling counters of uAES.
+ * @version   0.0
+ * @date      2026-10-16
+ * @note      tab = 2 spaces!
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "uaes.h"
+
+#ifdef __uAES_PROFILE__
+
+#define uAES_PROF_CALIBRATION   ( 4096UL )
+
+/**
+ * @brief Counter slots, a thread takes the next free one on its first sample and keeps it
+ *        after it exits so that its counters can still be dumped. Threads past the last slot
+ *        share it and may lose counts.
+ */
+static uaes_prof_t  slots[uAES_PROF_MAX_THREADS];
+static size_t       nslots = 0UL;
+
+static const char *const phase_name[uAES_PROF_RGE] =
+{
+  "key expansion", "SubBytes", "ShiftRows", "MixColumns", "AddRoundKey", "mode overhead", "arguments"
+};
+
+_Thread_local uaes_prof_t *uprof_self = NULL;
+uint64_t uprof_overhead = 0U;
+
+static void uprof_print(const char *name, const uaes_prof_t *prof);
+
+/**
+ * @brief   Hands the calling thread its counter slot.
+ * @return  uaes_prof_t* Counter slot.
+ */
+uaes_prof_t *uprof_claim(void)
+{
+  size_t slot = __atomic_fetch_add(&nslots, 1UL, __ATOMIC_RELAXED);
+
+  if(uAES_PROF_MAX_THREADS <= slot)
+  {
+    slot = uAES_PROF_MAX_THREADS - 1UL;
+  }
+  uprof_self = &slots[slot];
+  return uprof_self;
+}
+
+/**
+ * @brief Copies the counters of the calling thread.
+ * @param prof  Pointer to counters.
+ */
+void uprof_read(uaes_prof_t *prof)
+{
+  if(NULL == uprof_self)
+  {
+    memset((void *)prof, 0, sizeof(uaes_prof_t));
+  }
+  else
+  {
+    memcpy((void *)prof, (void *)uprof_self, sizeof(uaes_prof_t));
+  }
+  return;
+}
+
+/**
+ * @brief Clears the counters of the calling thread.
+ */
+void uprof_reset(void)
+{
+  if(NULL != uprof_self)
+  {
+    memset((void *)uprof_self, 0, sizeof(uaes_prof_t));
+  }
+  return;
+}
+
+/**
+ * @brief       Prints one set of counters, with the share of the profiled time of every phase.
+ * @param name  Counter set name.
+ * @param prof  Pointer to counters.
+ */
+static void uprof_print(const char *name, const uaes_prof_t *prof)
+{
+  uint64_t total = 0U;
+  size_t phase = 0UL;
+
+  for(phase = 0UL; phase < uAES_PROF_RGE; phase++)
+  {
+    total += prof->cycles[phase];
+  }
+  fprintf(stderr, "prof[%s]: %16s %14s %16s %10s %7s\n", name, "phase", "calls", "cycles", "cyc/call", "share");
+  for(phase = 0UL; phase < uAES_PROF_RGE; phase++)
+  {
+    if(0U != prof->calls[phase])
+    {
+      fprintf(stderr, "prof[%s]: %16s %14llu %16llu %10.1f %6.1f%%\n", name, phase_name[phase],
+              ( unsigned long long )( prof->calls[phase] ), ( unsigned long long )( prof->cycles[phase] ),
+              ( double )( prof->cycles[phase] ) / ( double )( prof->calls[phase] ),
+              ( 0U != total ) ? ( 100.0 * ( double )( prof->cycles[phase] ) / ( double )( total ) ) : ( 0.0 ));
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Prints the counters of every thread that took a sample, and their sum, to stderr.
+ */
+void uprof_dump(void)
+{
+  uaes_prof_t sum;
+  char name[16];
+  size_t used = __atomic_load_n(&nslots, __ATOMIC_RELAXED);
+  size_t slot = 0UL, phase = 0UL;
+
+  used = ( uAES_PROF_MAX_THREADS < used ) ? ( uAES_PROF_MAX_THREADS ) : ( used );
+  memset((void *)&sum, 0, sizeof(sum));
+  fprintf(stderr, "prof: %llu ticks of clock overhead subtracted from every sample\n", ( unsigned long long )( uprof_overhead ));
+  for(slot = 0UL; slot < used; slot++)
+  {
+    snprintf(name, sizeof(name), "thread %lu", ( unsigned long )( slot ));
+    uprof_print(name, &slots[slot]);
+    for(phase = 0UL; phase < uAES_PROF_RGE; phase++)
+    {
+      sum.cycles[phase] += slots[slot].cycles[phase];
+      sum.calls[phase] += slots[slot].calls[phase];
+    }
+  }
+  if(1UL < used)
+  {
+    uprof_print("total", &sum);
+  }
+  return;
+}
+
+/**
+ * @brief Measures the cost of reading the clock twice, the smallest of many readings is taken
+ *        as the overhead included in every sample. Registers the dump at exit when
+ *        uAES_PROF_DUMP_AT_EXIT is set.
+ */
+__attribute__((constructor)) static void uprof_init(void)
+{
+  uint64_t best = UINT64_MAX, t0 = 0U, t1 = 0U;
+
+  for(size_t idx = 0UL; idx < uAES_PROF_CALIBRATION; idx++)
+  {
+    t0 = uprof_clock();
+    t1 = uprof_clock();
+    best = ( ( t1 - t0 ) < best ) ? ( t1 - t0 ) : ( best );
+  }
+  uprof_overhead = best;
+#if (0 != uAES_PROF_DUMP_AT_EXIT)
+  atexit(uprof_dump);
+#endif /*uAES_PROF_DUMP_AT_EXIT*/
+  return;
+}
+
+#endif /*__uAES_PROFILE__*/
@@ -0,0 +1,145 @@
+/**
+ * @file      uprof.h
+ * @author    Antonio V. G. Bassi (antoniovitor.gb@gmail.com)
+ * @brief     Per-phase cycle profiling hooks for uAES
+ * @version   0.0
+ * @date      2026-10-16 YYYY-MM-DD
+ * @note      tab = 2 spaces!
+ *
+ *
+ *  Copyright (C) 2022, Antonio Vitor Grossi Bassi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef UPROF_H
+#define UPROF_H
+
+/**
+ * @brief Profiled phases. The round phases are only timed on the portable engine of ops.c,
+ *        which computes them one after the other in profiling builds.
+ */
+typedef enum uaes_prof_phase
+{
+  uAES_PROF_KEXP  = 0,  // Key expansion and inverse key schedule, every engine.
+  uAES_PROF_SUB   = 1,  // SubBytes.
+  uAES_PROF_SHIFT = 2,  // ShiftRows.
+  uAES_PROF_MIX   = 3,  // MixColumns.
+  uAES_PROF_ADD   = 4,  // AddRoundKey.
+  uAES_PROF_MODE  = 5,  // Mode overhead, IV and keystream XOR, counter and chaining copies.
+  uAES_PROF_ARGS  = 6,  // Argument validation of the cipher, mode and MAC functions.
+  uAES_PROF_RGE   = 7   // Range of phases.
+}uaes_prof_phase_t;
+
+/**
+ * @brief Profiling counters of one thread.
+ */
+typedef struct uaes_prof
+{
+  uint64_t      cycles[uAES_PROF_RGE];          // Clock ticks spent in every phase.
+  uint64_t      calls[uAES_PROF_RGE];           // Times every phase was entered.
+}uaes_prof_t;
+
+#ifdef __uAES_PROFILE__
+
+#if !defined(uAES_PROF_CLOCK) && ( defined(__x86_64__) || defined(__i386__) )
+#include <x86intrin.h>
+#elif !defined(uAES_PROF_CLOCK) && !defined(__aarch64__)
+#include <time.h>
+#endif
+
+extern _Thread_local uaes_prof_t *uprof_self;
+extern uint64_t uprof_overhead;
+extern uaes_prof_t *uprof_claim(void);
+extern void uprof_read(uaes_prof_t *prof);
+extern void uprof_reset(void);
+extern void uprof_dump(void);
+
+/**
+ * @brief           Reads the profiling clock. x86 reads the time-stamp counter once every
+ *                  earlier instruction has completed, AArch64 the virtual counter, other
+ *                  targets a monotonic clock in nanoseconds. Defining uAES_PROF_CLOCK() selects
+ *                  another clock, e.g. a cycle counter register on microcontrollers.
+ * @return uint64_t Clock ticks.
+ */
+static inline uint64_t uprof_clock(void)
+{
+#if defined(uAES_PROF_CLOCK)
+  return ( uint64_t )( uAES_PROF_CLOCK() );
+#elif defined(__x86_64__) || defined(__i386__)
+  _mm_lfence();
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) : : "memory");
+  return ticks;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ( ( uint64_t )( ts.tv_sec ) * 1000000000ULL ) + ( uint64_t )( ts.tv_nsec );
+#endif
+}
+
+/**
+ * @brief       Charges a sample to a phase of the calling thread, less the cost of reading
+ *              the clock.
+ * @param phase Profiled phase.
+ * @param ticks Clock ticks measured around the phase.
+ */
+static inline void uprof_add(uaes_prof_phase_t phase, uint64_t ticks)
+{
+  uaes_prof_t *prof = uprof_self;
+
+  if(NULL == prof)
+  {
+    prof = uprof_claim();
+  }
+  prof->cycles[phase] += ( ticks > uprof_overhead ) ? ( ticks - uprof_overhead ) : ( 0U );
+  prof->calls[phase]++;
+  return;
+}
+
+/**
+ * @brief Starts timing in t. A lap charges the ticks since t to a phase and restarts t after
+ *        the bookkeeping, so back to back laps time consecutive phases.
+ */
+#define uAES_PROF_START(t)          uint64_t t = uprof_clock()
+#define uAES_PROF_LAP(t, phase)     do {                        \
+  uprof_add(( phase ), uprof_clock() - ( t ));                  \
+  ( t ) = uprof_clock();                                        \
+} while(0)
+
+/**
+ * @brief Keeps the compiler from moving the computation of x past this point.
+ */
+#define uAES_PROF_KEEP(x)           __asm__ volatile("" : "+r"(x))
+
+/**
+ * @brief Evaluates an argument check and charges it to uAES_PROF_ARGS.
+ */
+#define uAES_PROF_CHECK(cond)       __extension__ ({            \
+  uAES_PROF_START(uprof_t0);                                    \
+  const int uprof_ok = ( cond ) ? ( 1 ) : ( 0 );                \
+  uAES_PROF_LAP(uprof_t0, uAES_PROF_ARGS);                      \
+  uprof_ok;                                                     \
+})
+#else
+#define uAES_PROF_START(t)          do {} while(0)
+#define uAES_PROF_LAP(t, phase)     do {} while(0)
+#define uAES_PROF_KEEP(x)           do {} while(0)
+#define uAES_PROF_CHECK(cond)       ( cond )
+#endif /*__uAES_PROFILE__*/
+
+#endif /*UPROF_H*/